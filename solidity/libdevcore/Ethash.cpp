@@ -0,0 +1,668 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Ethash.cpp
+ * Light client verification of the Ethash proof of work, following the specification at
+ * https://github.com/ethereum/wiki/wiki/Ethash
+ */
+
+#include <libdevcore/Ethash.h>
+
+#include <libdevcore/Assertions.h>
+#include <libdevcore/CommonData.h>
+#include <libdevcore/Keccak256.h>
+#include <libdevcore/ThreadPool.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+using namespace dev;
+using namespace dev::ethash;
+namespace fs = boost::filesystem;
+namespace ip = boost::interprocess;
+
+/// Compiles the interleaved kernels also for AVX2 and selects the variant when loading the program,
+/// where supported by the toolchain. Otherwise, the compiler vectorises them for the baseline instruction set.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define ETHASH_MULTIVERSIONED __attribute__((target_clones("avx2", "default")))
+#else
+#define ETHASH_MULTIVERSIONED
+#endif
+
+namespace
+{
+
+uint64_t const c_cacheBytesInit = uint64_t(1) << 24;
+uint64_t const c_cacheBytesGrowth = uint64_t(1) << 17;
+uint64_t const c_datasetBytesInit = uint64_t(1) << 30;
+uint64_t const c_datasetBytesGrowth = uint64_t(1) << 23;
+/// Size of a light cache node and of a dataset item.
+uint64_t const c_hashBytes = 64;
+/// Size of the mix, i.e. of the pages of the dataset accessed by hashimoto.
+uint64_t const c_mixBytes = 128;
+unsigned const c_hashWords = c_hashBytes / 4;
+unsigned const c_mixWords = c_mixBytes / 4;
+unsigned const c_mixHashes = c_mixBytes / c_hashBytes;
+unsigned const c_cacheRounds = 3;
+unsigned const c_datasetParents = 256;
+unsigned const c_accesses = 64;
+/// Written in little endian to the start of dataset files once they are complete.
+uint64_t const c_datasetMagic = 0xfee1deadbaddcafe;
+size_t const c_datasetMagicBytes = 8;
+/// Number of dataset items generated by a single task.
+uint64_t const c_datasetChunkItems = 1 << 12;
+
+bool isPrime(uint64_t _number)
+{
+	if (_number < 2)
+		return false;
+	for (uint64_t divisor = 2; divisor * divisor <= _number; ++divisor)
+		if (_number % divisor == 0)
+			return false;
+	return true;
+}
+
+inline uint32_t fnv(uint32_t _a, uint32_t _b)
+{
+	return (_a * 0x01000193) ^ _b;
+}
+
+/// @returns the @a _index th little endian 32 bit word of @a _hash.
+template <unsigned N>
+inline uint32_t word(FixedHash<N> const& _hash, size_t _index)
+{
+	uint8_t const* data = _hash.data() + 4 * _index;
+	return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+}
+
+template <unsigned N>
+inline void setWord(FixedHash<N>& _hash, size_t _index, uint32_t _value)
+{
+	uint8_t* data = _hash.data() + 4 * _index;
+	for (size_t i = 0; i < 4; ++i)
+		data[i] = uint8_t(_value >> (8 * i));
+}
+
+/// @returns the input of the Keccak-512 hash from which hashimoto starts.
+FixedHash<40> hashimotoSeedInput(h256 const& _headerHash, uint64_t _nonce)
+{
+	FixedHash<40> input;
+	memcpy(input.data(), _headerHash.data(), 32);
+	for (size_t i = 0; i < 8; ++i)
+		input[32 + i] = uint8_t(_nonce >> (8 * i));
+	return input;
+}
+
+h512 hashimotoSeed(h256 const& _headerHash, uint64_t _nonce)
+{
+	return keccak512(hashimotoSeedInput(_headerHash, _nonce).ref());
+}
+
+FixedHash<96> hashimotoFinalHashInput(h512 const& _seed, h256 const& _mixHash)
+{
+	FixedHash<96> input;
+	memcpy(input.data(), _seed.data(), 64);
+	memcpy(input.data() + 64, _mixHash.data(), 32);
+	return input;
+}
+
+h256 hashimotoFinalHash(h512 const& _seed, h256 const& _mixHash)
+{
+	return keccak256(hashimotoFinalHashInput(_seed, _mixHash).ref());
+}
+
+/// Replaces the first @a _count of @a _hashes by their Keccak-512 hashes, which are computed
+/// on several lanes at once if the processor supports it.
+void keccak512Lanes(array<h512, c_lanes>& _hashes, size_t _count)
+{
+	vector<bytesConstRef> inputs;
+	for (size_t l = 0; l < _count; ++l)
+		inputs.push_back(bytesConstRef(_hashes[l].data(), h512::size));
+	vector<h512> outputs = keccak512(inputs);
+	for (size_t l = 0; l < _count; ++l)
+		_hashes[l] = outputs[l];
+}
+
+/// Runs hashimoto on a dataset of @a _datasetSize bytes, whose items are returned by @a _item.
+template <class ItemLookup>
+Result computeHashimoto(h256 const& _headerHash, uint64_t _nonce, uint64_t _datasetSize, ItemLookup const& _item)
+{
+	h512 const seed = hashimotoSeed(_headerHash, _nonce);
+	uint32_t const seedHead = word(seed, 0);
+
+	array<uint32_t, c_mixWords> mix;
+	for (unsigned i = 0; i < c_mixWords; ++i)
+		mix[i] = word(seed, i % c_hashWords);
+
+	uint32_t const pages = uint32_t(_datasetSize / c_mixBytes);
+	for (unsigned i = 0; i < c_accesses; ++i)
+	{
+		uint32_t const page = fnv(i ^ seedHead, mix[i % c_mixWords]) % pages;
+		for (unsigned j = 0; j < c_mixHashes; ++j)
+		{
+			h512 const item = _item(page * c_mixHashes + j);
+			for (unsigned k = 0; k < c_hashWords; ++k)
+				mix[j * c_hashWords + k] = fnv(mix[j * c_hashWords + k], word(item, k));
+		}
+	}
+
+	Result result;
+	for (unsigned i = 0; i < c_mixWords; i += 4)
+		setWord(result.mixHash, i / 4, fnv(fnv(fnv(mix[i], mix[i + 1]), mix[i + 2]), mix[i + 3]));
+
+	result.finalHash = hashimotoFinalHash(seed, result.mixHash);
+	return result;
+}
+
+/// Runs hashimoto on the @a _count inputs at @a _inputs, with @a _count at most c_lanes, and stores
+/// the results in @a _results. The state of all lanes is kept in arrays indexed by lane last, such that
+/// the FNV updates of all lanes can be vectorised. @a _items looks up the items of all lanes at once.
+template <class ItemsLookup>
+void computeHashimotoLanes(
+	HashimotoInput const* _inputs,
+	size_t _count,
+	uint64_t _datasetSize,
+	ItemsLookup const& _items,
+	Result* _results
+)
+{
+	array<FixedHash<40>, c_lanes> seedInputs;
+	vector<bytesConstRef> seedRefs;
+	for (size_t l = 0; l < _count; ++l)
+	{
+		seedInputs[l] = hashimotoSeedInput(_inputs[l].first, _inputs[l].second);
+		seedRefs.push_back(bytesConstRef(seedInputs[l].data(), seedInputs[l].size));
+	}
+	vector<h512> const seedHashes = keccak512(seedRefs);
+	array<h512, c_lanes> seeds;
+	for (size_t l = 0; l < c_lanes; ++l)
+		seeds[l] = seedHashes[l < _count ? l : 0];
+
+	uint32_t mix[c_mixWords][c_lanes];
+	array<uint32_t, c_lanes> seedHeads;
+	for (size_t l = 0; l < c_lanes; ++l)
+	{
+		seedHeads[l] = word(seeds[l], 0);
+		for (unsigned k = 0; k < c_mixWords; ++k)
+			mix[k][l] = word(seeds[l], k % c_hashWords);
+	}
+
+	uint32_t const pages = uint32_t(_datasetSize / c_mixBytes);
+	array<uint32_t, c_lanes> indices;
+	array<h512, c_lanes> items;
+	for (unsigned i = 0; i < c_accesses; ++i)
+	{
+		array<uint32_t, c_lanes> pageIndices;
+		for (size_t l = 0; l < c_lanes; ++l)
+			pageIndices[l] = fnv(i ^ seedHeads[l], mix[i % c_mixWords][l]) % pages;
+		for (unsigned j = 0; j < c_mixHashes; ++j)
+		{
+			for (size_t l = 0; l < c_lanes; ++l)
+				indices[l] = pageIndices[l] * c_mixHashes + j;
+			_items(indices, _count, items);
+			// Unused lanes mix in stale items, which does not matter as their results are dropped.
+			for (unsigned k = 0; k < c_hashWords; ++k)
+				for (size_t l = 0; l < c_lanes; ++l)
+					mix[j * c_hashWords + k][l] = fnv(mix[j * c_hashWords + k][l], word(items[l], k));
+		}
+	}
+
+	array<FixedHash<96>, c_lanes> finalInputs;
+	vector<bytesConstRef> finalRefs;
+	for (size_t l = 0; l < _count; ++l)
+	{
+		Result& result = _results[l];
+		for (unsigned k = 0; k < c_mixWords; k += 4)
+			setWord(result.mixHash, k / 4, fnv(fnv(fnv(mix[k][l], mix[k + 1][l]), mix[k + 2][l]), mix[k + 3][l]));
+		finalInputs[l] = hashimotoFinalHashInput(seeds[l], result.mixHash);
+		finalRefs.push_back(bytesConstRef(finalInputs[l].data(), finalInputs[l].size));
+	}
+	vector<h256> const finalHashes = keccak256(finalRefs);
+	for (size_t l = 0; l < _count; ++l)
+		_results[l].finalHash = finalHashes[l];
+}
+
+/// Runs hashimoto on all @a _inputs in groups of c_lanes.
+template <class ItemsLookup>
+vector<Result> computeHashimotoBatch(vector<HashimotoInput> const& _inputs, uint64_t _datasetSize, ItemsLookup const& _items)
+{
+	vector<Result> results(_inputs.size());
+	for (size_t begin = 0; begin < _inputs.size(); begin += c_lanes)
+		computeHashimotoLanes(
+			_inputs.data() + begin,
+			min(c_lanes, _inputs.size() - begin),
+			_datasetSize,
+			_items,
+			results.data() + begin
+		);
+	return results;
+}
+
+/// @returns true if @a _file contains a complete dataset of @a _size bytes.
+bool isCompleteDataset(fs::path const& _file, uint64_t _size)
+{
+	boost::system::error_code error;
+	if (fs::file_size(_file, error) != c_datasetMagicBytes + _size || error)
+		return false;
+	ifstream file(_file.string(), ios::binary);
+	array<char, c_datasetMagicBytes> magic;
+	if (!file.read(magic.data(), magic.size()))
+		return false;
+	for (size_t i = 0; i < c_datasetMagicBytes; ++i)
+		if (uint8_t(magic[i]) != uint8_t(c_datasetMagic >> (8 * i)))
+			return false;
+	return true;
+}
+
+/// Generates the dataset of @a _cache in a temporary file using @a _threads threads
+/// and moves it to @a _file once it is complete.
+void generateDataset(LightCache const& _cache, fs::path const& _file, size_t _threads)
+{
+	if (_file.has_parent_path())
+		fs::create_directories(_file.parent_path());
+	fs::path temporary = _file;
+	temporary += fs::unique_path(".%%%%-%%%%-%%%%.tmp");
+	try
+	{
+		ofstream(temporary.string(), ios::binary | ios::trunc);
+		fs::resize_file(temporary, c_datasetMagicBytes + _cache.datasetSize());
+		{
+			ip::file_mapping mapping(temporary.string().c_str(), ip::read_write);
+			ip::mapped_region region(mapping, ip::read_write);
+			uint8_t* data = static_cast<uint8_t*>(region.get_address());
+
+			uint64_t const items = _cache.datasetSize() / c_hashBytes;
+			ThreadPool pool(_threads);
+			for (uint64_t begin = 0; begin < items; begin += c_datasetChunkItems)
+				pool.enqueue([&, begin]() {
+					uint64_t const end = min(begin + c_datasetChunkItems, items);
+					for (uint64_t i = begin; i < end; ++i)
+						memcpy(data + c_datasetMagicBytes + i * c_hashBytes, _cache.datasetItem(uint32_t(i)).data(), c_hashBytes);
+				});
+			pool.wait();
+
+			for (size_t i = 0; i < c_datasetMagicBytes; ++i)
+				data[i] = uint8_t(c_datasetMagic >> (8 * i));
+			region.flush();
+		}
+		// Renaming is atomic, so concurrent processes never map an incomplete file.
+		fs::rename(temporary, _file);
+	}
+	catch (...)
+	{
+		boost::system::error_code error;
+		fs::remove(temporary, error);
+		throw;
+	}
+}
+
+}
+
+h256 ethash::seedHash(uint64_t _epoch)
+{
+	h256 seed;
+	for (uint64_t i = 0; i < _epoch; ++i)
+		seed = keccak256(seed);
+	return seed;
+}
+
+uint64_t ethash::lightCacheSize(uint64_t _epoch)
+{
+	uint64_t size = c_cacheBytesInit + c_cacheBytesGrowth * _epoch - c_hashBytes;
+	while (!isPrime(size / c_hashBytes))
+		size -= 2 * c_hashBytes;
+	return size;
+}
+
+uint64_t ethash::datasetSize(uint64_t _epoch)
+{
+	uint64_t size = c_datasetBytesInit + c_datasetBytesGrowth * _epoch - c_mixBytes;
+	while (!isPrime(size / c_mixBytes))
+		size -= 2 * c_mixBytes;
+	return size;
+}
+
+LightCache::LightCache(uint64_t _epoch):
+	LightCache(seedHash(_epoch), lightCacheSize(_epoch), ethash::datasetSize(_epoch))
+{
+}
+
+LightCache::LightCache(h256 const& _seed, uint64_t _cacheSize, uint64_t _datasetSize):
+	m_nodes(_cacheSize / c_hashBytes),
+	m_datasetSize(_datasetSize)
+{
+	size_t const n = m_nodes.size();
+	assertThrow(n > 0, EthashError, "Light cache too small.");
+	assertThrow(_datasetSize / c_hashBytes <= (uint64_t(1) << 32), EthashError, "Dataset too large.");
+
+	m_nodes[0] = keccak512(_seed.ref());
+	for (size_t i = 1; i < n; ++i)
+		m_nodes[i] = keccak512(m_nodes[i - 1].ref());
+
+	for (unsigned round = 0; round < c_cacheRounds; ++round)
+		for (size_t i = 0; i < n; ++i)
+		{
+			h512 const& other = m_nodes[word(m_nodes[i], 0) % n];
+			h512 input = m_nodes[(i + n - 1) % n];
+			for (unsigned k = 0; k < c_hashBytes; ++k)
+				input[k] ^= other[k];
+			m_nodes[i] = keccak512(input.ref());
+		}
+}
+
+h512 LightCache::datasetItem(uint32_t _index) const
+{
+	size_t const n = m_nodes.size();
+	h512 mix = m_nodes[_index % n];
+	setWord(mix, 0, word(mix, 0) ^ _index);
+	mix = keccak512(mix.ref());
+
+	array<uint32_t, c_hashWords> words;
+	for (unsigned i = 0; i < c_hashWords; ++i)
+		words[i] = word(mix, i);
+	for (unsigned j = 0; j < c_datasetParents; ++j)
+	{
+		h512 const& parent = m_nodes[fnv(_index ^ j, words[j % c_hashWords]) % n];
+		for (unsigned i = 0; i < c_hashWords; ++i)
+			words[i] = fnv(words[i], word(parent, i));
+	}
+	for (unsigned i = 0; i < c_hashWords; ++i)
+		setWord(mix, i, words[i]);
+	return keccak512(mix.ref());
+}
+
+ETHASH_MULTIVERSIONED
+void LightCache::datasetItems(array<uint32_t, c_lanes> const& _indices, size_t _count, array<h512, c_lanes>& _items) const
+{
+	size_t const n = m_nodes.size();
+	// All lanes are hashed, since a full batch costs as much as a partial one.
+	array<h512, c_lanes> mixes;
+	for (size_t l = 0; l < c_lanes; ++l)
+	{
+		uint32_t const index = _indices[l < _count ? l : 0];
+		mixes[l] = m_nodes[index % n];
+		setWord(mixes[l], 0, word(mixes[l], 0) ^ index);
+	}
+	keccak512Lanes(mixes, c_lanes);
+	uint32_t words[c_hashWords][c_lanes];
+	for (size_t l = 0; l < c_lanes; ++l)
+		for (unsigned i = 0; i < c_hashWords; ++i)
+			words[i][l] = word(mixes[l], i);
+	for (unsigned j = 0; j < c_datasetParents; ++j)
+	{
+		array<h512 const*, c_lanes> parents;
+		for (size_t l = 0; l < c_lanes; ++l)
+			parents[l] = &m_nodes[fnv(_indices[l < _count ? l : 0] ^ j, words[j % c_hashWords][l]) % n];
+		for (unsigned i = 0; i < c_hashWords; ++i)
+			for (size_t l = 0; l < c_lanes; ++l)
+				words[i][l] = fnv(words[i][l], word(*parents[l], i));
+	}
+	for (size_t l = 0; l < _count; ++l)
+		for (unsigned i = 0; i < c_hashWords; ++i)
+			setWord(_items[l], i, words[i][l]);
+	keccak512Lanes(_items, _count);
+}
+
+Result LightCache::hashimoto(h256 const& _headerHash, uint64_t _nonce) const
+{
+	return computeHashimoto(_headerHash, _nonce, m_datasetSize, [this](uint32_t _index) {
+		return datasetItem(_index);
+	});
+}
+
+vector<Result> LightCache::hashimoto(vector<HashimotoInput> const& _inputs) const
+{
+	return computeHashimotoBatch(_inputs, m_datasetSize, [this](
+		array<uint32_t, c_lanes> const& _indices,
+		size_t _count,
+		array<h512, c_lanes>& _items
+	) {
+		datasetItems(_indices, _count, _items);
+	});
+}
+
+Dataset::Dataset(LightCache const& _cache, fs::path const& _file, size_t _threads):
+	m_size(_cache.datasetSize())
+{
+	if (!isCompleteDataset(_file, m_size))
+	{
+		generateDataset(_cache, _file, _threads);
+		m_generated = true;
+	}
+	ip::file_mapping mapping(_file.string().c_str(), ip::read_only);
+	m_region.reset(new ip::mapped_region(mapping, ip::read_only));
+	m_items = static_cast<uint8_t const*>(m_region->get_address()) + c_datasetMagicBytes;
+}
+
+Dataset::~Dataset()
+{
+}
+
+h512 Dataset::item(uint32_t _index) const
+{
+	return h512(bytesConstRef(m_items + uint64_t(_index) * c_hashBytes, c_hashBytes));
+}
+
+Result Dataset::hashimoto(h256 const& _headerHash, uint64_t _nonce) const
+{
+	return computeHashimoto(_headerHash, _nonce, m_size, [this](uint32_t _index) {
+		return item(_index);
+	});
+}
+
+vector<Result> Dataset::hashimoto(vector<HashimotoInput> const& _inputs) const
+{
+	return computeHashimotoBatch(_inputs, m_size, [this](
+		array<uint32_t, c_lanes> const& _indices,
+		size_t _count,
+		array<h512, c_lanes>& _items
+	) {
+		for (size_t l = 0; l < _count; ++l)
+			_items[l] = item(_indices[l]);
+	});
+}
+
+string ethash::datasetFileName(uint64_t _epoch)
+{
+	h256 const seed = seedHash(_epoch);
+	return "full-R23-" + toHex(bytesConstRef(seed.data(), 8));
+}
+
+bool ethash::checkDifficulty(h256 const& _finalHash, u256 const& _difficulty)
+{
+	if (_difficulty == 0)
+		return false;
+	// The target is 2**256 / difficulty.
+	return bigint(u256(_finalHash)) * _difficulty <= (bigint(1) << 256);
+}
+
+Verifier::Verifier(size_t _maxCaches):
+	m_maxCaches(max<size_t>(_maxCaches, 1))
+{
+}
+
+Verifier::~Verifier()
+{
+	for (auto const& dataset: m_datasets)
+		dataset.second.wait();
+}
+
+void Verifier::useFullDatasets(fs::path const& _directory, size_t _threads)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_datasetDirectory = _directory;
+	m_datasetThreads = max<size_t>(_threads, 1);
+}
+
+bool Verifier::verify(
+	u256 const& _blockNumber,
+	h256 const& _headerHash,
+	h256 const& _mixHash,
+	u256 const& _nonce,
+	u256 const& _difficulty
+)
+{
+	if (_blockNumber / c_epochLength > c_maxEpoch || _nonce > numeric_limits<uint64_t>::max())
+		return false;
+	uint64_t const nonce = uint64_t(_nonce);
+	// The final hash only depends on the mix hash, so the difficulty can be checked
+	// before the light cache is needed.
+	if (!checkDifficulty(hashimotoFinalHash(hashimotoSeed(_headerHash, nonce), _mixHash), _difficulty))
+		return false;
+
+	uint64_t const epoch = uint64_t(_blockNumber / c_epochLength);
+	bool fullDatasets = false;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		fullDatasets = !!m_datasetDirectory;
+	}
+	if (fullDatasets)
+		return dataset(epoch)->hashimoto(_headerHash, nonce).mixHash == _mixHash;
+	else
+		return lightCache(epoch)->hashimoto(_headerHash, nonce).mixHash == _mixHash;
+}
+
+vector<bool> Verifier::verify(vector<ProofOfWork> const& _proofs, size_t _threads)
+{
+	// Proofs that pass the checks not requiring hashimoto, grouped by epoch.
+	map<uint64_t, vector<size_t>> candidates;
+	for (size_t i = 0; i < _proofs.size(); ++i)
+	{
+		ProofOfWork const& proof = _proofs[i];
+		if (proof.blockNumber / c_epochLength > c_maxEpoch || proof.nonce > numeric_limits<uint64_t>::max())
+			continue;
+		h512 const seed = hashimotoSeed(proof.headerHash, uint64_t(proof.nonce));
+		if (checkDifficulty(hashimotoFinalHash(seed, proof.mixHash), proof.difficulty))
+			candidates[uint64_t(proof.blockNumber / c_epochLength)].push_back(i);
+	}
+
+	bool fullDatasets = false;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		fullDatasets = !!m_datasetDirectory;
+	}
+
+	// Written concurrently, which is not possible with the bits of vector<bool>.
+	vector<char> valid(_proofs.size(), false);
+	ThreadPool pool(_threads);
+	for (auto const& epoch: candidates)
+	{
+		shared_ptr<Dataset const> dataset = fullDatasets ? this->dataset(epoch.first) : nullptr;
+		shared_ptr<LightCache const> cache = fullDatasets ? nullptr : lightCache(epoch.first);
+		vector<size_t> const& indices = epoch.second;
+		for (size_t begin = 0; begin < indices.size(); begin += c_lanes)
+			pool.enqueue([&, dataset, cache, begin]() {
+				size_t const end = min(begin + c_lanes, indices.size());
+				vector<HashimotoInput> inputs;
+				for (size_t i = begin; i < end; ++i)
+					inputs.emplace_back(_proofs[indices[i]].headerHash, uint64_t(_proofs[indices[i]].nonce));
+				vector<Result> results = dataset ? dataset->hashimoto(inputs) : cache->hashimoto(inputs);
+				for (size_t i = begin; i < end; ++i)
+					valid[indices[i]] = results[i - begin].mixHash == _proofs[indices[i]].mixHash;
+			});
+	}
+	pool.wait();
+	return vector<bool>(valid.begin(), valid.end());
+}
+
+shared_ptr<LightCache const> Verifier::lightCache(uint64_t _epoch)
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		for (auto it = m_caches.begin(); it != m_caches.end(); ++it)
+			if (it->first == _epoch)
+			{
+				m_caches.splice(m_caches.begin(), m_caches, it);
+				return m_caches.front().second;
+			}
+	}
+
+	// Generating the cache takes long, so other epochs can be used meanwhile.
+	// If two threads generate the same cache, the first one is kept.
+	shared_ptr<LightCache const> cache = make_shared<LightCache>(_epoch);
+
+	lock_guard<mutex> lock(m_mutex);
+	++m_generatedCaches;
+	for (auto it = m_caches.begin(); it != m_caches.end(); ++it)
+		if (it->first == _epoch)
+		{
+			m_caches.splice(m_caches.begin(), m_caches, it);
+			return m_caches.front().second;
+		}
+	m_caches.emplace_front(_epoch, cache);
+	if (m_caches.size() > m_maxCaches)
+		m_caches.pop_back();
+	return cache;
+}
+
+shared_ptr<Dataset const> Verifier::dataset(uint64_t _epoch)
+{
+	shared_future<shared_ptr<Dataset const>> current;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		assertThrow(m_datasetDirectory, EthashError, "Full datasets are not used.");
+		current = startDataset(_epoch);
+		// Datasets that are still generated cannot be dropped without waiting for them.
+		for (auto it = m_datasets.begin(); it != m_datasets.end();)
+			if (
+				it->first != _epoch &&
+				it->first != _epoch + 1 &&
+				it->second.wait_for(chrono::seconds(0)) == future_status::ready
+			)
+				it = m_datasets.erase(it);
+			else
+				++it;
+	}
+	// Waits without holding the mutex, which the generation needs to obtain the light cache.
+	shared_ptr<Dataset const> dataset = current.get();
+
+	// The next epoch is only prepared once the current one is available, so that they do not compete.
+	if (_epoch < c_maxEpoch)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		startDataset(_epoch + 1);
+	}
+	return dataset;
+}
+
+shared_future<shared_ptr<Dataset const>> Verifier::startDataset(uint64_t _epoch)
+{
+	auto it = m_datasets.find(_epoch);
+	if (it != m_datasets.end())
+		return it->second;
+
+	fs::path const file = *m_datasetDirectory / datasetFileName(_epoch);
+	size_t const threads = m_datasetThreads;
+	shared_future<shared_ptr<Dataset const>> dataset = async(launch::async, [this, _epoch, file, threads]() {
+		return shared_ptr<Dataset const>(make_shared<Dataset>(*lightCache(_epoch), file, threads));
+	}).share();
+	m_datasets[_epoch] = dataset;
+	return dataset;
+}
+
+size_t Verifier::generatedCaches() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_generatedCaches;
+}
@@ -0,0 +1,223 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Ethash.h
+ * Light client verification of the Ethash proof of work, as evaluated by the ETHASH instruction.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/FixedHash.h>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <array>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace dev
+{
+namespace ethash
+{
+
+DEV_SIMPLE_EXCEPTION(EthashError);
+
+/// Number of blocks after which the light cache and the dataset change.
+uint64_t const c_epochLength = 30000;
+/// Largest supported epoch. Its light cache is about 280 MB in size.
+uint64_t const c_maxEpoch = 2047;
+/// Number of hashimoto evaluations that are interleaved when running them in batches.
+size_t const c_lanes = 8;
+
+/// @returns the seed hash of the light cache of @a _epoch.
+h256 seedHash(uint64_t _epoch);
+/// @returns the size of the light cache of @a _epoch in bytes.
+uint64_t lightCacheSize(uint64_t _epoch);
+/// @returns the size of the full dataset of @a _epoch in bytes.
+uint64_t datasetSize(uint64_t _epoch);
+
+struct Result
+{
+	h256 mixHash;
+	/// Hash that has to meet the difficulty target.
+	h256 finalHash;
+};
+
+/// Input of hashimoto.
+using HashimotoInput = std::pair<h256, uint64_t>;
+
+/// Proof of work of a block header, i.e. the arguments of the ETHASH instruction.
+struct ProofOfWork
+{
+	u256 blockNumber;
+	h256 headerHash;
+	h256 mixHash;
+	u256 nonce;
+	u256 difficulty;
+};
+
+/**
+ * Light cache of an epoch, from which the items of the full dataset are computed on demand.
+ */
+class LightCache: boost::noncopyable
+{
+public:
+	/// Generates the light cache of @a _epoch.
+	explicit LightCache(uint64_t _epoch);
+	/// Generates a light cache of @a _cacheSize bytes from @a _seed for a dataset of @a _datasetSize bytes.
+	LightCache(h256 const& _seed, uint64_t _cacheSize, uint64_t _datasetSize);
+
+	/// @returns the 64 byte item of the full dataset at @a _index.
+	h512 datasetItem(uint32_t _index) const;
+
+	/// Computes the dataset items at the first @a _count of @a _indices into @a _items.
+	/// The computations are interleaved, such that they run on independent lanes of the processor.
+	void datasetItems(
+		std::array<uint32_t, c_lanes> const& _indices,
+		size_t _count,
+		std::array<h512, c_lanes>& _items
+	) const;
+
+	/// Runs hashimoto on @a _headerHash and @a _nonce, computing the accessed dataset items from the cache.
+	Result hashimoto(h256 const& _headerHash, uint64_t _nonce) const;
+	/// Runs hashimoto on all header hashes and nonces in @a _inputs, interleaving the evaluations.
+	std::vector<Result> hashimoto(std::vector<HashimotoInput> const& _inputs) const;
+
+	uint64_t datasetSize() const { return m_datasetSize; }
+
+private:
+	std::vector<h512> m_nodes;
+	uint64_t m_datasetSize;
+};
+
+/**
+ * Full dataset of an epoch, stored in a memory mapped file, such that hashimoto only
+ * needs to look up the accessed items instead of computing them from the light cache.
+ */
+class Dataset: boost::noncopyable
+{
+public:
+	/// Maps the dataset of @a _cache stored in @a _file. If the file does not exist or is incomplete,
+	/// it is first generated using @a _threads threads.
+	Dataset(LightCache const& _cache, boost::filesystem::path const& _file, size_t _threads);
+	~Dataset();
+
+	/// @returns the 64 byte item at @a _index.
+	h512 item(uint32_t _index) const;
+
+	/// Runs hashimoto on @a _headerHash and @a _nonce.
+	Result hashimoto(h256 const& _headerHash, uint64_t _nonce) const;
+	/// Runs hashimoto on all header hashes and nonces in @a _inputs, interleaving the evaluations
+	/// such that the memory accesses overlap.
+	std::vector<Result> hashimoto(std::vector<HashimotoInput> const& _inputs) const;
+
+	uint64_t size() const { return m_size; }
+	/// @returns true if the file was generated rather than found complete.
+	bool generated() const { return m_generated; }
+
+private:
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+	uint8_t const* m_items = nullptr;
+	uint64_t m_size = 0;
+	bool m_generated = false;
+};
+
+/// @returns the name of the file storing the full dataset of @a _epoch.
+std::string datasetFileName(uint64_t _epoch);
+
+/// @returns true if @a _finalHash, interpreted as a big endian number, meets the target of @a _difficulty.
+bool checkDifficulty(h256 const& _finalHash, u256 const& _difficulty);
+
+/**
+ * Verifies the proof of work of block headers.
+ * The light caches of the most recently used epochs are kept, such that repeated verifications
+ * in the same epoch only cost one hashimoto evaluation. Can be used from multiple threads.
+ */
+class Verifier: boost::noncopyable
+{
+public:
+	/// @param _maxCaches number of light caches kept (at least one).
+	explicit Verifier(size_t _maxCaches = 3);
+	/// Waits for datasets that are generated in the background.
+	~Verifier();
+
+	/// Switches to running hashimoto on full datasets, which are stored in @a _directory and
+	/// generated using @a _threads threads. Whenever the dataset of an epoch is first used,
+	/// the dataset of the next epoch is generated in the background.
+	void useFullDatasets(boost::filesystem::path const& _directory, size_t _threads);
+
+	/// @returns true if @a _mixHash and @a _nonce are a valid proof of work for the header with hash
+	/// @a _headerHash in block @a _blockNumber with difficulty @a _difficulty.
+	bool verify(
+		u256 const& _blockNumber,
+		h256 const& _headerHash,
+		h256 const& _mixHash,
+		u256 const& _nonce,
+		u256 const& _difficulty
+	);
+	/// Verifies all @a _proofs, interleaving the hashimoto evaluations of up to c_lanes proofs
+	/// of the same epoch and distributing them over @a _threads threads.
+	/// @returns for every proof whether it is valid.
+	std::vector<bool> verify(std::vector<ProofOfWork> const& _proofs, size_t _threads);
+
+	/// @returns the light cache of @a _epoch, generating it if it is not kept.
+	std::shared_ptr<LightCache const> lightCache(uint64_t _epoch);
+
+	/// @returns the full dataset of @a _epoch, generating it or waiting for its generation.
+	/// Requires full datasets to be used.
+	std::shared_ptr<Dataset const> dataset(uint64_t _epoch);
+
+	/// @returns the number of light caches generated so far.
+	size_t generatedCaches() const;
+
+private:
+	/// Starts loading or generating the dataset of @a _epoch, unless already started.
+	/// Requires the mutex to be held.
+	std::shared_future<std::shared_ptr<Dataset const>> startDataset(uint64_t _epoch);
+
+	size_t m_maxCaches;
+	mutable std::mutex m_mutex;
+	/// Kept light caches by epoch, most recently used first.
+	std::list<std::pair<uint64_t, std::shared_ptr<LightCache const>>> m_caches;
+	size_t m_generatedCaches = 0;
+
+	boost::optional<boost::filesystem::path> m_datasetDirectory;
+	size_t m_datasetThreads = 1;
+	/// Datasets of the most recently used epoch and the one following it.
+	std::map<uint64_t, std::shared_future<std::shared_ptr<Dataset const>>> m_datasets;
+};
+
+}
+}
@@ -20,167 +20,210 @@
  */
 
 #include <libdevcore/Keccak256.h>
+#include <libdevcore/KeccakPermutation.h>
 
+#include <array>
 #include <cstdint>
-#include <cstdio>
-#include <cstdlib>
 #include <cstring>
+#include <map>
 
 using namespace std;
 using namespace dev;
 
-namespace dev
+namespace
 {
 
-namespace
+/// Number of 64 bit lanes of the state.
+size_t const c_stateLanes = 25;
+/// Padding of Keccak, which is 0x06 for SHA-3.
+uint8_t const c_delimiter = 0x01;
+
+inline uint64_t loadLane(uint8_t const* _data)
 {
+	uint64_t lane = 0;
+	for (size_t i = 0; i < 8; ++i)
+		lane |= uint64_t(_data[i]) << (8 * i);
+	return lane;
+}
 
-/** libkeccak-tiny
- *
- * A single-file implementation of SHA-3 and SHAKE.
- *
- * Implementor: David Leon Gil
- * License: CC0, attribution kindly requested. Blame taken too,
- * but not liability.
- */
+inline void storeLane(uint8_t* _data, uint64_t _lane)
+{
+	for (size_t i = 0; i < 8; ++i)
+		_data[i] = uint8_t(_lane >> (8 * i));
+}
+
+/// @returns the number of blocks absorbed for an input of @a _size bytes, including the padding.
+inline size_t blockCount(size_t _size, size_t _rate)
+{
+	return _size / _rate + 1;
+}
+
+/// Copies block @a _index of @a _input to @a _block, adding the padding to the last block.
+/// @returns a pointer to the block, which is @a _block only if it had to be copied.
+inline uint8_t const* block(bytesConstRef _input, size_t _index, size_t _rate, uint8_t* _block)
+{
+	size_t const offset = _index * _rate;
+	if (offset + _rate <= _input.size())
+		return _input.data() + offset;
+	size_t const remaining = _input.size() - offset;
+	memset(_block, 0, _rate);
+	if (remaining > 0)
+		memcpy(_block, _input.data() + offset, remaining);
+	_block[remaining] ^= c_delimiter;
+	_block[_rate - 1] ^= 0x80;
+	return _block;
+}
+
+/// Sponge construction, where the @a _rate is 200 - (output size in bits) / 4 and the
+/// output size is at most the rate.
+void sponge(uint8_t* _output, size_t _outputSize, bytesConstRef _input, size_t _rate)
+{
+	uint64_t state[c_stateLanes] = {};
+	uint8_t padded[200];
+	for (size_t i = 0; i < blockCount(_input.size(), _rate); ++i)
+	{
+		uint8_t const* data = block(_input, i, _rate, padded);
+		for (size_t lane = 0; lane < _rate / 8; ++lane)
+			state[lane] ^= loadLane(data + 8 * lane);
+		keccakPermutation(state);
+	}
+	for (size_t lane = 0; lane < _outputSize / 8; ++lane)
+		storeLane(_output + 8 * lane, state[lane]);
+}
+
+#ifdef HAVE_KECCAK_AVX2
+
+bool hasAVX2()
+{
+	static bool const supported = []() {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	}();
+	return supported;
+}
 
-/******** The Keccak-f[1600] permutation ********/
-
-/*** Constants. ***/
-static const uint8_t rho[24] = \
-	{ 1,  3,   6, 10, 15, 21,
-	28, 36, 45, 55,  2, 14,
-	27, 41, 56,  8, 25, 43,
-	62, 18, 39, 61, 20, 44};
-static const uint8_t pi[24] = \
-	{10,  7, 11, 17, 18, 3,
-	5, 16,  8, 21, 24, 4,
-	15, 23, 19, 13, 12, 2,
-	20, 14, 22,  9, 6,  1};
-static const uint64_t RC[24] = \
-	{1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
-	0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
-	0x8aULL, 0x88ULL, 0x80008009ULL, 0x8000000aULL,
-	0x8000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
-	0x8000000000008002ULL, 0x8000000000000080ULL, 0x800aULL, 0x800000008000000aULL,
-	0x8000000080008081ULL, 0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
-
-/*** Helper macros to unroll the permutation. ***/
-#define rol(x, s) (((x) << s) | ((x) >> (64 - s)))
-#define REPEAT6(e) e e e e e e
-#define REPEAT24(e) REPEAT6(e e e e)
-#define REPEAT5(e) e e e e e
-#define FOR5(v, s, e) \
-  v = 0;            \
-  REPEAT5(e; v += s;)
-
-/*** Keccak-f[1600] ***/
-static inline void keccakf(void* state) {
-	uint64_t* a = (uint64_t*)state;
-	uint64_t b[5] = {0};
-
-	for (int i = 0; i < 24; i++)
+#endif
+
+#ifdef HAVE_KECCAK_AVX512
+
+bool hasAVX512()
+{
+	static bool const supported = []() {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+	}();
+	return supported;
+}
+
+#endif
+
+/// Sponge construction for @a N inputs with the same number of blocks, which are absorbed in parallel
+/// by @a _permutation, which applies Keccak-f[1600] to @a N interleaved states.
+template <size_t N>
+void spongeLanes(
+	array<uint8_t*, N> const& _outputs,
+	size_t _outputSize,
+	array<bytesConstRef, N> const& _inputs,
+	size_t _rate,
+	void (*_permutation)(uint64_t*)
+)
+{
+	uint64_t states[N * c_stateLanes] = {};
+	uint8_t padded[N][200];
+	for (size_t i = 0; i < blockCount(_inputs[0].size(), _rate); ++i)
 	{
-		uint8_t x, y;
-		// Theta
-		FOR5(x, 1,
-			 b[x] = 0;
-			 FOR5(y, 5,
-				  b[x] ^= a[x + y]; ))
-		FOR5(x, 1,
-			 FOR5(y, 5,
-				  a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1); ))
-		// Rho and pi
-		uint64_t t = a[1];
-		x = 0;
-		REPEAT24(b[0] = a[pi[x]];
-				 a[pi[x]] = rol(t, rho[x]);
-				 t = b[0];
-				 x++; )
-		// Chi
-		FOR5(y,
-		   5,
-		   FOR5(x, 1,
-				b[x] = a[y + x];)
-		   FOR5(x, 1,
-				a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
-		// Iota
-		a[0] ^= RC[i];
+		for (size_t k = 0; k < N; ++k)
+		{
+			uint8_t const* data = block(_inputs[k], i, _rate, padded[k]);
+			for (size_t lane = 0; lane < _rate / 8; ++lane)
+				states[N * lane + k] ^= loadLane(data + 8 * lane);
+		}
+		_permutation(states);
 	}
+	for (size_t k = 0; k < N; ++k)
+		for (size_t lane = 0; lane < _outputSize / 8; ++lane)
+			storeLane(_outputs[k] + 8 * lane, states[N * lane + k]);
 }
 
-/******** The FIPS202-defined functions. ********/
-
-/*** Some helper macros. ***/
-
-#define _(S) do { S } while (0)
-#define FOR(i, ST, L, S) \
-  _(for (size_t i = 0; i < L; i += ST) { S; })
-#define mkapply_ds(NAME, S)                                          \
-  static inline void NAME(uint8_t* dst,                              \
-						  const uint8_t* src,                        \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
-#define mkapply_sd(NAME, S)                                          \
-  static inline void NAME(const uint8_t* src,                        \
-						  uint8_t* dst,                              \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
-
-mkapply_ds(xorin, dst[i] ^= src[i])  // xorin
-mkapply_sd(setout, dst[i] = src[i])  // setout
-
-#define P keccakf
-#define Plen 200
-
-// Fold P*F over the full blocks of an input.
-#define foldP(I, L, F) \
-  while (L >= rate) {  \
-	F(a, I, rate);     \
-	P(a);              \
-	I += rate;         \
-	L -= rate;         \
-  }
-
-/** The sponge-based hash construction. **/
-inline void hash(
-	uint8_t* out,
-	size_t outlen,
-	const uint8_t* in,
-	size_t inlen,
-	size_t rate,
-	uint8_t delim
+/// Hashes the inputs that are not @a _done yet in groups of @a N with the same number of blocks
+/// and marks them as done.
+template <size_t N, class Hash>
+void spongeGroups(
+	vector<Hash>& _outputs,
+	vector<bytesConstRef> const& _inputs,
+	size_t _rate,
+	void (*_permutation)(uint64_t*),
+	vector<bool>& _done
 )
 {
-	uint8_t a[Plen] = {0};
-	// Absorb input.
-	foldP(in, inlen, xorin);
-	// Xor in the DS and pad frame.
-	a[inlen] ^= delim;
-	a[rate - 1] ^= 0x80;
-	// Xor in the last block.
-	xorin(a, in, inlen);
-	// Apply P
-	P(a);
-	// Squeeze output.
-	foldP(out, outlen, setout);
-	setout(a, out, outlen);
-	memset(a, 0, 200);
+	map<size_t, vector<size_t>> byBlockCount;
+	for (size_t i = 0; i < _inputs.size(); ++i)
+		if (!_done[i])
+			byBlockCount[blockCount(_inputs[i].size(), _rate)].push_back(i);
+	for (auto const& group: byBlockCount)
+		for (size_t begin = 0; begin + N <= group.second.size(); begin += N)
+		{
+			array<uint8_t*, N> groupOutputs;
+			array<bytesConstRef, N> groupInputs;
+			for (size_t k = 0; k < N; ++k)
+			{
+				size_t const index = group.second[begin + k];
+				groupOutputs[k] = _outputs[index].data();
+				groupInputs[k] = _inputs[index];
+				_done[index] = true;
+			}
+			spongeLanes<N>(groupOutputs, Hash::size, groupInputs, _rate, _permutation);
+		}
+}
+
+/// Hashes all @a _inputs, using the widest permutation supported by the processor for inputs
+/// with the same number of blocks.
+template <class Hash>
+vector<Hash> spongeBatch(vector<bytesConstRef> const& _inputs, size_t _rate)
+{
+	vector<Hash> outputs(_inputs.size());
+	vector<bool> done(_inputs.size(), false);
+#ifdef HAVE_KECCAK_AVX512
+	if (hasAVX512())
+		spongeGroups<8>(outputs, _inputs, _rate, keccakPermutationX8AVX512, done);
+#endif
+#ifdef HAVE_KECCAK_AVX2
+	if (hasAVX2())
+		spongeGroups<4>(outputs, _inputs, _rate, keccakPermutationX4AVX2, done);
+#endif
+	for (size_t i = 0; i < _inputs.size(); ++i)
+		if (!done[i])
+			sponge(outputs[i].data(), Hash::size, _inputs[i], _rate);
+	return outputs;
 }
 
 }
 
+namespace dev
+{
+
 h256 keccak256(bytesConstRef _input)
 {
 	h256 output;
-	// Parameters used:
-	// The 0x01 is the specific padding for keccak (sha3 uses 0x06) and
-	// the way the round size (or window or whatever it was) is calculated.
-	// 200 - (256 / 4) is the "rate"
-	hash(output.data(), output.size, _input.data(), _input.size(), 200 - (256 / 4), 0x01);
+	sponge(output.data(), output.size, _input, 200 - (256 / 4));
 	return output;
 }
 
+vector<h256> keccak256(vector<bytesConstRef> const& _inputs)
+{
+	return spongeBatch<h256>(_inputs, 200 - (256 / 4));
+}
+
+h512 keccak512(bytesConstRef _input)
+{
+	h512 output;
+	sponge(output.data(), output.size, _input, 200 - (512 / 4));
+	return output;
+}
+
+vector<h512> keccak512(vector<bytesConstRef> const& _inputs)
+{
+	return spongeBatch<h512>(_inputs, 200 - (512 / 4));
+}
+
 }
@@ -26,6 +26,7 @@
 #include <libdevcore/FixedHash.h>
 
 #include <string>
+#include <vector>
 
 namespace dev
 {
@@ -42,4 +43,14 @@ inline h256 keccak256(std::string const& _input) { return keccak256(bytesConstRe
 /// Calculate Keccak-256 hash of the given input (presented as a FixedHash), returns a 256-bit hash.
 template<unsigned N> inline h256 keccak256(FixedHash<N> const& _input) { return keccak256(_input.ref()); }
 
+/// Calculate the Keccak-256 hashes of all @a _inputs. On processors supporting AVX-512 or AVX2,
+/// inputs with the same number of blocks are hashed eight or four at a time.
+std::vector<h256> keccak256(std::vector<bytesConstRef> const& _inputs);
+
+/// Calculate Keccak-512 hash of the given input, returning as a 512-bit hash.
+h512 keccak512(bytesConstRef _input);
+
+/// Calculate the Keccak-512 hashes of all @a _inputs, batched like the Keccak-256 hashes.
+std::vector<h512> keccak512(std::vector<bytesConstRef> const& _inputs);
+
 }
@@ -0,0 +1,62 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file KeccakAVX2.cpp
+ * Keccak-f[1600] on four states at once using AVX2.
+ * This file is compiled with AVX2 enabled and must only be called after checking that the
+ * processor supports it. To keep code using AVX2 from being shared with other files,
+ * it only uses intrinsics and functions with internal linkage.
+ */
+
+#include <libdevcore/KeccakPermutation.h>
+
+#include <immintrin.h>
+
+namespace
+{
+
+/// The lanes at the same position of four states.
+struct Lanes
+{
+	Lanes() = default;
+	explicit Lanes(uint64_t _value): value(_mm256_set1_epi64x(int64_t(_value))) {}
+	explicit Lanes(__m256i _value): value(_value) {}
+
+	__m256i value;
+};
+
+inline Lanes operator^(Lanes _a, Lanes _b) { return Lanes(_mm256_xor_si256(_a.value, _b.value)); }
+inline Lanes operator&(Lanes _a, Lanes _b) { return Lanes(_mm256_and_si256(_a.value, _b.value)); }
+inline Lanes operator|(Lanes _a, Lanes _b) { return Lanes(_mm256_or_si256(_a.value, _b.value)); }
+inline Lanes operator~(Lanes _a) { return Lanes(_mm256_xor_si256(_a.value, _mm256_set1_epi64x(-1))); }
+
+template <unsigned N>
+inline Lanes rol(Lanes _lanes)
+{
+	return Lanes(_mm256_or_si256(_mm256_slli_epi64(_lanes.value, N), _mm256_srli_epi64(_lanes.value, 64 - N)));
+}
+
+}
+
+void dev::keccakPermutationX4AVX2(uint64_t* _states)
+{
+	Lanes lanes[25];
+	for (size_t i = 0; i < 25; ++i)
+		lanes[i] = Lanes(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(_states + 4 * i)));
+	keccakPermutation(lanes);
+	for (size_t i = 0; i < 25; ++i)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(_states + 4 * i), lanes[i].value);
+}
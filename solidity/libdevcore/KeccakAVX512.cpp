@@ -0,0 +1,68 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file KeccakAVX512.cpp
+ * Keccak-f[1600] on eight states at once using AVX-512.
+ * This file is compiled with AVX-512F enabled and must only be called after checking that the
+ * processor supports it. To keep code using AVX-512 from being shared with other files,
+ * it only uses intrinsics and functions with internal linkage.
+ */
+
+#include <libdevcore/KeccakPermutation.h>
+
+#include <immintrin.h>
+
+namespace
+{
+
+/// The lanes at the same position of eight states.
+struct Lanes
+{
+	Lanes() = default;
+	explicit Lanes(uint64_t _value): value(_mm512_set1_epi64(int64_t(_value))) {}
+	explicit Lanes(__m512i _value): value(_value) {}
+
+	__m512i value;
+};
+
+inline Lanes operator^(Lanes _a, Lanes _b) { return Lanes(_mm512_xor_si512(_a.value, _b.value)); }
+inline Lanes operator&(Lanes _a, Lanes _b) { return Lanes(_mm512_and_si512(_a.value, _b.value)); }
+inline Lanes operator|(Lanes _a, Lanes _b) { return Lanes(_mm512_or_si512(_a.value, _b.value)); }
+inline Lanes operator~(Lanes _a) { return Lanes(_mm512_xor_si512(_a.value, _mm512_set1_epi64(-1))); }
+
+/// Eight unsigned 64 bit elements. The shift and rotation intrinsics of AVX-512 cause false
+/// "used uninitialized" warnings in GCC 12, so the rotation uses the vector operators of GCC and
+/// Clang instead, which compile to the same instruction.
+using Vector = unsigned long long __attribute__((vector_size(64)));
+
+template <unsigned N>
+inline Lanes rol(Lanes _lanes)
+{
+	Vector value = Vector(_lanes.value);
+	return Lanes(__m512i((value << N) | (value >> (64 - N))));
+}
+
+}
+
+void dev::keccakPermutationX8AVX512(uint64_t* _states)
+{
+	Lanes lanes[25];
+	for (size_t i = 0; i < 25; ++i)
+		lanes[i] = Lanes(_mm512_loadu_si512(_states + 8 * i));
+	keccakPermutation(lanes);
+	for (size_t i = 0; i < 25; ++i)
+		_mm512_storeu_si512(_states + 8 * i, lanes[i].value);
+}
@@ -0,0 +1,216 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file KeccakPermutation.h
+ * The Keccak-f[1600] permutation, shared by the scalar and the vectorised implementations.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dev
+{
+
+static uint64_t const c_keccakRoundConstants[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+	0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+	0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+	0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+	0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+	0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+template <unsigned N>
+inline uint64_t rol(uint64_t _lane)
+{
+	return (_lane << N) | (_lane >> (64 - N));
+}
+
+/// Applies Keccak-f[1600] to the 25 lanes of @a _state, where lane (x, y) is at index x + 5 * y.
+/// @a Lane is a 64 bit lane or a vector of lanes of independent states, which supports the bitwise
+/// operators, construction from a round constant and rotation by @a rol.
+/// The rounds are unrolled in pairs and written as in the "lane complementing" implementation
+/// of the Keccak team, where six lanes are stored complemented such that chi needs fewer negations.
+template <class Lane>
+inline void keccakPermutation(Lane* _state)
+{
+	_state[1] = ~_state[1];
+	_state[2] = ~_state[2];
+	_state[8] = ~_state[8];
+	_state[12] = ~_state[12];
+	_state[17] = ~_state[17];
+	_state[20] = ~_state[20];
+
+	Lane Aba = _state[0]; Lane Abe = _state[1]; Lane Abi = _state[2]; Lane Abo = _state[3]; Lane Abu = _state[4];
+	Lane Aga = _state[5]; Lane Age = _state[6]; Lane Agi = _state[7]; Lane Ago = _state[8]; Lane Agu = _state[9];
+	Lane Aka = _state[10]; Lane Ake = _state[11]; Lane Aki = _state[12]; Lane Ako = _state[13]; Lane Aku = _state[14];
+	Lane Ama = _state[15]; Lane Ame = _state[16]; Lane Ami = _state[17]; Lane Amo = _state[18]; Lane Amu = _state[19];
+	Lane Asa = _state[20]; Lane Ase = _state[21]; Lane Asi = _state[22]; Lane Aso = _state[23]; Lane Asu = _state[24];
+	Lane Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku, Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+	Lane Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du, Ba, Be, Bi, Bo, Bu;
+
+	for (unsigned round = 0; round < 24; round += 2)
+	{
+		Ca = Aba ^ Aga ^ Aka ^ Ama ^ Asa;
+		Ce = Abe ^ Age ^ Ake ^ Ame ^ Ase;
+		Ci = Abi ^ Agi ^ Aki ^ Ami ^ Asi;
+		Co = Abo ^ Ago ^ Ako ^ Amo ^ Aso;
+		Cu = Abu ^ Agu ^ Aku ^ Amu ^ Asu;
+		Da = Cu ^ rol<1>(Ce);
+		De = Ca ^ rol<1>(Ci);
+		Di = Ce ^ rol<1>(Co);
+		Do = Ci ^ rol<1>(Cu);
+		Du = Co ^ rol<1>(Ca);
+		Ba = Aba ^ Da;
+		Be = rol<44>(Age ^ De);
+		Bi = rol<43>(Aki ^ Di);
+		Bo = rol<21>(Amo ^ Do);
+		Bu = rol<14>(Asu ^ Du);
+		Eba = Ba ^ (Be | Bi);
+		Ebe = Be ^ (~Bi | Bo);
+		Ebi = Bi ^ (Bo & Bu);
+		Ebo = Bo ^ (Bu | Ba);
+		Ebu = Bu ^ (Ba & Be);
+		Eba = Eba ^ Lane(c_keccakRoundConstants[round]);
+		Ba = rol<28>(Abo ^ Do);
+		Be = rol<20>(Agu ^ Du);
+		Bi = rol<3>(Aka ^ Da);
+		Bo = rol<45>(Ame ^ De);
+		Bu = rol<61>(Asi ^ Di);
+		Ega = Ba ^ (Be | Bi);
+		Ege = Be ^ (Bi & Bo);
+		Egi = Bi ^ (Bo | ~Bu);
+		Ego = Bo ^ (Bu | Ba);
+		Egu = Bu ^ (Ba & Be);
+		Ba = rol<1>(Abe ^ De);
+		Be = rol<6>(Agi ^ Di);
+		Bi = rol<25>(Ako ^ Do);
+		Bo = rol<8>(Amu ^ Du);
+		Bu = rol<18>(Asa ^ Da);
+		Eka = Ba ^ (Be | Bi);
+		Eke = Be ^ (Bi & Bo);
+		Eki = Bi ^ (~Bo & Bu);
+		Eko = ~Bo ^ (Bu | Ba);
+		Eku = Bu ^ (Ba & Be);
+		Ba = rol<27>(Abu ^ Du);
+		Be = rol<36>(Aga ^ Da);
+		Bi = rol<10>(Ake ^ De);
+		Bo = rol<15>(Ami ^ Di);
+		Bu = rol<56>(Aso ^ Do);
+		Ema = Ba ^ (Be & Bi);
+		Eme = Be ^ (Bi | Bo);
+		Emi = Bi ^ (~Bo | Bu);
+		Emo = ~Bo ^ (Bu & Ba);
+		Emu = Bu ^ (Ba | Be);
+		Ba = rol<62>(Abi ^ Di);
+		Be = rol<55>(Ago ^ Do);
+		Bi = rol<39>(Aku ^ Du);
+		Bo = rol<41>(Ama ^ Da);
+		Bu = rol<2>(Ase ^ De);
+		Esa = Ba ^ (~Be & Bi);
+		Ese = ~Be ^ (Bi | Bo);
+		Esi = Bi ^ (Bo & Bu);
+		Eso = Bo ^ (Bu | Ba);
+		Esu = Bu ^ (Ba & Be);
+
+		Ca = Eba ^ Ega ^ Eka ^ Ema ^ Esa;
+		Ce = Ebe ^ Ege ^ Eke ^ Eme ^ Ese;
+		Ci = Ebi ^ Egi ^ Eki ^ Emi ^ Esi;
+		Co = Ebo ^ Ego ^ Eko ^ Emo ^ Eso;
+		Cu = Ebu ^ Egu ^ Eku ^ Emu ^ Esu;
+		Da = Cu ^ rol<1>(Ce);
+		De = Ca ^ rol<1>(Ci);
+		Di = Ce ^ rol<1>(Co);
+		Do = Ci ^ rol<1>(Cu);
+		Du = Co ^ rol<1>(Ca);
+		Ba = Eba ^ Da;
+		Be = rol<44>(Ege ^ De);
+		Bi = rol<43>(Eki ^ Di);
+		Bo = rol<21>(Emo ^ Do);
+		Bu = rol<14>(Esu ^ Du);
+		Aba = Ba ^ (Be | Bi);
+		Abe = Be ^ (~Bi | Bo);
+		Abi = Bi ^ (Bo & Bu);
+		Abo = Bo ^ (Bu | Ba);
+		Abu = Bu ^ (Ba & Be);
+		Aba = Aba ^ Lane(c_keccakRoundConstants[round + 1]);
+		Ba = rol<28>(Ebo ^ Do);
+		Be = rol<20>(Egu ^ Du);
+		Bi = rol<3>(Eka ^ Da);
+		Bo = rol<45>(Eme ^ De);
+		Bu = rol<61>(Esi ^ Di);
+		Aga = Ba ^ (Be | Bi);
+		Age = Be ^ (Bi & Bo);
+		Agi = Bi ^ (Bo | ~Bu);
+		Ago = Bo ^ (Bu | Ba);
+		Agu = Bu ^ (Ba & Be);
+		Ba = rol<1>(Ebe ^ De);
+		Be = rol<6>(Egi ^ Di);
+		Bi = rol<25>(Eko ^ Do);
+		Bo = rol<8>(Emu ^ Du);
+		Bu = rol<18>(Esa ^ Da);
+		Aka = Ba ^ (Be | Bi);
+		Ake = Be ^ (Bi & Bo);
+		Aki = Bi ^ (~Bo & Bu);
+		Ako = ~Bo ^ (Bu | Ba);
+		Aku = Bu ^ (Ba & Be);
+		Ba = rol<27>(Ebu ^ Du);
+		Be = rol<36>(Ega ^ Da);
+		Bi = rol<10>(Eke ^ De);
+		Bo = rol<15>(Emi ^ Di);
+		Bu = rol<56>(Eso ^ Do);
+		Ama = Ba ^ (Be & Bi);
+		Ame = Be ^ (Bi | Bo);
+		Ami = Bi ^ (~Bo | Bu);
+		Amo = ~Bo ^ (Bu & Ba);
+		Amu = Bu ^ (Ba | Be);
+		Ba = rol<62>(Ebi ^ Di);
+		Be = rol<55>(Ego ^ Do);
+		Bi = rol<39>(Eku ^ Du);
+		Bo = rol<41>(Ema ^ Da);
+		Bu = rol<2>(Ese ^ De);
+		Asa = Ba ^ (~Be & Bi);
+		Ase = ~Be ^ (Bi | Bo);
+		Asi = Bi ^ (Bo & Bu);
+		Aso = Bo ^ (Bu | Ba);
+		Asu = Bu ^ (Ba & Be);
+	}
+
+	_state[0] = Aba; _state[1] = Abe; _state[2] = Abi; _state[3] = Abo; _state[4] = Abu;
+	_state[5] = Aga; _state[6] = Age; _state[7] = Agi; _state[8] = Ago; _state[9] = Agu;
+	_state[10] = Aka; _state[11] = Ake; _state[12] = Aki; _state[13] = Ako; _state[14] = Aku;
+	_state[15] = Ama; _state[16] = Ame; _state[17] = Ami; _state[18] = Amo; _state[19] = Amu;
+	_state[20] = Asa; _state[21] = Ase; _state[22] = Asi; _state[23] = Aso; _state[24] = Asu;
+	_state[1] = ~_state[1];
+	_state[2] = ~_state[2];
+	_state[8] = ~_state[8];
+	_state[12] = ~_state[12];
+	_state[17] = ~_state[17];
+	_state[20] = ~_state[20];
+}
+
+/// Applies Keccak-f[1600] to four states, whose lanes are interleaved, i.e. lane i of state k
+/// is at @a _states[4 * i + k]. Only available if HAVE_KECCAK_AVX2 is defined and requires
+/// a processor supporting AVX2.
+void keccakPermutationX4AVX2(uint64_t* _states);
+
+/// Applies Keccak-f[1600] to eight states, whose lanes are interleaved, i.e. lane i of state k
+/// is at @a _states[8 * i + k]. Only available if HAVE_KECCAK_AVX512 is defined and requires
+/// a processor supporting AVX-512F.
+void keccakPermutationX8AVX512(uint64_t* _states);
+
+}
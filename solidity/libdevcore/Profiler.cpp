@@ -0,0 +1,185 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Profiler.cpp
+ * Measurement of the wall time, the number of calls and the peak allocation of compiler phases.
+ */
+
+#include <libdevcore/Profiler.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+thread_local Profiler::Context t_context;
+/// Allocation counter of the current thread, created on first use.
+thread_local Profiler::AllocationCounter* t_allocated = nullptr;
+/// Maximum of t_allocated since the start of the innermost measured phase.
+thread_local int64_t t_peakAllocated = 0;
+atomic<bool> s_countsAllocations{false};
+
+Profiler::AllocationCounter& allocationCounter()
+{
+	if (!t_allocated)
+	{
+		// The counter outlives the thread, since its allocations can be freed later. It is
+		// not allocated via operator new, which calls this function.
+		void* memory = malloc(sizeof(Profiler::AllocationCounter));
+		if (!memory)
+			throw bad_alloc();
+		t_allocated = new (memory) Profiler::AllocationCounter{0};
+	}
+	return *t_allocated;
+}
+
+}
+
+atomic<size_t> Profiler::s_activations{0};
+
+Profiler::Context const& Profiler::current()
+{
+	return t_context;
+}
+
+Profiler::Context Profiler::contractContext(string const& _contract)
+{
+	Context context = t_context;
+	context.contract = _contract;
+	context.phase.clear();
+	return context;
+}
+
+void Profiler::record(
+	string const& _contract,
+	string const& _phase,
+	double _seconds,
+	int64_t _peakAllocation,
+	size_t _blocks,
+	size_t _changedBlocks
+)
+{
+	lock_guard<mutex> lock(m_mutex);
+	PhaseStatistics& statistics = m_phases[_contract][_phase];
+	statistics.seconds += _seconds;
+	statistics.calls++;
+	statistics.peakAllocation = max(statistics.peakAllocation, _peakAllocation);
+	statistics.blocks += _blocks;
+	statistics.changedBlocks += _changedBlocks;
+}
+
+Profiler::Phases Profiler::phases() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_phases.find("");
+	return it == m_phases.end() ? Phases{} : it->second;
+}
+
+map<string, Profiler::Phases> Profiler::contractPhases() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	map<string, Phases> phases = m_phases;
+	phases.erase("");
+	return phases;
+}
+
+Profiler::AllocationCounter* Profiler::allocated(size_t _bytes)
+{
+	AllocationCounter& counter = allocationCounter();
+	int64_t allocatedBytes = counter.fetch_add(int64_t(_bytes), memory_order_relaxed) + int64_t(_bytes);
+	t_peakAllocated = max(t_peakAllocated, allocatedBytes);
+	return &counter;
+}
+
+void Profiler::deallocated(AllocationCounter* _counter, size_t _bytes)
+{
+	_counter->fetch_sub(int64_t(_bytes), memory_order_relaxed);
+}
+
+void Profiler::enableAllocationCounting()
+{
+	s_countsAllocations = true;
+}
+
+bool Profiler::countsAllocations()
+{
+	return s_countsAllocations;
+}
+
+ProfilerActivation::ProfilerActivation(Profiler::Context _context)
+{
+	activate(move(_context));
+}
+
+ProfilerActivation::ProfilerActivation(Profiler& _profiler)
+{
+	Profiler::Context context;
+	context.profiler = &_profiler;
+	activate(move(context));
+}
+
+ProfilerActivation::~ProfilerActivation()
+{
+	if (m_active)
+		Profiler::s_activations--;
+	t_context = move(m_previous);
+}
+
+void ProfilerActivation::activate(Profiler::Context _context)
+{
+	m_active = _context.profiler != nullptr;
+	if (m_active)
+		Profiler::s_activations++;
+	m_previous = move(t_context);
+	t_context = move(_context);
+}
+
+ProfilerScope::ProfilerScope(char const* _phase)
+{
+	if (!t_context.profiler)
+		return;
+	m_profiler = t_context.profiler;
+	m_enclosingPhase = t_context.phase;
+	if (!t_context.phase.empty())
+		t_context.phase += "/";
+	t_context.phase += _phase;
+	m_allocatedAtStart = allocationCounter().load(memory_order_relaxed);
+	m_enclosingPeak = t_peakAllocated;
+	t_peakAllocated = m_allocatedAtStart;
+	m_start = chrono::steady_clock::now();
+}
+
+ProfilerScope::~ProfilerScope()
+{
+	if (!m_profiler)
+		return;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - m_start).count();
+	int64_t peak = t_peakAllocated - m_allocatedAtStart;
+	t_peakAllocated = max(m_enclosingPeak, t_peakAllocated);
+	m_profiler->record(t_context.contract, t_context.phase, seconds, peak, m_blocks, m_changedBlocks);
+	t_context.phase = move(m_enclosingPhase);
+}
+
+void ProfilerScope::countBlocks(size_t _blocks, size_t _changed)
+{
+	m_blocks += _blocks;
+	m_changedBlocks += _changed;
+}
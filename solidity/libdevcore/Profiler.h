@@ -0,0 +1,159 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Profiler.h
+ * Measurement of the wall time, the number of calls and the peak allocation of compiler phases.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace dev
+{
+
+/// Statistics of a compiler phase, accumulated over all its calls.
+struct PhaseStatistics
+{
+	/// Wall time in seconds, including the nested phases.
+	double seconds = 0;
+	size_t calls = 0;
+	/// Largest number of bytes that were allocated on top of the memory in use when a call
+	/// started, on the thread running the call. Only known if allocations are counted.
+	int64_t peakAllocation = 0;
+	/// Number of blocks of code the phase looked at and changed, for phases that report them.
+	size_t blocks = 0;
+	size_t changedBlocks = 0;
+};
+
+/**
+ * Collects the statistics of compiler phases per contract.
+ * Phases are measured by ProfilerScope while a profiler is active on the current thread,
+ * see ProfilerActivation. Otherwise, measuring a phase only costs a thread local lookup.
+ * Tasks run by ThreadPool inherit the profiler, contract and phase of the thread enqueuing them.
+ */
+class Profiler: boost::noncopyable
+{
+public:
+	/// Statistics by phase name, where nested phases are separated by "/".
+	using Phases = std::map<std::string, PhaseStatistics>;
+
+	/// Where a phase runs.
+	struct Context
+	{
+		/// Profiler the phase is recorded by, or null if profiling is disabled.
+		Profiler* profiler = nullptr;
+		/// Fully qualified name of the contract the phase is run for, or empty.
+		std::string contract;
+		/// Name of the enclosing phase, or empty.
+		std::string phase;
+	};
+
+	/// @returns the context of the current thread.
+	static Context const& current();
+	/// @returns the context of the current thread, changed to run phases for @a _contract.
+	static Context contractContext(std::string const& _contract);
+
+	/// Adds a call to the statistics of @a _phase.
+	void record(
+		std::string const& _contract,
+		std::string const& _phase,
+		double _seconds,
+		int64_t _peakAllocation,
+		size_t _blocks = 0,
+		size_t _changedBlocks = 0
+	);
+
+	/// @returns the statistics of the phases that do not belong to a contract.
+	Phases phases() const;
+	/// @returns the statistics of the phases run for contracts by contract name.
+	std::map<std::string, Phases> contractPhases() const;
+
+	/// Number of bytes allocated by a thread and not yet freed, also by other threads.
+	using AllocationCounter = std::atomic<int64_t>;
+
+	/// Counts an allocation of @a _bytes by the current thread. Called by the replaced global
+	/// allocation functions of executables that report peak allocations.
+	/// @returns the counter of the current thread, which is passed to @a deallocated when the
+	/// memory is freed, possibly by another thread. Counters are never destroyed.
+	static AllocationCounter* allocated(size_t _bytes);
+	static void deallocated(AllocationCounter* _counter, size_t _bytes);
+	/// @returns true while a profiler is active on any thread. Only then allocations are counted.
+	static bool active() { return s_activations.load(std::memory_order_relaxed) > 0; }
+	/// Marks that allocations are counted. Peak allocations are reported as zero otherwise.
+	static void enableAllocationCounting();
+	static bool countsAllocations();
+
+private:
+	friend class ProfilerActivation;
+
+	/// Number of existing activations of profilers.
+	static std::atomic<size_t> s_activations;
+
+	mutable std::mutex m_mutex;
+	std::map<std::string, Phases> m_phases;
+};
+
+/**
+ * Makes a profiler context the context of the current thread for the lifetime of the object.
+ */
+class ProfilerActivation: boost::noncopyable
+{
+public:
+	explicit ProfilerActivation(Profiler::Context _context);
+	/// Activates @a _profiler for phases that do not belong to a contract.
+	explicit ProfilerActivation(Profiler& _profiler);
+	~ProfilerActivation();
+
+private:
+	void activate(Profiler::Context _context);
+
+	Profiler::Context m_previous;
+	/// True if the activated context has a profiler.
+	bool m_active = false;
+};
+
+/**
+ * Measures the phase @a _phase, nested in the phase of the current context, from construction
+ * to destruction and records it with the active profiler, if any.
+ */
+class ProfilerScope: boost::noncopyable
+{
+public:
+	explicit ProfilerScope(char const* _phase);
+	~ProfilerScope();
+
+	/// Reports that the phase looked at @a _blocks blocks of code, of which it changed @a _changed.
+	void countBlocks(size_t _blocks, size_t _changed);
+
+private:
+	Profiler* m_profiler = nullptr;
+	size_t m_blocks = 0;
+	size_t m_changedBlocks = 0;
+	std::string m_enclosingPhase;
+	std::chrono::steady_clock::time_point m_start;
+	int64_t m_allocatedAtStart = 0;
+	int64_t m_enclosingPeak = 0;
+};
+
+}
@@ -0,0 +1,194 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ThreadPool.cpp
+ */
+
+#include <libdevcore/ThreadPool.h>
+
+#include <libdevcore/Profiler.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+
+ThreadPool::ThreadPool(size_t _threads)
+{
+	for (size_t i = 0; i < max<size_t>(_threads, 1); ++i)
+		m_workers.emplace_back([this]() { work(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_stopping = true;
+		m_tasks.clear();
+	}
+	m_taskAvailable.notify_all();
+	for (thread& worker: m_workers)
+		worker.join();
+}
+
+void ThreadPool::enqueue(function<void()> _task)
+{
+	_task = inProfilerContext(move(_task));
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if (m_exception)
+			return;
+		m_tasks.push_back(Task{move(_task), true});
+		++m_outstanding;
+	}
+	m_taskAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	unique_lock<mutex> lock(m_mutex);
+	m_allDone.wait(lock, [this]() { return m_outstanding == 0; });
+	if (m_exception)
+	{
+		exception_ptr exception = m_exception;
+		m_exception = nullptr;
+		rethrow_exception(exception);
+	}
+}
+
+void ThreadPool::parallelFor(size_t _count, function<void(size_t)> const& _task)
+{
+	if (_count <= 1)
+	{
+		for (size_t i = 0; i < _count; ++i)
+			_task(i);
+		return;
+	}
+
+	// Protected by m_mutex.
+	size_t remaining = _count;
+	exception_ptr exception;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		for (size_t i = 0; i < _count; ++i)
+		{
+			// These tasks do not throw, so they do not affect the exception reported by wait.
+			m_tasks.push_back(Task{inProfilerContext([&, i]()
+			{
+				exception_ptr taskException;
+				try
+				{
+					_task(i);
+				}
+				catch (...)
+				{
+					taskException = current_exception();
+				}
+				lock_guard<mutex> lock(m_mutex);
+				if (taskException && !exception)
+					exception = taskException;
+				--remaining;
+			}), false});
+			++m_outstanding;
+		}
+	}
+	m_taskAvailable.notify_all();
+
+	unique_lock<mutex> lock(m_mutex);
+	while (remaining > 0)
+		if (!m_tasks.empty())
+			runTask(lock);
+		else
+			m_taskFinished.wait(lock);
+	if (exception)
+		rethrow_exception(exception);
+}
+
+size_t ThreadPool::hardwareConcurrency()
+{
+	return max<size_t>(thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::work()
+{
+	unique_lock<mutex> lock(m_mutex);
+	while (true)
+	{
+		m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+		if (m_stopping)
+			return;
+		runTask(lock);
+	}
+}
+
+void ThreadPool::runTask(unique_lock<mutex>& _lock)
+{
+	function<void()> task = move(m_tasks.front().run);
+	m_tasks.pop_front();
+	_lock.unlock();
+
+	exception_ptr exception;
+	try
+	{
+		task();
+	}
+	catch (...)
+	{
+		exception = current_exception();
+	}
+
+	_lock.lock();
+	if (exception && !m_exception)
+	{
+		m_exception = exception;
+		// Do not start any further work once a task has failed, except for tasks that
+		// a call to parallelFor waits for.
+		auto discarded = remove_if(m_tasks.begin(), m_tasks.end(), [](Task const& _task) { return _task.discardable; });
+		m_outstanding -= size_t(m_tasks.end() - discarded);
+		m_tasks.erase(discarded, m_tasks.end());
+	}
+	if (--m_outstanding == 0)
+		m_allDone.notify_all();
+	m_taskFinished.notify_all();
+}
+
+function<void()> ThreadPool::inProfilerContext(function<void()> _task)
+{
+	// Tasks are profiled as part of the phase that enqueued them.
+	if (!Profiler::current().profiler)
+		return _task;
+	Profiler::Context context = Profiler::current();
+	return [context, _task]()
+	{
+		ProfilerActivation activation(context);
+		_task();
+	};
+}
+
+void dev::parallelFor(size_t _jobs, size_t _count, function<void(size_t)> const& _task)
+{
+	if (_jobs <= 1 || _count <= 1)
+	{
+		for (size_t i = 0; i < _count; ++i)
+			_task(i);
+		return;
+	}
+
+	ThreadPool pool(min(_jobs, _count));
+	for (size_t i = 0; i < _count; ++i)
+		pool.enqueue([&_task, i]() { _task(i); });
+	pool.wait();
+}
@@ -0,0 +1,100 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ThreadPool.h
+ * Fixed-size pool of worker threads used to run independent compilation jobs.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+
+/**
+ * Pool of worker threads executing queued tasks in FIFO order.
+ * Tasks may enqueue further tasks. The first exception thrown by any task is
+ * stored and re-thrown by @a wait, after all remaining tasks have been discarded.
+ * Tasks run in the profiler context of the thread that enqueued them.
+ */
+class ThreadPool: boost::noncopyable
+{
+public:
+	/// Creates a pool with @a _threads worker threads (at least one).
+	explicit ThreadPool(size_t _threads);
+	/// Discards all pending tasks and joins the worker threads.
+	~ThreadPool();
+
+	/// Queues @a _task for execution on one of the worker threads.
+	void enqueue(std::function<void()> _task);
+
+	/// Blocks until all queued and running tasks have finished.
+	/// Re-throws the first exception thrown by a task, if any.
+	void wait();
+
+	/// Runs @a _task(i) for every i in [0, _count) on the workers and blocks until all of them
+	/// have finished. The calling thread runs queued tasks while it waits, such that tasks of
+	/// this pool can call this function as well. Re-throws the first exception thrown by any
+	/// invocation, independently of @a wait.
+	void parallelFor(size_t _count, std::function<void(size_t)> const& _task);
+
+	/// @returns the number of worker threads.
+	size_t size() const { return m_workers.size(); }
+
+	/// @returns the number of concurrent threads supported by the hardware, but at least one.
+	static size_t hardwareConcurrency();
+
+private:
+	void work();
+	/// Runs the first queued task, unlocking @a _lock in the meantime.
+	void runTask(std::unique_lock<std::mutex>& _lock);
+	/// @returns @a _task wrapped such that it runs in the profiler context of the calling thread.
+	static std::function<void()> inProfilerContext(std::function<void()> _task);
+
+	struct Task
+	{
+		std::function<void()> run;
+		/// False for the tasks of parallelFor, which are not discarded once a task has failed.
+		bool discardable;
+	};
+
+	std::vector<std::thread> m_workers;
+	std::deque<Task> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_taskAvailable;
+	std::condition_variable m_allDone;
+	std::condition_variable m_taskFinished;
+	/// Number of tasks that are queued or currently running.
+	size_t m_outstanding = 0;
+	std::exception_ptr m_exception;
+	bool m_stopping = false;
+};
+
+/// Runs @a _task(i) for every i in [0, _count) using up to @a _jobs threads.
+/// Runs sequentially in the calling thread if @a _jobs or @a _count is at most one.
+/// Re-throws the first exception thrown by any invocation.
+void parallelFor(size_t _jobs, size_t _count, std::function<void(size_t)> const& _task);
+
+}
@@ -28,8 +28,14 @@
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/SemanticInformation.h>
+
+#include <libdevcore/Profiler.h>
+#include <libdevcore/ThreadPool.h>
 
 #include <fstream>
+#include <limits>
+#include <unordered_set>
 #include <json/json.h>
 
 using namespace std;
@@ -70,6 +76,14 @@ void Assembly::append(Assembly const& _a)
 		m_libraries.insert(lib);
 }
 
+AssemblyPointer Assembly::deepCopy() const
+{
+	AssemblyPointer copy = make_shared<Assembly>(*this);
+	for (AssemblyPointer& sub: copy->m_subs)
+		sub = sub->deepCopy();
+	return copy;
+}
+
 void Assembly::append(Assembly const& _a, int _deposit)
 {
 	assertThrow(_deposit <= _a.m_deposit, InvalidDeposit, "");
@@ -84,6 +98,7 @@ AssemblyItem const& Assembly::append(AssemblyItem const& _i)
 	assertThrow(m_deposit >= 0, AssemblyException, "Stack underflow.");
 	m_deposit += _i.deposit();
 	m_items.push_back(_i);
+	m_items.back().setWideDataArena(*m_wideDataArena);
 	if (m_items.back().location().isEmpty() && !m_currentSourceLocation.isEmpty())
 		m_items.back().setLocation(m_currentSourceLocation);
 	return back();
@@ -92,6 +107,7 @@ AssemblyItem const& Assembly::append(AssemblyItem const& _i)
 void Assembly::injectStart(AssemblyItem const& _i)
 {
 	m_items.insert(m_items.begin(), _i);
+	m_items.front().setWideDataArena(*m_wideDataArena);
 }
 
 unsigned Assembly::bytesRequired(unsigned subTagSize) const
@@ -363,7 +379,14 @@ AssemblyItem Assembly::newPushLibraryAddress(string const& _identifier)
 	return AssemblyItem(PushLibraryAddress, h);
 }
 
-Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation, size_t _runs)
+Assembly& Assembly::optimise(
+	bool _enable,
+	EVMVersion _evmVersion,
+	bool _isCreation,
+	size_t _runs,
+	OptimisedAssemblyCache* _cache,
+	size_t _jobs
+)
 {
 	OptimiserSettings settings;
 	settings.isCreation = _isCreation;
@@ -377,6 +400,8 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 	}
 	settings.evmVersion = _evmVersion;
 	settings.expectedExecutionsPerDeployment = _runs;
+	settings.cache = _cache;
+	settings.jobs = _jobs;
 	optimise(settings);
 	return *this;
 }
@@ -384,30 +409,145 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 
 Assembly& Assembly::optimise(OptimiserSettings const& _settings)
 {
-	optimiseInternal(_settings, {});
+	// The calling thread takes part in the work while it waits for the pool.
+	unique_ptr<ThreadPool> pool;
+	if (_settings.jobs > 1)
+		pool.reset(new ThreadPool(_settings.jobs - 1));
+	optimiseInternal(_settings, {}, pool.get());
 	return *this;
 }
 
+map<u256, u256> Assembly::optimiseSub(
+	size_t _subId,
+	OptimiserSettings const& _settings,
+	set<size_t> const& _tagsReferencedFromOutside,
+	ThreadPool* _pool
+)
+{
+	if (!_settings.cache)
+		return m_subs[_subId]->optimiseInternal(_settings, _tagsReferencedFromOutside, _pool);
+
+	// Identical sub-assemblies, e.g. of a contract created by several contracts, are only
+	// optimised once. The cached assembly is copied, since the copy can still be modified.
+	h256 key = subAssemblyCacheKey(*m_subs[_subId], _settings, _tagsReferencedFromOutside);
+	if (auto entry = _settings.cache->lookup(key))
+	{
+		m_subs[_subId] = entry->assembly->deepCopy();
+		return entry->tagReplacements;
+	}
+	map<u256, u256> tagReplacements = m_subs[_subId]->optimiseInternal(_settings, _tagsReferencedFromOutside, _pool);
+	auto newEntry = make_shared<OptimisedAssemblyCache::Entry>();
+	newEntry->assembly = m_subs[_subId]->deepCopy();
+	newEntry->tagReplacements = tagReplacements;
+	_settings.cache->store(key, newEntry);
+	return tagReplacements;
+}
+
+namespace
+{
+
+/// Serialisation of the parts of an assembly that are hashed by Assembly::structuralHash
+/// and of chunks of items that are compared by the common subexpression eliminator.
+class StructureWriter
+{
+public:
+	void number(uint64_t _value)
+	{
+		for (unsigned i = 0; i < 8; ++i)
+			m_data.push_back(char(_value >> (8 * i)));
+	}
+	void number(u256 const& _value)
+	{
+		// Most numbers in assemblies are small, so they avoid the conversion to bytes.
+		if (_value <= numeric_limits<uint64_t>::max())
+		{
+			m_data.push_back(0);
+			number(uint64_t(_value));
+		}
+		else
+		{
+			m_data.push_back(1);
+			hash(h256(_value));
+		}
+	}
+	void text(std::string const& _value)
+	{
+		number(uint64_t(_value.size()));
+		m_data += _value;
+	}
+	void byte(uint8_t _value) { m_data.push_back(char(_value)); }
+	void hash(h256 const& _value) { m_data.append(reinterpret_cast<char const*>(_value.data()), h256::size); }
+	void item(AssemblyItem const& _item)
+	{
+		byte(uint8_t(_item.type()));
+		if (_item.type() == Operation)
+			byte(uint8_t(_item.instruction()));
+		else
+			number(_item.data());
+		byte(uint8_t(_item.getJumpType()));
+		// Source locations are part of the assembly output and the source mappings.
+		SourceLocation const& location = _item.location();
+		number(uint64_t(uint32_t(location.start)));
+		number(uint64_t(uint32_t(location.end)));
+		text(location.source ? location.source->name() : string());
+		if (_item.pushedValue())
+			number(*_item.pushedValue());
+	}
+
+	std::string const& data() const { return m_data; }
+	h256 finish() const { return keccak256(m_data); }
+
+private:
+	std::string m_data;
+};
+
+/// Below this number of items, starting threads for the common subexpression eliminator
+/// costs more than it saves.
+size_t const c_minItemsForParallelCSE = 1000;
+
+/// Runs @a _task(i) for every i in [0, _count) on @a _pool, or sequentially if it is null.
+void runOnPool(ThreadPool* _pool, size_t _count, function<void(size_t)> const& _task)
+{
+	if (_pool)
+		_pool->parallelFor(_count, _task);
+	else
+		for (size_t i = 0; i < _count; ++i)
+			_task(i);
+}
+
+}
+
 map<u256, u256> Assembly::optimiseInternal(
 	OptimiserSettings const& _settings,
-	std::set<size_t> const& _tagsReferencedFromOutside
+	std::set<size_t> const& _tagsReferencedFromOutside,
+	ThreadPool* _pool
 )
 {
-	// Run optimisation for sub-assemblies.
+	// Wide constants created by the optimiser are stored together with the other ones of this assembly.
+	WideDataArena::Scope arenaScope(*m_wideDataArena);
+
+	// Run optimisation for sub-assemblies. They are independent of each other, so they are
+	// optimised concurrently and their tag replacements are applied afterwards in order.
+	OptimiserSettings settings = _settings;
+	// Disable creation mode for sub-assemblies.
+	settings.isCreation = false;
+	vector<set<size_t>> referencedTags;
 	for (size_t subId = 0; subId < m_subs.size(); ++subId)
+		referencedTags.push_back(JumpdestRemover::referencedTags(m_items, subId));
+	vector<map<u256, u256>> subTagReplacements(m_subs.size());
+	runOnPool(_pool, m_subs.size(), [&](size_t _subId)
 	{
-		OptimiserSettings settings = _settings;
-		// Disable creation mode for sub-assemblies.
-		settings.isCreation = false;
-		map<u256, u256> subTagReplacements = m_subs[subId]->optimiseInternal(
-			settings,
-			JumpdestRemover::referencedTags(m_items, subId)
-		);
+		subTagReplacements[_subId] = optimiseSub(_subId, settings, referencedTags[_subId], _pool);
+	});
+	for (size_t subId = 0; subId < m_subs.size(); ++subId)
 		// Apply the replacements (can be empty).
-		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements, subId);
-	}
+		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements[subId], subId);
 
 	map<u256, u256> tagReplacements;
+	// Chunks of items that the common subexpression eliminator did not shorten. The result of the
+	// eliminator only depends on the items of a chunk, so these are skipped in later iterations
+	// unless another step changes them.
+	unordered_set<string> unchangedChunks;
 	// Iterate until no new optimisation possibilities are found.
 	for (unsigned count = 1; count > 0;)
 	{
@@ -415,6 +555,7 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runJumpdestRemover)
 		{
+			ProfilerScope profilerScope("JumpdestRemover");
 			JumpdestRemover jumpdestOpt(m_items);
 			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
 				count++;
@@ -422,6 +563,7 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runPeephole)
 		{
+			ProfilerScope profilerScope("PeepholeOptimiser");
 			PeepholeOptimiser peepOpt(m_items);
 			while (peepOpt.optimise())
 			{
@@ -433,6 +575,7 @@ map<u256, u256> Assembly::optimiseInternal(
 		// This only modifies PushTags, we have to run again to actually remove code.
 		if (_settings.runDeduplicate)
 		{
+			ProfilerScope profilerScope("BlockDeduplicator");
 			BlockDeduplicator dedup(m_items);
 			if (dedup.deduplicate())
 			{
@@ -443,6 +586,7 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runCSE)
 		{
+			ProfilerScope profilerScope("CommonSubexpressionEliminator");
 			// Control flow graph optimization has been here before but is disabled because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
@@ -450,19 +594,40 @@ map<u256, u256> Assembly::optimiseInternal(
 
 			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem(Instruction::MSIZE)) != m_items.end());
 
-			auto iter = m_items.begin();
-			while (iter != m_items.end())
+			// Every chunk ends after an item that breaks the analysis, so the chunks are
+			// independent and can be optimised concurrently.
+			vector<size_t> chunkStarts;
+			for (size_t i = 0; i < m_items.size(); ++i)
+				if (i == 0 || SemanticInformation::breaksCSEAnalysisBlock(m_items[i - 1], usesMSize))
+					chunkStarts.push_back(i);
+			chunkStarts.push_back(m_items.size());
+
+			size_t const chunkCount = chunkStarts.size() - 1;
+			// Only set for the chunks that are replaced.
+			vector<boost::optional<AssemblyItems>> optimisedChunks(chunkCount);
+			// Only set for the chunks that are not skipped.
+			vector<string> chunkKeys(chunkCount);
+			runOnPool(m_items.size() >= c_minItemsForParallelCSE ? _pool : nullptr, chunkCount, [&](size_t _chunk)
 			{
+				WideDataArena::Scope chunkArenaScope(*m_wideDataArena);
+				auto begin = m_items.cbegin() + chunkStarts[_chunk];
+				auto end = m_items.cbegin() + chunkStarts[_chunk + 1];
+				StructureWriter key;
+				key.byte(usesMSize);
+				for (auto it = begin; it != end; ++it)
+					key.item(*it);
+				if (unchangedChunks.count(key.data()))
+					return;
+				chunkKeys[_chunk] = key.data();
+
 				KnownState emptyState;
 				CommonSubexpressionEliminator eliminator(emptyState);
-				auto orig = iter;
-				iter = eliminator.feedItems(iter, m_items.end(), usesMSize);
-				bool shouldReplace = false;
-				AssemblyItems optimisedChunk;
+				assertThrow(eliminator.feedItems(begin, end, usesMSize) == end, OptimizerException, "");
 				try
 				{
-					optimisedChunk = eliminator.getOptimizedItems();
-					shouldReplace = (optimisedChunk.size() < size_t(iter - orig));
+					AssemblyItems optimisedChunk = eliminator.getOptimizedItems();
+					if (optimisedChunk.size() < size_t(end - begin))
+						optimisedChunks[_chunk] = move(optimisedChunk);
 				}
 				catch (StackTooDeepException const&)
 				{
@@ -474,15 +639,32 @@ map<u256, u256> Assembly::optimiseInternal(
 					// This might happen if e.g. associativity and commutativity rules
 					// reorganise the expression tree, but not all leaves are available.
 				}
+			});
 
-				if (shouldReplace)
+			size_t visitedChunks = 0;
+			size_t replacedChunks = 0;
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				if (!chunkKeys[chunk].empty())
+					visitedChunks++;
+				if (optimisedChunks[chunk])
 				{
 					count++;
-					optimisedItems += optimisedChunk;
+					replacedChunks++;
+					optimisedItems += *optimisedChunks[chunk];
 				}
 				else
-					copy(orig, iter, back_inserter(optimisedItems));
+				{
+					if (!chunkKeys[chunk].empty())
+						unchangedChunks.insert(move(chunkKeys[chunk]));
+					copy(
+						m_items.begin() + chunkStarts[chunk],
+						m_items.begin() + chunkStarts[chunk + 1],
+						back_inserter(optimisedItems)
+					);
+				}
 			}
+			profilerScope.countBlocks(visitedChunks, replacedChunks);
 			if (optimisedItems.size() < m_items.size())
 			{
 				m_items = move(optimisedItems);
@@ -492,6 +674,8 @@ map<u256, u256> Assembly::optimiseInternal(
 	}
 
 	if (_settings.runConstantOptimiser)
+	{
+		ProfilerScope profilerScope("ConstantOptimiser");
 		ConstantOptimisationMethod::optimiseConstants(
 			_settings.isCreation,
 			_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
@@ -499,10 +683,60 @@ map<u256, u256> Assembly::optimiseInternal(
 			*this,
 			m_items
 		);
+	}
 
 	return tagReplacements;
 }
 
+h256 Assembly::structuralHash() const
+{
+	StructureWriter writer;
+	for (AssemblyItem const& item: m_items)
+		writer.item(item);
+	writer.number(uint64_t(m_usedTags));
+	for (auto const& namedTag: m_namedTags)
+	{
+		writer.text(namedTag.first);
+		writer.number(uint64_t(namedTag.second));
+	}
+	for (auto const& item: m_data)
+	{
+		writer.hash(item.first);
+		writer.text(asString(item.second));
+	}
+	writer.text(asString(m_auxiliaryData));
+	for (auto const& item: m_strings)
+		writer.text(item.second);
+	for (auto const& item: m_libraries)
+		writer.text(item.second);
+	for (auto const& sub: m_subs)
+		writer.hash(sub->structuralHash());
+	// Sub-assemblies of compiled contracts are already assembled.
+	writer.hash(keccak256(m_assembledObject.bytecode));
+	return writer.finish();
+}
+
+h256 Assembly::subAssemblyCacheKey(
+	Assembly const& _sub,
+	OptimiserSettings const& _settings,
+	set<size_t> const& _tagsReferencedFromOutside
+)
+{
+	StructureWriter writer;
+	writer.hash(_sub.structuralHash());
+	writer.byte(_settings.isCreation);
+	writer.byte(_settings.runJumpdestRemover);
+	writer.byte(_settings.runPeephole);
+	writer.byte(_settings.runDeduplicate);
+	writer.byte(_settings.runCSE);
+	writer.byte(_settings.runConstantOptimiser);
+	writer.text(_settings.evmVersion.name());
+	writer.number(uint64_t(_settings.expectedExecutionsPerDeployment));
+	for (size_t tag: _tagsReferencedFromOutside)
+		writer.number(uint64_t(tag));
+	return writer.finish();
+}
+
 LinkerObject const& Assembly::assemble() const
 {
 	if (!m_assembledObject.bytecode.empty())
@@ -22,6 +22,7 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/LinkerObject.h>
 #include <libevmasm/Exceptions.h>
+#include <libevmasm/OptimisedAssemblyCache.h>
 
 #include <liblangutil/EVMVersion.h>
 
@@ -37,6 +38,8 @@
 
 namespace dev
 {
+class ThreadPool;
+
 namespace eth
 {
 
@@ -56,6 +59,9 @@ public:
 	AssemblyItem newSub(AssemblyPointer const& _sub) { m_subs.push_back(_sub); return AssemblyItem(PushSub, m_subs.size() - 1); }
 	Assembly const& sub(size_t _sub) const { return *m_subs.at(_sub); }
 	Assembly& sub(size_t _sub) { return *m_subs.at(_sub); }
+	/// @returns a copy of this assembly that does not share any (nested) sub-assemblies with
+	/// the original, so that optimising the copy cannot modify the original.
+	AssemblyPointer deepCopy() const;
 	AssemblyItem newPushSubSize(u256 const& _subId) { return AssemblyItem(PushSubSize, _subId); }
 	AssemblyItem newPushLibraryAddress(std::string const& _identifier);
 
@@ -110,6 +116,11 @@ public:
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
 		/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 		size_t expectedExecutionsPerDeployment = 200;
+		/// If set, optimised sub-assemblies are taken from and stored in this cache.
+		OptimisedAssemblyCache* cache = nullptr;
+		/// Number of threads used to optimise sub-assemblies and to run the common subexpression
+		/// eliminator on independent chunks of the code. Does not influence the result.
+		size_t jobs = 1;
 	};
 
 	/// Execute optimisation passes as defined by @a _settings and return the optimised assembly.
@@ -120,7 +131,20 @@ public:
 	/// @a _runs specifes an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime.
 	/// If @a _enable is not set, will perform some simple peephole optimizations.
-	Assembly& optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation = true, size_t _runs = 200);
+	/// Optimised sub-assemblies are shared via @a _cache if it is given.
+	/// @a _jobs is the number of threads used by the common subexpression eliminator.
+	Assembly& optimise(
+		bool _enable,
+		EVMVersion _evmVersion,
+		bool _isCreation = true,
+		size_t _runs = 200,
+		OptimisedAssemblyCache* _cache = nullptr,
+		size_t _jobs = 1
+	);
+
+	/// @returns a hash of the items, data and (recursively) sub-assemblies, which is equal for
+	/// assemblies that are optimised and assembled identically.
+	h256 structuralHash() const;
 
 	/// Create a text representation of the assembly.
 	std::string assemblyString(
@@ -153,10 +177,30 @@ protected:
 	/// Does the same operations as @a optimise, but should only be applied to a sub and
 	/// returns the replaced tags. Also takes an argument containing the tags of this assembly
 	/// that are referenced in a super-assembly.
-	std::map<u256, u256> optimiseInternal(OptimiserSettings const& _settings, std::set<size_t> const& _tagsReferencedFromOutside);
+	/// Independent parts are optimised on @a _pool, if given.
+	std::map<u256, u256> optimiseInternal(
+		OptimiserSettings const& _settings,
+		std::set<size_t> const& _tagsReferencedFromOutside,
+		ThreadPool* _pool
+	);
+	/// Optimises the sub-assembly @a _subId, or takes it from the cache of @a _settings, and
+	/// returns its replaced tags. Does not modify this assembly apart from the sub-assembly.
+	std::map<u256, u256> optimiseSub(
+		size_t _subId,
+		OptimiserSettings const& _settings,
+		std::set<size_t> const& _tagsReferencedFromOutside,
+		ThreadPool* _pool
+	);
 
 	unsigned bytesRequired(unsigned subTagSize) const;
 
+	/// @returns the key of the optimised @a _sub in the cache of optimised sub-assemblies.
+	static h256 subAssemblyCacheKey(
+		Assembly const& _sub,
+		OptimiserSettings const& _settings,
+		std::set<size_t> const& _tagsReferencedFromOutside
+	);
+
 private:
 	static Json::Value createJsonValue(std::string _name, int _begin, int _end, std::string _value = std::string(), std::string _jumpType = std::string());
 	static std::string toStringInHex(u256 _value);
@@ -172,6 +216,9 @@ protected:
 	std::vector<std::shared_ptr<Assembly>> m_subs;
 	std::map<h256, std::string> m_strings;
 	std::map<h256, std::string> m_libraries; ///< Identifiers of libraries to be linked.
+	/// Storage for the wide data of the items, which point into it without owning it.
+	/// Shared with copies of the assembly, since they copy the items.
+	std::shared_ptr<WideDataArena> m_wideDataArena = std::make_shared<WideDataArena>();
 
 	mutable LinkerObject m_assembledObject;
 	mutable std::vector<size_t> m_tagPositionsInBytecode;
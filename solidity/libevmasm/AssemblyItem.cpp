@@ -27,6 +27,54 @@ using namespace dev;
 using namespace dev::eth;
 
 static_assert(sizeof(size_t) <= 8, "size_t must be at most 64-bits wide");
+static_assert(alignof(u256) > 1, "The lowest bit of pointers to wide data is used as a flag.");
+
+namespace
+{
+thread_local WideDataArena* t_currentArena = nullptr;
+}
+
+WideDataArena::Scope::Scope(WideDataArena& _arena):
+	m_previous(t_currentArena)
+{
+	t_currentArena = &_arena;
+}
+
+WideDataArena::Scope::~Scope()
+{
+	t_currentArena = m_previous;
+}
+
+u256 const* WideDataArena::intern(u256 const& _value)
+{
+	// Wide values are mostly hashes of data and library names, tags of sub-assemblies and
+	// constants, so there are few distinct ones per assembly.
+	lock_guard<mutex> lock(m_mutex);
+	return &*m_values.insert(_value).first;
+}
+
+WideDataArena* WideDataArena::current()
+{
+	return t_currentArena;
+}
+
+WideData::WideData(u256 const& _value)
+{
+	if (WideDataArena* arena = WideDataArena::current())
+		m_pointer = reinterpret_cast<uintptr_t>(arena->intern(_value));
+	else
+		// Items created outside of an assembly, e.g. by the code generator before they are
+		// appended, own their data.
+		m_pointer = own(_value);
+}
+
+void WideData::moveTo(WideDataArena& _arena)
+{
+	u256 const* value = _arena.intern(**this);
+	// Releases an owned copy.
+	*this = WideData();
+	m_pointer = reinterpret_cast<uintptr_t>(value);
+}
 
 AssemblyItem AssemblyItem::toSubAssemblyTag(size_t _subId) const
 {
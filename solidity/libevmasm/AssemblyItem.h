@@ -28,6 +28,12 @@
 #include <libevmasm/Instruction.h>
 #include <liblangutil/SourceLocation.h>
 #include "Exceptions.h"
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
 using namespace dev::solidity;
 
 namespace dev
@@ -35,7 +41,7 @@ namespace dev
 namespace eth
 {
 
-enum AssemblyItemType {
+enum AssemblyItemType: uint8_t {
 	UndefinedItem,
 	Operation,
 	Push,
@@ -52,10 +58,68 @@ enum AssemblyItemType {
 
 class Assembly;
 
+/**
+ * Storage for the data of assembly items that does not fit into 64 bits. Equal values are
+ * stored only once. Every assembly owns an arena, which outlives the items of the assembly.
+ */
+class WideDataArena
+{
+public:
+	/// Makes new items with wide data that are created by the current thread store it in
+	/// @a _arena for the lifetime of the scope. These items must not outlive the arena.
+	class Scope
+	{
+	public:
+		explicit Scope(WideDataArena& _arena);
+		~Scope();
+	private:
+		WideDataArena* m_previous;
+	};
+
+	/// @returns the address at which @a _value is stored for the lifetime of the arena.
+	u256 const* intern(u256 const& _value);
+	/// @returns the arena of the innermost scope of the current thread, or nullptr.
+	static WideDataArena* current();
+
+private:
+	std::mutex m_mutex;
+	std::set<u256> m_values;
+};
+
+/**
+ * Pointer to the data of an assembly item that does not fit into 64 bits. Points into an arena
+ * without owning it, or owns a copy of the value if the item was created outside of an arena
+ * scope. Only copies of owned values allocate. The lowest bit of the pointer marks owned values.
+ */
+class WideData
+{
+public:
+	WideData() = default;
+	/// Stores @a _value in the arena of the current scope or, outside of any scope, in a copy.
+	explicit WideData(u256 const& _value);
+	WideData(WideData const& _other): m_pointer(_other.owned() ? own(*_other) : _other.m_pointer) {}
+	WideData(WideData&& _other) noexcept: m_pointer(_other.m_pointer) { _other.m_pointer = 0; }
+	WideData& operator=(WideData _other) noexcept { std::swap(m_pointer, _other.m_pointer); return *this; }
+	~WideData() { if (owned()) delete get(); }
+
+	/// Stores the value in @a _arena, such that it no longer owns a copy.
+	void moveTo(WideDataArena& _arena);
+
+	u256 const* get() const { return reinterpret_cast<u256 const*>(m_pointer & ~uintptr_t(1)); }
+	u256 const& operator*() const { return *get(); }
+	explicit operator bool() const { return m_pointer != 0; }
+
+private:
+	bool owned() const { return m_pointer & 1; }
+	static uintptr_t own(u256 const& _value) { return reinterpret_cast<uintptr_t>(new u256(_value)) | 1; }
+
+	uintptr_t m_pointer = 0;
+};
+
 class AssemblyItem
 {
 public:
-	enum class JumpType { Ordinary, IntoFunction, OutOfFunction };
+	enum class JumpType: uint8_t { Ordinary, IntoFunction, OutOfFunction };
 
 	AssemblyItem(u256 _push, langutil::SourceLocation const& _location = langutil::SourceLocation()):
 		AssemblyItem(Push, _push, _location) { }
@@ -71,7 +135,7 @@ public:
 		if (m_type == Operation)
 			m_instruction = Instruction(uint8_t(_data));
 		else
-			m_data = std::make_shared<u256>(_data);
+			setData(_data);
 	}
 
 	AssemblyItem tag() const { assertThrow(m_type == PushTag || m_type == Tag, Exception, ""); return AssemblyItem(Tag, data()); }
@@ -86,8 +150,28 @@ public:
 	void setPushTagSubIdAndTag(size_t _subId, size_t _tag);
 
 	AssemblyItemType type() const { return m_type; }
-	u256 const& data() const { assertThrow(m_type != Operation, Exception, ""); return *m_data; }
-	void setData(u256 const& _data) { assertThrow(m_type != Operation, Exception, ""); m_data = std::make_shared<u256>(_data); }
+	u256 data() const
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		return m_wideData ? *m_wideData : u256(m_narrowData);
+	}
+	void setData(u256 const& _data)
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		if (_data <= std::numeric_limits<uint64_t>::max())
+		{
+			m_narrowData = uint64_t(_data);
+			m_wideData = WideData();
+		}
+		else
+			m_wideData = WideData(_data);
+	}
+	/// Stores wide data in @a _arena. Called for items that are added to the assembly owning @a _arena.
+	void setWideDataArena(WideDataArena& _arena)
+	{
+		if (m_wideData)
+			m_wideData.moveTo(_arena);
+	}
 
 	/// @returns the instruction of this item (only valid if type() == Operation)
 	Instruction instruction() const { assertThrow(m_type == Operation, Exception, ""); return m_instruction; }
@@ -99,10 +183,31 @@ public:
 			return false;
 		if (type() == Operation)
 			return instruction() == _other.instruction();
+		else if (m_wideData && _other.m_wideData)
+			// Equal values of the same arena are stored at the same address, values of different
+			// arenas or owned copies have to be compared.
+			return m_wideData.get() == _other.m_wideData.get() || *m_wideData == *_other.m_wideData;
+		else if (m_wideData || _other.m_wideData)
+			return false;
 		else
-			return data() == _other.data();
+			return m_narrowData == _other.m_narrowData;
 	}
 	bool operator!=(AssemblyItem const& _other) const { return !operator==(_other); }
+	/// @returns a hash value compatible with operator==.
+	size_t hash() const
+	{
+		size_t seed = size_t(type());
+		if (type() == Operation)
+			boost::hash_combine(seed, size_t(instruction()));
+		else if (m_wideData)
+		{
+			u256 const& data = *m_wideData;
+			boost::hash_range(seed, data.backend().limbs(), data.backend().limbs() + data.backend().size());
+		}
+		else
+			boost::hash_combine(seed, m_narrowData);
+		return seed;
+	}
 	/// Less-than operator compatible with operator==.
 	bool operator<(AssemblyItem const& _other) const
 	{
@@ -110,8 +215,13 @@ public:
 			return type() < _other.type();
 		else if (type() == Operation)
 			return instruction() < _other.instruction();
+		else if (!m_wideData && !_other.m_wideData)
+			return m_narrowData < _other.m_narrowData;
+		else if (!m_wideData || !_other.m_wideData)
+			// Narrow data is always smaller than wide data.
+			return !m_wideData;
 		else
-			return data() < _other.data();
+			return *m_wideData < *_other.m_wideData;
 	}
 
 	/// @returns an upper bound for the number of bytes required by this item, assuming that
@@ -131,20 +241,34 @@ public:
 	JumpType getJumpType() const { return m_jumpType; }
 	std::string getJumpTypeAsString() const;
 
-	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256>(_value); }
-	u256 const* pushedValue() const { return m_pushedValue.get(); }
+	void setPushedValue(u256 const& _value) const
+	{
+		assertThrow(_value <= std::numeric_limits<uint64_t>::max(), Exception, "Pushed value too large.");
+		m_pushedValue = uint64_t(_value);
+		m_hasPushedValue = true;
+	}
+	boost::optional<u256> pushedValue() const
+	{
+		return m_hasPushedValue ? boost::optional<u256>(m_pushedValue) : boost::none;
+	}
 
 	std::string toAssemblyText() const;
 
 private:
+	// The members are ordered and sized such that items are small and copying them does not
+	// allocate, since the optimiser copies blocks of items frequently.
 	AssemblyItemType m_type;
 	Instruction m_instruction; ///< Only valid if m_type == Operation
-	std::shared_ptr<u256> m_data; ///< Only valid if m_type != Operation
-	langutil::SourceLocation m_location;
 	JumpType m_jumpType = JumpType::Ordinary;
+	mutable bool m_hasPushedValue = false;
+	/// The data if m_type != Operation and it fits into 64 bits.
+	uint64_t m_narrowData = 0;
+	/// The data if m_type != Operation and it does not fit into 64 bits, empty otherwise.
+	WideData m_wideData;
 	/// Pushed value for operations with data to be determined during assembly stage,
 	/// e.g. PushSubSize, PushTag, PushSub, etc.
-	mutable std::shared_ptr<u256> m_pushedValue;
+	mutable uint64_t m_pushedValue = 0;
+	langutil::SourceLocation m_location;
 };
 
 using AssemblyItems = std::vector<AssemblyItem>;
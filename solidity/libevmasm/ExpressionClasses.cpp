@@ -36,23 +36,14 @@ using namespace dev;
 using namespace dev::eth;
 using namespace langutil;
 
-bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression const& _other) const
+bool ExpressionClasses::Expression::operator==(ExpressionClasses::Expression const& _other) const
 {
 	assertThrow(!!item && !!_other.item, OptimizerException, "");
-	auto type = item->type();
-	auto otherType = _other.item->type();
-	if (type != otherType)
-		return type < otherType;
-	else if (type == Operation)
-	{
-		auto instr = item->instruction();
-		auto otherInstr = _other.item->instruction();
-		return std::tie(instr, arguments, sequenceNumber) <
-			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
-	}
-	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+	return
+		hash == _other.hash &&
+		*item == *_other.item &&
+		sequenceNumber == _other.sequenceNumber &&
+		arguments == _other.arguments;
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
@@ -70,6 +61,7 @@ ExpressionClasses::Id ExpressionClasses::find(
 
 	if (SemanticInformation::isCommutativeOperation(_item))
 		sort(exp.arguments.begin(), exp.arguments.end());
+	exp.hash = structuralHash(exp);
 
 	if (SemanticInformation::isDeterministic(_item))
 	{
@@ -107,6 +99,7 @@ void ExpressionClasses::forceEqual(
 
 	if (SemanticInformation::isCommutativeOperation(_item))
 		sort(exp.arguments.begin(), exp.arguments.end());
+	exp.hash = structuralHash(exp);
 
 	if (_copyItem)
 		exp.item = storeItem(_item);
@@ -119,6 +112,7 @@ ExpressionClasses::Id ExpressionClasses::newClass(SourceLocation const& _locatio
 	Expression exp;
 	exp.id = m_representatives.size();
 	exp.item = storeItem(AssemblyItem(UndefinedItem, (u256(1) << 255) + exp.id, _location));
+	exp.hash = structuralHash(exp);
 	m_representatives.push_back(exp);
 	m_expressions.insert(exp);
 	return exp.id;
@@ -133,7 +127,7 @@ bool ExpressionClasses::knownToBeDifferent(ExpressionClasses::Id _a, ExpressionC
 bool ExpressionClasses::knownToBeDifferentBy32(ExpressionClasses::Id _a, ExpressionClasses::Id _b)
 {
 	// Try to simplify "_a - _b" and return true iff the value is at least 32 away from zero.
-	u256 const* v = knownConstant(find(Instruction::SUB, {_a, _b}));
+	boost::optional<u256> v = knownConstant(find(Instruction::SUB, {_a, _b}));
 	// forbidden interval is ["-31", 31]
 	return v && *v + 31 > u256(62);
 }
@@ -148,20 +142,20 @@ bool ExpressionClasses::knownNonZero(Id _c)
 	return Pattern(u256(0)).matches(representative(find(Instruction::ISZERO, {_c})), *this);
 }
 
-u256 const* ExpressionClasses::knownConstant(Id _c)
+boost::optional<u256> ExpressionClasses::knownConstant(Id _c)
 {
 	map<unsigned, Expression const*> matchGroups;
 	Pattern constant(Push);
 	constant.setMatchGroup(1, matchGroups);
 	if (!constant.matches(representative(_c), *this))
-		return nullptr;
-	return &constant.d();
+		return boost::none;
+	return constant.d();
 }
 
 AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
 {
-	m_spareAssemblyItems.push_back(make_shared<AssemblyItem>(_item));
-	return m_spareAssemblyItems.back().get();
+	m_spareAssemblyItems.push_back(_item);
+	return &m_spareAssemblyItems.back();
 }
 
 string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
@@ -183,7 +177,8 @@ string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 
 ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr)
 {
-	static Rules rules;
+	// The rules keep the state of the current match, so every thread needs its own copy.
+	static thread_local Rules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
 	if (
@@ -209,6 +204,14 @@ ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr)
 	return -1;
 }
 
+size_t ExpressionClasses::structuralHash(Expression const& _expression)
+{
+	size_t seed = _expression.item->hash();
+	boost::hash_combine(seed, _expression.sequenceNumber);
+	boost::hash_range(seed, _expression.arguments.begin(), _expression.arguments.end());
+	return seed;
+}
+
 ExpressionClasses::Id ExpressionClasses::rebuildExpression(ExpressionTemplate const& _template)
 {
 	if (_template.hasId)
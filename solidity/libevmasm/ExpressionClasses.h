@@ -26,10 +26,14 @@
 #include <libdevcore/Common.h>
 #include <libevmasm/AssemblyItem.h>
 
+#include <boost/optional.hpp>
+
+#include <deque>
 #include <vector>
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_set>
 
 namespace langutil
 {
@@ -61,8 +65,10 @@ public:
 		Ids arguments;
 		/// Storage modification sequence, only used for storage and memory operations.
 		unsigned sequenceNumber = 0;
+		/// Hash of (item->type(), item->data(), arguments, sequenceNumber), set by ExpressionClasses.
+		size_t hash = 0;
 		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
-		bool operator<(Expression const& _other) const;
+		bool operator==(Expression const& _other) const;
 	};
 
 	/// Retrieves the id of the expression equivalence class resulting from the given item applied to the
@@ -100,9 +106,8 @@ public:
 	/// @returns true if the value of the given class is known to be nonzero.
 	/// @note that this is not the negation of knownZero
 	bool knownNonZero(Id _c);
-	/// @returns a pointer to the value if the given class is known to be a constant,
-	/// and a nullptr otherwise.
-	u256 const* knownConstant(Id _c);
+	/// @returns the value if the given class is known to be a constant.
+	boost::optional<u256> knownConstant(Id _c);
 
 	/// Stores a copy of the given AssemblyItem and returns a pointer to the copy that is valid for
 	/// the lifetime of the ExpressionClasses object.
@@ -120,11 +125,19 @@ private:
 
 	std::vector<std::pair<Pattern, std::function<Pattern()>>> createRules() const;
 
+	struct ExpressionHash
+	{
+		size_t operator()(Expression const& _expression) const { return _expression.hash; }
+	};
+	/// @returns the hash of the item, arguments and sequence number of @a _expression.
+	static size_t structuralHash(Expression const& _expression);
+
 	/// Expression equivalence class representatives - we only store one item of an equivalence.
 	std::vector<Expression> m_representatives;
-	/// All expression ever encountered.
-	std::set<Expression> m_expressions;
-	std::vector<std::shared_ptr<AssemblyItem>> m_spareAssemblyItems;
+	/// All expression ever encountered, hash-consed by their structure.
+	std::unordered_set<Expression, ExpressionHash> m_expressions;
+	/// Copies of assembly items, a deque keeps references stable while it grows.
+	std::deque<AssemblyItem> m_spareAssemblyItems;
 };
 
 }
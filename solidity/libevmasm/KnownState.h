@@ -36,6 +36,7 @@
 #endif // defined(__clang__)
 
 #include <boost/bimap.hpp>
+#include <boost/container/flat_map.hpp>
 
 #if defined(__clang__)
 #pragma clang diagnostic pop
@@ -71,6 +72,10 @@ class KnownState
 {
 public:
 	using Id = ExpressionClasses::Id;
+	/// Sorted vectors, which are iterated in the same order as std::map, but are cheaper to copy
+	/// and to search for the few elements they usually contain.
+	using StackElements = boost::container::flat_map<int, Id>;
+	using StoredValues = boost::container::flat_map<Id, Id>;
 	struct StoreOperation
 	{
 		enum Target { Invalid, Memory, Storage };
@@ -138,10 +143,10 @@ public:
 	void clearTagUnions();
 
 	int stackHeight() const { return m_stackHeight; }
-	std::map<int, Id> const& stackElements() const { return m_stackElements; }
+	StackElements const& stackElements() const { return m_stackElements; }
 	ExpressionClasses& expressionClasses() const { return *m_expressionClasses; }
 
-	std::map<Id, Id> const& storageContent() const { return m_storageContent; }
+	StoredValues const& storageContent() const { return m_storageContent; }
 
 private:
 	/// Assigns a new equivalence class to the next sequence number of the given stack element.
@@ -170,14 +175,14 @@ private:
 	/// Current stack height, can be negative.
 	int m_stackHeight = 0;
 	/// Current stack layout, mapping stack height -> equivalence class
-	std::map<int, Id> m_stackElements;
+	StackElements m_stackElements;
 	/// Current sequence number, this is incremented with each modification to storage or memory.
 	unsigned m_sequenceNumber = 1;
 	/// Knowledge about storage content.
-	std::map<Id, Id> m_storageContent;
+	StoredValues m_storageContent;
 	/// Knowledge about memory content. Keys are memory addresses, note that the values overlap
 	/// and are not contained here if they are not completely known.
-	std::map<Id, Id> m_memoryContent;
+	StoredValues m_memoryContent;
 	/// Keeps record of all Keccak-256 hashes that are computed.
 	std::map<std::vector<Id>, Id> m_knownKeccak256Hashes;
 	/// Structure containing the classes of equivalent expressions.
@@ -0,0 +1,52 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of optimised sub-assemblies shared by the assemblies of one compilation.
+ */
+
+#include <libevmasm/OptimisedAssemblyCache.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+shared_ptr<OptimisedAssemblyCache::Entry const> OptimisedAssemblyCache::lookup(h256 const& _key)
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_entries.find(_key);
+	if (it == m_entries.end())
+	{
+		++m_misses;
+		return nullptr;
+	}
+	++m_hits;
+	return it->second;
+}
+
+void OptimisedAssemblyCache::store(h256 const& _key, shared_ptr<Entry const> _entry)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_entries.insert(make_pair(_key, move(_entry)));
+}
+
+void OptimisedAssemblyCache::clear()
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_entries.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
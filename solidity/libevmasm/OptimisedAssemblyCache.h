@@ -0,0 +1,72 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of optimised sub-assemblies shared by the assemblies of one compilation.
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Common.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace dev
+{
+namespace eth
+{
+
+class Assembly;
+
+/**
+ * Thread-safe cache of optimised sub-assemblies, keyed by the structural hash of the
+ * unoptimised sub-assembly, the optimiser settings and the tags referenced from outside.
+ * A contract that is created by several contracts is embedded as sub-assembly into each of
+ * them and is only optimised once if they share a cache.
+ */
+class OptimisedAssemblyCache: boost::noncopyable
+{
+public:
+	struct Entry
+	{
+		std::shared_ptr<Assembly const> assembly;
+		std::map<u256, u256> tagReplacements;
+	};
+
+	/// @returns the entry stored for @a _key or nullptr if there is none.
+	std::shared_ptr<Entry const> lookup(h256 const& _key);
+	/// Stores @a _entry for @a _key unless an entry is already present.
+	void store(h256 const& _key, std::shared_ptr<Entry const> _entry);
+	/// Removes all entries.
+	void clear();
+
+	size_t hits() const { return m_hits; }
+	size_t misses() const { return m_misses; }
+
+private:
+	std::mutex m_mutex;
+	std::map<h256, std::shared_ptr<Entry const>> m_entries;
+	size_t m_hits = 0;
+	size_t m_misses = 0;
+};
+
+}
+}
@@ -0,0 +1,176 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Decision tree over the patterns of simplification rules.
+ */
+
+#pragma once
+
+#include <libevmasm/Instruction.h>
+#include <libdevcore/Common.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Description of a node of a pattern or an expression: an operation, a leaf of a certain type
+ * (e.g. a constant) or, in patterns, a wildcard that matches any expression.
+ */
+struct RuleTreeSymbol
+{
+	enum class Kind { Any, Operation, Leaf };
+	Kind kind = Kind::Any;
+	/// The instruction of an operation or the type of a leaf.
+	unsigned code = 0;
+	/// The value a leaf of a pattern has to have, nullptr if any value matches.
+	u256 const* value = nullptr;
+};
+
+/**
+ * Decision tree built from the patterns of a list of simplification rules. Every pattern is
+ * flattened in pre-order and inserted into a trie, so finding the rules whose patterns can match an
+ * expression takes time proportional to the size of the patterns instead of the number of rules.
+ *
+ * The tree only considers the shape of expressions. Match groups that require several
+ * sub-expressions to be equal still have to be checked by the patterns themselves.
+ *
+ * The pattern type has to provide `RuleTreeSymbol ruleTreeSymbol() const` and `arguments()`.
+ */
+template <class Pattern>
+class SimplificationRuleTree
+{
+public:
+	/// Adds the pattern of the rule with the given index.
+	void addRule(size_t _index, Pattern const& _pattern)
+	{
+		Node* node = &m_root;
+		std::vector<Pattern> pending{_pattern};
+		while (!pending.empty())
+		{
+			Pattern pattern = std::move(pending.back());
+			pending.pop_back();
+			RuleTreeSymbol symbol = pattern.ruleTreeSymbol();
+			if (symbol.kind == RuleTreeSymbol::Kind::Any)
+				node = child(node->any);
+			else if (symbol.kind == RuleTreeSymbol::Kind::Leaf && !symbol.value)
+				node = child(node->anyValueLeaves[symbol.code]);
+			else if (symbol.kind == RuleTreeSymbol::Kind::Leaf)
+				node = child(node->leaves[std::make_pair(symbol.code, *symbol.value)]);
+			else
+			{
+				node = child(node->operations[symbol.code]);
+				std::vector<Pattern> arguments = pattern.arguments();
+				// Operations without argument patterns match any arguments.
+				if (arguments.empty())
+					arguments.resize(instructionInfo(Instruction(symbol.code)).args);
+				pending.insert(pending.end(), arguments.rbegin(), arguments.rend());
+			}
+		}
+		node->rules.push_back(_index);
+	}
+
+	/// @returns the sorted indices of the rules whose patterns match the shape of @a _expression.
+	/// The adapter has to provide `RuleTreeSymbol symbol(Expression const&)`, `u256 value(Expression const&)`
+	/// for leaves and `void pushArguments(Expression const&, std::vector<Expression const*>&)`, which
+	/// appends the arguments of an operation in reverse order.
+	template <class Expression, class Adapter>
+	std::vector<size_t> candidates(Expression const& _expression, Adapter const& _adapter) const
+	{
+		std::vector<size_t> indices;
+		std::vector<Expression const*> pending{&_expression};
+		collect(m_root, pending, _adapter, indices);
+		std::sort(indices.begin(), indices.end());
+		return indices;
+	}
+
+private:
+	struct Node
+	{
+		/// Indices of the rules whose patterns end at this node.
+		std::vector<size_t> rules;
+		std::unique_ptr<Node> any;
+		std::map<unsigned, std::unique_ptr<Node>> operations;
+		std::map<unsigned, std::unique_ptr<Node>> anyValueLeaves;
+		std::map<std::pair<unsigned, u256>, std::unique_ptr<Node>> leaves;
+	};
+
+	static Node* child(std::unique_ptr<Node>& _child)
+	{
+		if (!_child)
+			_child.reset(new Node);
+		return _child.get();
+	}
+
+	/// Visits all paths from @a _node that match the expressions in @a _pending, of which the
+	/// last one is visited first, and adds the rules at their ends to @a _indices.
+	template <class Expression, class Adapter>
+	static void collect(
+		Node const& _node,
+		std::vector<Expression const*>& _pending,
+		Adapter const& _adapter,
+		std::vector<size_t>& _indices
+	)
+	{
+		if (_pending.empty())
+		{
+			_indices.insert(_indices.end(), _node.rules.begin(), _node.rules.end());
+			return;
+		}
+		Expression const* expression = _pending.back();
+		_pending.pop_back();
+		if (_node.any)
+			collect(*_node.any, _pending, _adapter, _indices);
+		RuleTreeSymbol symbol = _adapter.symbol(*expression);
+		if (symbol.kind == RuleTreeSymbol::Kind::Operation)
+		{
+			auto it = _node.operations.find(symbol.code);
+			if (it != _node.operations.end())
+			{
+				size_t size = _pending.size();
+				_adapter.pushArguments(*expression, _pending);
+				collect(*it->second, _pending, _adapter, _indices);
+				_pending.resize(size);
+			}
+		}
+		else if (symbol.kind == RuleTreeSymbol::Kind::Leaf)
+		{
+			auto it = _node.anyValueLeaves.find(symbol.code);
+			if (it != _node.anyValueLeaves.end())
+				collect(*it->second, _pending, _adapter, _indices);
+			if (!_node.leaves.empty())
+			{
+				auto leaf = _node.leaves.find(std::make_pair(symbol.code, _adapter.value(*expression)));
+				if (leaf != _node.leaves.end())
+					collect(*leaf->second, _pending, _adapter, _indices);
+			}
+		}
+		_pending.push_back(expression);
+	}
+
+	Node m_root;
+};
+
+}
+}
@@ -40,26 +40,53 @@ using namespace dev;
 using namespace dev::eth;
 using namespace langutil;
 
+namespace
+{
+
+/// Describes the expressions of the common subexpression eliminator for the rule decision tree.
+struct RuleTreeAdapter
+{
+	using Expression = ExpressionClasses::Expression;
+
+	RuleTreeSymbol symbol(Expression const& _expr) const
+	{
+		RuleTreeSymbol symbol;
+		if (!_expr.item)
+			return symbol;
+		symbol.kind = _expr.item->type() == Operation ? RuleTreeSymbol::Kind::Operation : RuleTreeSymbol::Kind::Leaf;
+		symbol.code = _expr.item->type() == Operation ? unsigned(_expr.item->instruction()) : unsigned(_expr.item->type());
+		return symbol;
+	}
+	u256 value(Expression const& _expr) const { return _expr.item->data(); }
+	void pushArguments(Expression const& _expr, vector<Expression const*>& _pending) const
+	{
+		for (auto it = _expr.arguments.rbegin(); it != _expr.arguments.rend(); ++it)
+			_pending.push_back(&classes.representative(*it));
+	}
+
+	ExpressionClasses const& classes;
+};
+
+}
+
 SimplificationRule<Pattern> const* Rules::findFirstMatch(
 	Expression const& _expr,
 	ExpressionClasses const& _classes
 )
 {
-	resetMatchGroups();
-
 	assertThrow(_expr.item, OptimizerException, "");
-	for (auto const& rule: m_rules[uint8_t(_expr.item->instruction())])
+	for (size_t index: m_tree.candidates(_expr, RuleTreeAdapter{_classes}))
 	{
-		if (rule.pattern.matches(_expr, _classes))
-			return &rule;
 		resetMatchGroups();
+		if (m_rules[index].pattern.matches(_expr, _classes))
+			return &m_rules[index];
 	}
 	return nullptr;
 }
 
 bool Rules::isInitialized() const
 {
-	return !m_rules[uint8_t(Instruction::ADD)].empty();
+	return !m_rules.empty();
 }
 
 void Rules::addRules(std::vector<SimplificationRule<Pattern>> const& _rules)
@@ -70,7 +97,9 @@ void Rules::addRules(std::vector<SimplificationRule<Pattern>> const& _rules)
 
 void Rules::addRule(SimplificationRule<Pattern> const& _rule)
 {
-	m_rules[uint8_t(_rule.pattern.instruction())].push_back(_rule);
+	assertThrow(_rule.pattern.type() == Operation, OptimizerException, "Rule does not start with an operation.");
+	m_tree.addRule(m_rules.size(), _rule.pattern);
+	m_rules.push_back(_rule);
 }
 
 Rules::Rules()
@@ -124,6 +153,24 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 	return true;
 }
 
+RuleTreeSymbol Pattern::ruleTreeSymbol() const
+{
+	RuleTreeSymbol symbol;
+	if (m_type == Operation)
+	{
+		symbol.kind = RuleTreeSymbol::Kind::Operation;
+		symbol.code = unsigned(m_instruction);
+	}
+	else if (m_type != UndefinedItem)
+	{
+		symbol.kind = RuleTreeSymbol::Kind::Leaf;
+		symbol.code = unsigned(m_type);
+		if (m_requireDataMatch)
+			symbol.value = &data();
+	}
+	return symbol;
+}
+
 AssemblyItem Pattern::toAssemblyItem(SourceLocation const& _location) const
 {
 	if (m_type == Operation)
@@ -25,6 +25,7 @@
 
 #include <libevmasm/ExpressionClasses.h>
 #include <libevmasm/SimplificationRule.h>
+#include <libevmasm/SimplificationRuleTree.h>
 
 #include <boost/noncopyable.hpp>
 
@@ -73,7 +74,9 @@ private:
 	std::map<unsigned, Expression const*> m_matchGroups;
 	/// Pattern to match, replacement to be applied and flag indicating whether
 	/// the replacement might remove some elements (except constants).
-	std::vector<SimplificationRule<Pattern>> m_rules[256];
+	std::vector<SimplificationRule<Pattern>> m_rules;
+	/// Decision tree over the patterns of m_rules.
+	SimplificationRuleTree<Pattern> m_tree;
 };
 
 /**
@@ -101,6 +104,8 @@ public:
 	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(Expression const& _expr, ExpressionClasses const& _classes) const;
+	/// @returns the description of this pattern for the rule decision tree.
+	RuleTreeSymbol ruleTreeSymbol() const;
 
 	AssemblyItem toAssemblyItem(langutil::SourceLocation const& _location) const;
 	std::vector<Pattern> arguments() const { return m_arguments; }
@@ -108,7 +113,7 @@ public:
 	/// @returns the id of the matched expression if this pattern is part of a match group.
 	Id id() const { return matchGroupValue().id; }
 	/// @returns the data of the matched expression if this pattern is part of a match group.
-	u256 const& d() const { return matchGroupValue().item->data(); }
+	u256 d() const { return matchGroupValue().item->data(); }
 
 	std::string toString() const;
 
@@ -86,6 +86,13 @@ void ErrorReporter::error(Error::Type _type, SourceLocation const& _location, Se
 	m_errorList.push_back(err);
 }
 
+void ErrorReporter::append(ErrorList const& _errors)
+{
+	for (auto const& error: _errors)
+		if (!checkForExcessiveErrors(error->type()))
+			m_errorList.push_back(error);
+}
+
 bool ErrorReporter::checkForExcessiveErrors(Error::Type _type)
 {
 	if (_type == Error::Type::Warning)
@@ -84,6 +84,10 @@ public:
 
 	void docstringParsingError(std::string const& _description);
 
+	/// Appends errors collected by a different reporter, e.g. by an analysis pass run on
+	/// another thread. Applies the same limits on the number of warnings and errors.
+	void append(ErrorList const& _errors);
+
 	ErrorList const& errors() const;
 
 	void clear();
@@ -18,17 +18,45 @@
 #include <libsolidity/analysis/ControlFlowGraph.h>
 #include <libsolidity/analysis/ControlFlowBuilder.h>
 
+#include <libdevcore/ThreadPool.h>
+
 #include <boost/range/adaptor/reversed.hpp>
 
 #include <algorithm>
+#include <iterator>
 
 using namespace std;
 using namespace langutil;
 using namespace dev::solidity;
 
-bool CFG::constructFlow(ASTNode const& _astRoot)
+bool CFG::constructFlow(vector<ASTNode const*> const& _astRoots, size_t _jobs)
 {
-	_astRoot.accept(*this);
+	for (ASTNode const* astRoot: _astRoots)
+		astRoot->accept(*this);
+
+	vector<NodeContainer> nodeContainers(m_functions.size() + m_modifiers.size());
+	vector<unique_ptr<FunctionFlow>> functionFlows(m_functions.size());
+	vector<unique_ptr<ModifierFlow>> modifierFlows(m_modifiers.size());
+	parallelFor(_jobs, nodeContainers.size(), [&](size_t _i)
+	{
+		if (_i < m_functions.size())
+			functionFlows[_i] = ControlFlowBuilder::createFunctionFlow(nodeContainers[_i], *m_functions[_i]);
+		else
+		{
+			size_t index = _i - m_functions.size();
+			modifierFlows[index] = ControlFlowBuilder::createModifierFlow(nodeContainers[_i], *m_modifiers[index]);
+		}
+	});
+
+	for (NodeContainer& nodeContainer: nodeContainers)
+		m_nodeContainer.append(move(nodeContainer));
+	for (size_t i = 0; i < m_functions.size(); ++i)
+		m_functionControlFlow[m_functions[i]] = move(functionFlows[i]);
+	for (size_t i = 0; i < m_modifiers.size(); ++i)
+		m_modifierControlFlow[m_modifiers[i]] = move(modifierFlows[i]);
+	m_functions.clear();
+	m_modifiers.clear();
+
 	applyModifiers();
 	return Error::containsOnlyWarnings(m_errorReporter.errors());
 }
@@ -36,13 +64,13 @@ bool CFG::constructFlow(ASTNode const& _astRoot)
 
 bool CFG::visit(ModifierDefinition const& _modifier)
 {
-	m_modifierControlFlow[&_modifier] = ControlFlowBuilder::createModifierFlow(m_nodeContainer, _modifier);
+	m_modifiers.push_back(&_modifier);
 	return false;
 }
 
 bool CFG::visit(FunctionDefinition const& _function)
 {
-	m_functionControlFlow[&_function] = ControlFlowBuilder::createFunctionFlow(m_nodeContainer, _function);
+	m_functions.push_back(&_function);
 	return false;
 }
 
@@ -58,6 +86,12 @@ CFGNode* CFG::NodeContainer::newNode()
 	return m_nodes.back().get();
 }
 
+void CFG::NodeContainer::append(NodeContainer&& _other)
+{
+	move(_other.m_nodes.begin(), _other.m_nodes.end(), back_inserter(m_nodes));
+	_other.m_nodes.clear();
+}
+
 void CFG::applyModifiers()
 {
 	for (auto const& function: m_functionControlFlow)
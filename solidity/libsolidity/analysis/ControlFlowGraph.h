@@ -103,7 +103,10 @@ class CFG: private ASTConstVisitor
 public:
 	explicit CFG(langutil::ErrorReporter& _errorReporter): m_errorReporter(_errorReporter) {}
 
-	bool constructFlow(ASTNode const& _astRoot);
+	/// Constructs the control flow of all functions and modifiers below @a _astRoots and
+	/// applies the modifiers afterwards. The flows of the individual functions and modifiers
+	/// are independent and are constructed using up to @a _jobs threads.
+	bool constructFlow(std::vector<ASTNode const*> const& _astRoots, size_t _jobs = 1);
 
 	bool visit(ModifierDefinition const& _modifier) override;
 	bool visit(FunctionDefinition const& _function) override;
@@ -114,6 +117,8 @@ public:
 	{
 	public:
 		CFGNode* newNode();
+		/// Takes over all nodes of @a _other.
+		void append(NodeContainer&& _other);
 	private:
 		std::vector<std::unique_ptr<CFGNode>> m_nodes;
 	};
@@ -140,6 +145,10 @@ private:
 	/// are owned by the CFG class and stored in this container.
 	NodeContainer m_nodeContainer;
 
+	/// Functions and modifiers found while visiting the AST, in the order they were visited.
+	std::vector<FunctionDefinition const*> m_functions;
+	std::vector<ModifierDefinition const*> m_modifiers;
+
 	std::map<FunctionDefinition const*, std::unique_ptr<FunctionFlow>> m_functionControlFlow;
 	std::map<ModifierDefinition const*, std::unique_ptr<ModifierFlow>> m_modifierControlFlow;
 };
@@ -35,6 +35,8 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
+/// Counts the IDs per thread, so that compilations on different threads do not interfere.
+/// All nodes of a compilation are created by the thread that parses and analyses it.
 class IDDispenser
 {
 public:
@@ -43,7 +45,7 @@ public:
 private:
 	static size_t& instance()
 	{
-		static IDDispenser dispenser;
+		static thread_local IDDispenser dispenser;
 		return dispenser.id;
 	}
 	size_t id = 0;
@@ -71,7 +71,7 @@ public:
 
 	/// @returns an identifier of this AST node that is unique for a single compilation run.
 	size_t id() const { return m_id; }
-	/// Resets the global ID counter. This invalidates all previous IDs.
+	/// Resets the ID counter of the current thread. This invalidates all previous IDs of the thread.
 	static void resetID();
 
 	virtual void accept(ASTVisitor& _visitor) = 0;
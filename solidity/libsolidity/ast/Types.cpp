@@ -42,6 +42,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <limits>
+#include <mutex>
 
 using namespace std;
 using namespace dev;
@@ -387,8 +388,32 @@ TypePointer Type::commonType(TypePointer const& _a, TypePointer const& _b)
 		return TypePointer();
 }
 
+namespace
+{
+
+/// Guards the member list caches of the types of the compilation analysed by the current thread,
+/// if its sources are analysed concurrently. Types referenced from several sources are shared
+/// between these sources.
+thread_local recursive_mutex* t_membersMutex = nullptr;
+
+}
+
+MemberCacheLockScope::MemberCacheLockScope(recursive_mutex& _mutex):
+	m_previous(t_membersMutex)
+{
+	t_membersMutex = &_mutex;
+}
+
+MemberCacheLockScope::~MemberCacheLockScope()
+{
+	t_membersMutex = m_previous;
+}
+
 MemberList const& Type::members(ContractDefinition const* _currentScope) const
 {
+	unique_lock<recursive_mutex> lock;
+	if (t_membersMutex)
+		lock = unique_lock<recursive_mutex>(*t_membersMutex);
 	if (!m_members[_currentScope])
 	{
 		MemberList::MemberMap members = nativeMembers(_currentScope);
@@ -35,6 +35,7 @@
 #include <boost/optional.hpp>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <map>
 #include <set>
@@ -141,6 +142,21 @@ private:
 
 static_assert(std::is_nothrow_move_constructible<MemberList>::value, "MemberList should be noexcept move constructible");
 
+/**
+ * Makes Type::members on the current thread lock @a _mutex for the lifetime of the object.
+ * Used while the sources of a compilation are analysed concurrently, since they share the
+ * member list caches of their types. Without a scope, the caches are not locked.
+ */
+class MemberCacheLockScope: private boost::noncopyable
+{
+public:
+	explicit MemberCacheLockScope(std::recursive_mutex& _mutex);
+	~MemberCacheLockScope();
+
+private:
+	std::recursive_mutex* m_previous;
+};
+
 /**
  * Abstract base class that forms the root of the type hierarchy.
  */
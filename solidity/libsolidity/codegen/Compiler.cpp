@@ -23,6 +23,7 @@
 #include <libsolidity/codegen/Compiler.h>
 #include <libevmasm/Assembly.h>
 #include <libsolidity/codegen/ContractCompiler.h>
+#include <libdevcore/Profiler.h>
 
 using namespace std;
 using namespace dev;
@@ -34,6 +35,17 @@ void Compiler::compileContract(
 	bytes const& _metadata
 )
 {
+	generateCode(_contract, _contracts, _metadata);
+	optimise();
+}
+
+void Compiler::generateCode(
+	ContractDefinition const& _contract,
+	std::map<const ContractDefinition*, eth::Assembly const*> const& _contracts,
+	bytes const& _metadata
+)
+{
+	ProfilerScope profilerScope("ContractCompiler");
 	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimize);
 	runtimeCompiler.compileContract(_contract, _contracts);
 	m_runtimeContext.appendAuxiliaryData(_metadata);
@@ -42,8 +54,11 @@ void Compiler::compileContract(
 	// creation time.
 	ContractCompiler creationCompiler(&runtimeCompiler, m_context, m_optimize);
 	m_runtimeSub = creationCompiler.compileConstructor(_contract, _contracts);
+}
 
-	m_context.optimise(m_optimize, m_optimizeRuns);
+void Compiler::optimise(eth::OptimisedAssemblyCache* _cache, size_t _jobs)
+{
+	m_context.optimise(m_optimize, m_optimizeRuns, _cache, _jobs);
 }
 
 eth::AssemblyItem Compiler::functionEntryLabel(FunctionDefinition const& _function) const
@@ -43,13 +43,25 @@ public:
 		m_context(_evmVersion, &m_runtimeContext)
 	{ }
 
-	/// Compiles a contract.
+	/// Compiles a contract and runs the optimiser.
 	/// @arg _metadata contains the to be injected metadata CBOR
 	void compileContract(
 		ContractDefinition const& _contract,
 		std::map<ContractDefinition const*, eth::Assembly const*> const& _contracts,
 		bytes const& _metadata
 	);
+	/// Generates the code for a contract without running the optimiser.
+	/// This is the only step that accesses the AST.
+	/// @arg _metadata contains the to be injected metadata CBOR
+	void generateCode(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _contracts,
+		bytes const& _metadata
+	);
+	/// Runs the assembly optimiser on the code generated by @a generateCode.
+	/// Optimised sub-assemblies are shared with other contracts via @a _cache if it is given.
+	/// The optimiser uses up to @a _jobs threads.
+	void optimise(eth::OptimisedAssemblyCache* _cache = nullptr, size_t _jobs = 1);
 	/// @returns Entire assembly.
 	eth::Assembly const& assembly() const { return m_context.assembly(); }
 	/// @returns The entire assembled object (with constructor).
@@ -221,8 +221,17 @@ public:
 	/// Appends arbitrary data to the end of the bytecode.
 	void appendAuxiliaryData(bytes const& _data) { m_asm->appendAuxiliaryDataToEnd(_data); }
 
-	/// Run optimisation step.
-	void optimise(bool _fullOptimsation, unsigned _runs = 200) { m_asm->optimise(_fullOptimsation, m_evmVersion, true, _runs); }
+	/// Run optimisation step, sharing optimised sub-assemblies via @a _cache if it is given and
+	/// using up to @a _jobs threads.
+	void optimise(
+		bool _fullOptimsation,
+		unsigned _runs = 200,
+		eth::OptimisedAssemblyCache* _cache = nullptr,
+		size_t _jobs = 1
+	)
+	{
+		m_asm->optimise(_fullOptimsation, m_evmVersion, true, _runs, _cache, _jobs);
+	}
 
 	/// @returns the runtime context if in creation mode and runtime context is set, nullptr otherwise.
 	CompilerContext* runtimeContext() { return m_runtimeContext; }
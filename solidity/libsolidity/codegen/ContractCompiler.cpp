@@ -31,6 +31,8 @@
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
 
+#include <libdevcore/Profiler.h>
+
 #include <boost/range/adaptor/reversed.hpp>
 
 #include <algorithm>
@@ -955,6 +957,7 @@ void ContractCompiler::appendStackVariableInitialisation(VariableDeclaration con
 
 void ContractCompiler::compileExpression(Expression const& _expression, TypePointer const& _targetType)
 {
+	ProfilerScope profilerScope("ExpressionCompiler");
 	ExpressionCompiler expressionCompiler(m_context, m_optimise);
 	expressionCompiler.compile(_expression);
 	if (_targetType)
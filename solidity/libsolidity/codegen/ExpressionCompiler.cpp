@@ -602,7 +602,9 @@ bool ExpressionCompiler::visit(FunctionCall const& _functionCall)
 					eth::Assembly const& assembly = _context.compiledContract(*contract);
 					CompilerUtils(_context).fetchFreeMemoryPointer();
 					// pushes size
-					auto subroutine = _context.addSubroutine(make_shared<eth::Assembly>(assembly));
+					// The creating contract optimises its copy again, which must not modify
+					// the sub-assemblies of the already compiled contract.
+					auto subroutine = _context.addSubroutine(assembly.deepCopy());
 					_context << Instruction::DUP1 << subroutine;
 					_context << Instruction::DUP4 << Instruction::CODECOPY;
 					_context << Instruction::ADD;
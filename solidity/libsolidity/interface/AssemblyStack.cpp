@@ -36,6 +36,8 @@
 
 #include <libyul/optimiser/Suite.h>
 
+#include <libdevcore/Profiler.h>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
@@ -81,10 +83,10 @@ bool AssemblyStack::parseAndAnalyze(std::string const& _sourceName, std::string
 	return analyzeParsed();
 }
 
-void AssemblyStack::optimize()
+void AssemblyStack::optimize(vector<string> const& _steps, bool _perFunction, size_t _jobs)
 {
 	solAssert(m_language != Language::Assembly, "Optimization requested for loose assembly.");
-	yul::OptimiserSuite::run(*m_parserResult->code, *m_parserResult->analysisInfo);
+	yul::OptimiserSuite::run(*m_parserResult->code, *m_parserResult->analysisInfo, {}, _steps, _perFunction, _jobs);
 	solAssert(analyzeParsed(), "Invalid source code after optimization.");
 }
 
@@ -109,6 +111,7 @@ MachineAssemblyObject AssemblyStack::assemble(Machine _machine) const
 	{
 	case Machine::EVM:
 	{
+		ProfilerScope profilerScope("assembler");
 		MachineAssemblyObject object;
 		eth::Assembly assembly;
 		yul::CodeGenerator::assemble(*m_parserResult->code, *m_parserResult->analysisInfo, assembly);
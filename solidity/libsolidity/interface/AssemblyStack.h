@@ -26,11 +26,13 @@
 
 #include <libyul/Object.h>
 #include <libyul/ObjectParser.h>
+#include <libyul/optimiser/Suite.h>
 
 #include <libevmasm/LinkerObject.h>
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace langutil
 {
@@ -69,8 +71,14 @@ public:
 	/// Multiple calls overwrite the previous state.
 	bool parseAndAnalyze(std::string const& _sourceName, std::string const& _source);
 
-	/// Run the optimizer suite. Can only be used with Yul or strict assembly.
-	void optimize();
+	/// Run the optimizer suite, repeating the steps @a _steps. Can only be used with Yul or strict assembly.
+	/// If @a _perFunction is set, function-local steps are run on each function separately
+	/// using up to @a _jobs threads.
+	void optimize(
+		std::vector<std::string> const& _steps = yul::OptimiserSuite::defaultSteps(),
+		bool _perFunction = false,
+		size_t _jobs = 1
+	);
 
 	/// Run the assembly step (should only be called after parseAndAnalyze).
 	MachineAssemblyObject assemble(Machine _machine) const;
@@ -0,0 +1,208 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Persistent on-disk cache of compiler outputs.
+ */
+
+#include <libsolidity/interface/CompilationCache.h>
+#include <libsolidity/interface/Version.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+/// Writes @a _contents to @a _path such that concurrent readers never see a partially written file.
+void writeFileAtomically(fs::path const& _path, string const& _contents)
+{
+	fs::path temporaryPath = _path;
+	temporaryPath += fs::unique_path(".%%%%-%%%%-%%%%.tmp");
+	{
+		ofstream file(temporaryPath.string(), ios::binary);
+		file << _contents;
+		if (!file)
+		{
+			fs::remove(temporaryPath);
+			return;
+		}
+	}
+	fs::rename(temporaryPath, _path);
+}
+
+string hashOf(string const& _contents)
+{
+	return "0x" + toHex(keccak256(_contents).asBytes());
+}
+
+}
+
+CompilationCache::CompilationCache(fs::path const& _directory, uint64_t _sizeLimit):
+	m_directory(_directory),
+	m_sizeLimit(_sizeLimit)
+{
+	fs::create_directories(m_directory / "entries");
+}
+
+boost::optional<string> CompilationCache::lookup(string const& _input, ReadCallback::Callback const& _readFile)
+{
+	fs::path path = entryPath(key(_input));
+	Json::Value entry;
+	bool found = false;
+	try
+	{
+		found =
+			fs::exists(path) &&
+			jsonParseStrict(readFileAsString(path.string()), entry) &&
+			entry.isObject() &&
+			entry["output"].isString() &&
+			entry["files"].isObject();
+		if (found)
+			for (string const& file: entry["files"].getMemberNames())
+			{
+				ReadCallback::Result result = _readFile ? _readFile(file) : ReadCallback::Result{false, ""};
+				if (!result.success || hashOf(result.responseOrErrorMessage) != entry["files"][file].asString())
+				{
+					found = false;
+					break;
+				}
+			}
+		if (found)
+			// Marks the entry as recently used.
+			fs::last_write_time(path, time(nullptr));
+	}
+	catch (fs::filesystem_error const&)
+	{
+		// The entry might have been evicted concurrently.
+		found = false;
+	}
+
+	Statistics statistics;
+	if (found)
+		statistics.hits = 1;
+	else
+		statistics.misses = 1;
+	addToTotalStatistics(statistics);
+	if (!found)
+		return {};
+	return entry["output"].asString();
+}
+
+void CompilationCache::store(string const& _input, map<string, string> const& _readFiles, string const& _output)
+{
+	Json::Value entry(Json::objectValue);
+	entry["files"] = Json::objectValue;
+	for (auto const& file: _readFiles)
+		entry["files"][file.first] = hashOf(file.second);
+	entry["output"] = _output;
+	fs::path path = entryPath(key(_input));
+	writeFileAtomically(path, jsonCompactPrint(entry));
+
+	Statistics statistics;
+	statistics.stores = 1;
+	addToTotalStatistics(statistics);
+	evict(path);
+}
+
+CompilationCache::Statistics CompilationCache::totalStatistics() const
+{
+	Statistics statistics;
+	fs::path path = m_directory / "statistics.json";
+	Json::Value json;
+	if (fs::exists(path) && jsonParseStrict(readFileAsString(path.string()), json) && json.isObject())
+	{
+		statistics.hits = json["hits"].asUInt64();
+		statistics.misses = json["misses"].asUInt64();
+		statistics.stores = json["stores"].asUInt64();
+		statistics.evictions = json["evictions"].asUInt64();
+	}
+	return statistics;
+}
+
+h256 CompilationCache::key(string const& _input) const
+{
+	return keccak256(string(VersionString) + '\0' + _input);
+}
+
+fs::path CompilationCache::entryPath(h256 const& _key) const
+{
+	return m_directory / "entries" / (toHex(_key.asBytes()) + ".json");
+}
+
+void CompilationCache::evict(fs::path const& _keep)
+{
+	vector<tuple<time_t, uint64_t, fs::path>> entries;
+	uint64_t totalSize = 0;
+	for (fs::directory_entry const& file: fs::directory_iterator(m_directory / "entries"))
+	{
+		boost::system::error_code error;
+		time_t lastUse = fs::last_write_time(file.path(), error);
+		uint64_t size = fs::file_size(file.path(), error);
+		if (error || file.path().extension() != ".json")
+			continue;
+		entries.emplace_back(lastUse, size, file.path());
+		totalSize += size;
+	}
+
+	sort(entries.begin(), entries.end());
+	Statistics statistics;
+	for (auto const& entry: entries)
+	{
+		if (totalSize <= m_sizeLimit)
+			break;
+		if (get<2>(entry) == _keep)
+			continue;
+		boost::system::error_code error;
+		if (fs::remove(get<2>(entry), error))
+			statistics.evictions++;
+		totalSize -= get<1>(entry);
+	}
+	if (statistics.evictions > 0)
+		addToTotalStatistics(statistics);
+}
+
+void CompilationCache::addToTotalStatistics(Statistics const& _statistics)
+{
+	m_statistics.hits += _statistics.hits;
+	m_statistics.misses += _statistics.misses;
+	m_statistics.stores += _statistics.stores;
+	m_statistics.evictions += _statistics.evictions;
+
+	// Concurrent updates by different processes can get lost, which is acceptable for statistics.
+	Statistics total = totalStatistics();
+	Json::Value json(Json::objectValue);
+	json["hits"] = Json::UInt64(total.hits + _statistics.hits);
+	json["misses"] = Json::UInt64(total.misses + _statistics.misses);
+	json["stores"] = Json::UInt64(total.stores + _statistics.stores);
+	json["evictions"] = Json::UInt64(total.evictions + _statistics.evictions);
+	writeFileAtomically(m_directory / "statistics.json", jsonCompactPrint(json));
+}
@@ -0,0 +1,93 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Persistent on-disk cache of compiler outputs.
+ */
+
+#pragma once
+
+#include <libsolidity/interface/ReadFile.h>
+
+#include <libdevcore/FixedHash.h>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace dev
+{
+
+namespace solidity
+{
+
+/**
+ * Content-addressed cache of compiler outputs, stored in a directory.
+ * Entries are keyed by the keccak256 hash of the compiler version and the compiler input
+ * (e.g. a standard JSON input, which contains the sources and all settings). Every entry also
+ * records the hashes of the files read through the import callback while compiling, which are
+ * checked again on lookup. The least recently used entries are removed once the total size of
+ * all entries exceeds a limit.
+ * The cache can be shared by concurrently running compiler processes.
+ */
+class CompilationCache
+{
+public:
+	struct Statistics
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t stores = 0;
+		uint64_t evictions = 0;
+	};
+
+	/// Opens the cache in @a _directory, which is created if it does not exist.
+	/// @param _sizeLimit maximum total size of all entries in bytes.
+	CompilationCache(boost::filesystem::path const& _directory, uint64_t _sizeLimit);
+
+	/// @returns the output stored for @a _input if all files it depends on are unchanged when
+	/// read again through @a _readFile.
+	boost::optional<std::string> lookup(std::string const& _input, ReadCallback::Callback const& _readFile);
+
+	/// Stores @a _output for @a _input, together with the contents of all files read through
+	/// the import callback while compiling @a _input, and evicts entries to stay within the size limit.
+	void store(std::string const& _input, std::map<std::string, std::string> const& _readFiles, std::string const& _output);
+
+	/// @returns the statistics of this instance.
+	Statistics const& statistics() const { return m_statistics; }
+
+	/// @returns the statistics of all instances that ever used the cache directory.
+	Statistics totalStatistics() const;
+
+private:
+	h256 key(std::string const& _input) const;
+	boost::filesystem::path entryPath(h256 const& _key) const;
+	/// Removes the least recently used entries, except for @a _keep, until the total size is
+	/// within the limit. The modification times of the entries store their last use.
+	void evict(boost::filesystem::path const& _keep);
+	/// Adds @a _statistics to the statistics stored in the cache directory.
+	void addToTotalStatistics(Statistics const& _statistics);
+
+	boost::filesystem::path m_directory;
+	uint64_t m_sizeLimit;
+	Statistics m_statistics;
+};
+
+}
+}
@@ -0,0 +1,218 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Long-running compiler that answers framed Standard JSON requests and keeps the
+ * state of every project alive between them.
+ */
+
+#include <libsolidity/interface/CompilerServer.h>
+#include <libsolidity/interface/StandardCompiler.h>
+
+#include <libdevcore/Assertions.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+Json::Value formatFatalError(string const& _message)
+{
+	Json::Value error = Json::objectValue;
+	error["type"] = "JSONError";
+	error["component"] = "general";
+	error["severity"] = "error";
+	error["message"] = _message;
+	error["formattedMessage"] = _message;
+	Json::Value output = Json::objectValue;
+	output["errors"] = Json::arrayValue;
+	output["errors"].append(error);
+	return output;
+}
+
+}
+
+CompilerServer::CompilerServer(ReadCallback::Callback const& _readFile, size_t _threads, size_t _maxProjects):
+	m_readFile(_readFile),
+	m_maxProjects(max<size_t>(_maxProjects, 1)),
+	m_workers(_threads)
+{
+}
+
+CompilerServer::~CompilerServer()
+{
+}
+
+string CompilerServer::handle(string const& _request) noexcept
+{
+	try
+	{
+		Json::Value response = Json::objectValue;
+		Json::Value request;
+		string errors;
+		if (!jsonParseStrict(_request, request, &errors))
+			response["output"] = formatFatalError(errors);
+		else if (!request.isObject())
+			response["output"] = formatFatalError("The request must be an object.");
+		else
+		{
+			if (request.isMember("id"))
+				response["id"] = request["id"];
+			if (!request["input"].isObject())
+				response["output"] = formatFatalError("\"input\" must be an object containing the Standard JSON input.");
+			else if (request.isMember("project") && !request["project"].isString())
+				response["output"] = formatFatalError("\"project\" must be a string.");
+			else
+				response["output"] = compile(request["project"].asString(), request["input"]);
+		}
+		return jsonCompactPrint(response);
+	}
+	catch (...)
+	{
+		return "{\"output\":{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error handling request.\",\"formattedMessage\":\"Error handling request.\"}]}}";
+	}
+}
+
+bool CompilerServer::serve(istream& _input, ostream& _output)
+{
+	mutex outputMutex;
+	condition_variable finished;
+	size_t pending = 0;
+	bool wellFormed = true;
+	try
+	{
+		while (boost::optional<string> request = readFrame(_input))
+		{
+			{
+				lock_guard<mutex> lock(outputMutex);
+				++pending;
+			}
+			m_workers.enqueue([&, request]()
+			{
+				string response = handle(*request);
+				lock_guard<mutex> lock(outputMutex);
+				writeFrame(_output, response);
+				_output.flush();
+				if (--pending == 0)
+					finished.notify_all();
+			});
+		}
+	}
+	catch (InvalidFrame const&)
+	{
+		wellFormed = false;
+	}
+
+	// The requests refer to the streams, so they have to finish before returning.
+	unique_lock<mutex> lock(outputMutex);
+	finished.wait(lock, [&]() { return pending == 0; });
+	return wellFormed;
+}
+
+boost::optional<string> CompilerServer::readFrame(istream& _input)
+{
+	boost::optional<size_t> length;
+	bool headerStarted = false;
+	string line;
+	while (getline(_input, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.empty())
+		{
+			// Empty lines between frames are ignored.
+			if (headerStarted)
+				break;
+			continue;
+		}
+		headerStarted = true;
+		size_t colon = line.find(':');
+		assertThrow(colon != string::npos, InvalidFrame, "Invalid header line: " + line);
+		if (boost::iequals(boost::trim_copy(line.substr(0, colon)), "Content-Length"))
+		{
+			try
+			{
+				length = boost::lexical_cast<size_t>(boost::trim_copy(line.substr(colon + 1)));
+			}
+			catch (boost::bad_lexical_cast const&)
+			{
+				BOOST_THROW_EXCEPTION(InvalidFrame() << errinfo_comment("Invalid content length: " + line));
+			}
+		}
+	}
+	if (!headerStarted)
+		return boost::none;
+	assertThrow(_input && length, InvalidFrame, "Missing content length.");
+
+	string content(*length, '\0');
+	_input.read(&content[0], streamsize(*length));
+	assertThrow(size_t(_input.gcount()) == *length, InvalidFrame, "Unexpected end of input.");
+	return content;
+}
+
+void CompilerServer::writeFrame(ostream& _output, string const& _content)
+{
+	_output << "Content-Length: " << _content.size() << "\r\n\r\n" << _content;
+}
+
+size_t CompilerServer::projectCount() const
+{
+	lock_guard<mutex> lock(m_projectsMutex);
+	return m_projects.size();
+}
+
+Json::Value CompilerServer::compile(string const& _project, Json::Value const& _input)
+{
+	if (_project.empty())
+	{
+		StandardCompiler compiler(m_readFile);
+		return compiler.compile(_input);
+	}
+
+	shared_ptr<Project> state;
+	{
+		lock_guard<mutex> lock(m_projectsMutex);
+		shared_ptr<Project>& entry = m_projects[_project];
+		if (!entry)
+			entry = make_shared<Project>();
+		entry->lastUse = ++m_useCounter;
+		state = entry;
+		if (m_projects.size() > m_maxProjects)
+			// A dropped project that is still being compiled is kept alive by its request.
+			m_projects.erase(min_element(m_projects.begin(), m_projects.end(), [](
+				pair<string const, shared_ptr<Project>> const& _a,
+				pair<string const, shared_ptr<Project>> const& _b
+			) { return _a.second->lastUse < _b.second->lastUse; }));
+	}
+
+	// Compilations of the same project have to run in order, since they share the compiler.
+	lock_guard<mutex> projectLock(state->mutex);
+	if (!state->compiler)
+	{
+		state->compiler.reset(new StandardCompiler(m_readFile));
+		state->compiler->setIncrementalCompilation(true);
+	}
+	return state->compiler->compile(_input);
+}
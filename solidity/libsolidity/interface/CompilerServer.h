@@ -0,0 +1,110 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Long-running compiler that answers framed Standard JSON requests and keeps the
+ * state of every project alive between them.
+ */
+
+#pragma once
+
+#include <libsolidity/interface/ReadFile.h>
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/ThreadPool.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace dev
+{
+
+namespace solidity
+{
+
+class StandardCompiler;
+
+DEV_SIMPLE_EXCEPTION(InvalidFrame);
+
+/**
+ * Compiler server handling Standard JSON requests on a pool of worker threads.
+ * Every request names a project, for which a Standard JSON compiler in incremental mode
+ * is kept, so that contracts whose sources and imports are unchanged are not compiled again.
+ * Sources are parsed and analysed again for every request, since analysis annotates the AST.
+ * Requests of different projects are compiled concurrently, those of the same project in order.
+ * Requests and responses are framed like in the language server protocol, i.e. every
+ * message is preceded by a "Content-Length: <n>" header and an empty line.
+ */
+class CompilerServer: boost::noncopyable
+{
+public:
+	/// @param _readFile callback used to read files for import statements.
+	/// @param _threads number of requests handled concurrently.
+	/// @param _maxProjects number of projects whose state is kept, the least recently used one is dropped first.
+	CompilerServer(ReadCallback::Callback const& _readFile, size_t _threads, size_t _maxProjects = 32);
+	~CompilerServer();
+
+	/// Handles a single request, which is a JSON object with the Standard JSON input as member
+	/// "input", the name of the project as optional member "project" and an optional member "id",
+	/// which is copied to the response. Requests without project are compiled from scratch.
+	/// @returns the serialised response, which contains the Standard JSON output as member "output".
+	std::string handle(std::string const& _request) noexcept;
+
+	/// Reads framed requests from @a _input until it ends, handles them concurrently and
+	/// writes the framed responses to @a _output in the order in which they are finished.
+	/// @returns false if the input ended with a malformed frame.
+	bool serve(std::istream& _input, std::ostream& _output);
+
+	/// @returns the content of the next frame read from @a _input or boost::none at the end of the input.
+	/// Throws InvalidFrame if the frame is malformed.
+	static boost::optional<std::string> readFrame(std::istream& _input);
+	/// Writes @a _content as a frame to @a _output.
+	static void writeFrame(std::ostream& _output, std::string const& _content);
+
+	/// @returns the number of projects whose state is kept.
+	size_t projectCount() const;
+
+private:
+	struct Project
+	{
+		std::mutex mutex;
+		std::unique_ptr<StandardCompiler> compiler;
+		/// Value of m_useCounter when the project was last requested, guarded by m_projectsMutex.
+		uint64_t lastUse = 0;
+	};
+
+	/// Compiles @a _input in the state of the project @a _project, which is created if it
+	/// does not exist, or from scratch if @a _project is empty.
+	Json::Value compile(std::string const& _project, Json::Value const& _input);
+
+	ReadCallback::Callback m_readFile;
+	size_t m_maxProjects;
+	std::map<std::string, std::shared_ptr<Project>> m_projects;
+	uint64_t m_useCounter = 0;
+	mutable std::mutex m_projectsMutex;
+	ThreadPool m_workers;
+};
+
+}
+}
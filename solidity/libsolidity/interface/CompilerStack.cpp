@@ -53,6 +53,8 @@
 
 #include <libdevcore/SwarmHash.h>
 #include <libdevcore/JSON.h>
+#include <libdevcore/Profiler.h>
+#include <libdevcore/ThreadPool.h>
 
 #include <json/json.h>
 
@@ -115,10 +117,12 @@ void CompilerStack::reset(bool _keepSources)
 	m_evmVersion = EVMVersion();
 	m_optimize = false;
 	m_optimizeRuns = 200;
+	m_parallelism = 1;
 	m_globalContext.reset();
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
+	m_reusedContracts.clear();
 	m_errorReporter.clear();
 }
 
@@ -139,6 +143,7 @@ bool CompilerStack::parse()
 		return false;
 	m_errorReporter.clear();
 	ASTNode::resetID();
+	ProfilerScope profilerScope("parsing");
 
 	if (SemVerVersion{string(VersionString)}.isPrerelease())
 		m_errorReporter.warning("This is a pre-release compiler version, please do not use it in production.");
@@ -180,62 +185,72 @@ bool CompilerStack::analyze()
 	if (m_stackState != ParsingSuccessful)
 		return false;
 	resolveImports();
+	ProfilerScope profilerScope("analysis");
 
 	bool noErrors = true;
 
 	try {
-		SyntaxChecker syntaxChecker(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (!syntaxChecker.checkSyntax(*source->ast))
-				noErrors = false;
+		// The syntax and documentation checks only depend on the source they are run on.
+		if (!analyzeSources("SyntaxChecker", [](Source const& _source, ErrorReporter& _errorReporter)
+		{
+			return SyntaxChecker(_errorReporter).checkSyntax(*_source.ast);
+		}))
+			noErrors = false;
 
-		DocStringAnalyser docStringAnalyser(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (!docStringAnalyser.analyseDocStrings(*source->ast))
-				noErrors = false;
+		if (!analyzeSources("DocStringAnalyser", [](Source const& _source, ErrorReporter& _errorReporter)
+		{
+			return DocStringAnalyser(_errorReporter).analyseDocStrings(*_source.ast);
+		}))
+			noErrors = false;
 
-		m_globalContext = make_shared<GlobalContext>();
-		NameAndTypeResolver resolver(m_globalContext->declarations(), m_scopes, m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (!resolver.registerDeclarations(*source->ast))
-				return false;
+		{
+			ProfilerScope scope("NameAndTypeResolver");
+			m_globalContext = make_shared<GlobalContext>();
+			NameAndTypeResolver resolver(m_globalContext->declarations(), m_scopes, m_errorReporter);
+			for (Source const* source: m_sourceOrder)
+				if (!resolver.registerDeclarations(*source->ast))
+					return false;
 
-		map<string, SourceUnit const*> sourceUnitsByName;
-		for (auto& source: m_sources)
-			sourceUnitsByName[source.first] = source.second.ast.get();
-		for (Source const* source: m_sourceOrder)
-			if (!resolver.performImports(*source->ast, sourceUnitsByName))
-				return false;
+			map<string, SourceUnit const*> sourceUnitsByName;
+			for (auto& source: m_sources)
+				sourceUnitsByName[source.first] = source.second.ast.get();
+			for (Source const* source: m_sourceOrder)
+				if (!resolver.performImports(*source->ast, sourceUnitsByName))
+					return false;
 
-		// This is the main name and type resolution loop. Needs to be run for every contract, because
-		// the special variables "this" and "super" must be set appropriately.
-		for (Source const* source: m_sourceOrder)
-			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-				if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-				{
-					m_globalContext->setCurrentContract(*contract);
-					if (!resolver.updateDeclaration(*m_globalContext->currentThis())) return false;
-					if (!resolver.updateDeclaration(*m_globalContext->currentSuper())) return false;
-					if (!resolver.resolveNamesAndTypes(*contract)) return false;
-
-					// Note that we now reference contracts by their fully qualified names, and
-					// thus contracts can only conflict if declared in the same source file.  This
-					// already causes a double-declaration error elsewhere, so we do not report
-					// an error here and instead silently drop any additional contracts we find.
-					if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
-						m_contracts[contract->fullyQualifiedName()].contract = contract;
-				}
+			// This is the main name and type resolution loop. Needs to be run for every contract, because
+			// the special variables "this" and "super" must be set appropriately.
+			for (Source const* source: m_sourceOrder)
+				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+					{
+						m_globalContext->setCurrentContract(*contract);
+						if (!resolver.updateDeclaration(*m_globalContext->currentThis())) return false;
+						if (!resolver.updateDeclaration(*m_globalContext->currentSuper())) return false;
+						if (!resolver.resolveNamesAndTypes(*contract)) return false;
+
+						// Note that we now reference contracts by their fully qualified names, and
+						// thus contracts can only conflict if declared in the same source file.  This
+						// already causes a double-declaration error elsewhere, so we do not report
+						// an error here and instead silently drop any additional contracts we find.
+						if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
+							m_contracts[contract->fullyQualifiedName()].contract = contract;
+					}
+		}
 
 		// Next, we check inheritance, overrides, function collisions and other things at
 		// contract or function level.
 		// This also calculates whether a contract is abstract, which is needed by the
 		// type checker.
-		ContractLevelChecker contractLevelChecker(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-				if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-					if (!contractLevelChecker.check(*contract))
-						noErrors = false;
+		{
+			ProfilerScope scope("ContractLevelChecker");
+			ContractLevelChecker contractLevelChecker(m_errorReporter);
+			for (Source const* source: m_sourceOrder)
+				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+						if (!contractLevelChecker.check(*contract))
+							noErrors = false;
+		}
 
 		// New we run full type checks that go down to the expression level. This
 		// cannot be done earlier, because we need cross-contract types and information
@@ -244,16 +259,23 @@ bool CompilerStack::analyze()
 		//
 		// Note: this does not resolve overloaded functions. In order to do that, types of arguments are needed,
 		// which is only done one step later.
-		TypeChecker typeChecker(m_evmVersion, m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-				if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-					if (!typeChecker.checkTypeRequirements(*contract))
-						noErrors = false;
+		//
+		// The type checker always runs sequentially: it lazily fills caches and annotations of
+		// base contracts, which are shared between the contracts that inherit from them.
+		{
+			ProfilerScope scope("TypeChecker");
+			TypeChecker typeChecker(m_evmVersion, m_errorReporter);
+			for (Source const* source: m_sourceOrder)
+				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+						if (!typeChecker.checkTypeRequirements(*contract))
+							noErrors = false;
+		}
 
 		if (noErrors)
 		{
 			// Checks that can only be done when all types of all AST nodes are known.
+			ProfilerScope scope("PostTypeChecker");
 			PostTypeChecker postTypeChecker(m_errorReporter);
 			for (Source const* source: m_sourceOrder)
 				if (!postTypeChecker.check(*source->ast))
@@ -265,31 +287,36 @@ bool CompilerStack::analyze()
 			// Control flow graph generator and analyzer. It can check for issues such as
 			// variable is used before it is assigned to.
 			CFG cfg(m_errorReporter);
+			vector<ASTNode const*> sourceUnits;
 			for (Source const* source: m_sourceOrder)
-				if (!cfg.constructFlow(*source->ast))
+				sourceUnits.push_back(source->ast.get());
+			{
+				ProfilerScope scope("ControlFlowGraph");
+				if (!cfg.constructFlow(sourceUnits, m_parallelism))
 					noErrors = false;
+			}
 
-			if (noErrors)
+			if (noErrors && !analyzeSources("ControlFlowAnalyzer", [&](Source const& _source, ErrorReporter& _errorReporter)
 			{
-				ControlFlowAnalyzer controlFlowAnalyzer(cfg, m_errorReporter);
-				for (Source const* source: m_sourceOrder)
-					if (!controlFlowAnalyzer.analyze(*source->ast))
-						noErrors = false;
-			}
+				return ControlFlowAnalyzer(cfg, _errorReporter).analyze(*_source.ast);
+			}))
+				noErrors = false;
 		}
 
 		if (noErrors)
 		{
 			// Checks for common mistakes. Only generates warnings.
-			StaticAnalyzer staticAnalyzer(m_errorReporter);
-			for (Source const* source: m_sourceOrder)
-				if (!staticAnalyzer.analyze(*source->ast))
-					noErrors = false;
+			if (!analyzeSources("StaticAnalyzer", [](Source const& _source, ErrorReporter& _errorReporter)
+			{
+				return StaticAnalyzer(_errorReporter).analyze(*_source.ast);
+			}))
+				noErrors = false;
 		}
 
 		if (noErrors)
 		{
 			// Check for state mutability in every function.
+			ProfilerScope scope("ViewPureChecker");
 			vector<ASTPointer<ASTNode>> ast;
 			for (Source const* source: m_sourceOrder)
 				ast.push_back(source->ast);
@@ -300,6 +327,7 @@ bool CompilerStack::analyze()
 
 		if (noErrors)
 		{
+			ProfilerScope scope("SMTChecker");
 			SMTChecker smtChecker(m_errorReporter, m_smtlib2Responses);
 			for (Source const* source: m_sourceOrder)
 				smtChecker.analyze(*source->ast, source->scanner);
@@ -327,6 +355,55 @@ bool CompilerStack::parseAndAnalyze()
 	return parse() && analyze();
 }
 
+bool CompilerStack::analyzeSources(char const* _name, function<bool(Source const&, ErrorReporter&)> const& _pass)
+{
+	ProfilerScope profilerScope(_name);
+	if (m_parallelism <= 1)
+	{
+		bool noErrors = true;
+		for (Source const* source: m_sourceOrder)
+			if (!_pass(*source, m_errorReporter))
+				noErrors = false;
+		return noErrors;
+	}
+
+	struct Result
+	{
+		ErrorList errors;
+		bool success = false;
+		bool fatal = false;
+	};
+	vector<Result> results(m_sourceOrder.size());
+	// Only the sources of this compilation share types, so unrelated compilations do not contend.
+	recursive_mutex membersMutex;
+	parallelFor(m_parallelism, m_sourceOrder.size(), [&](size_t _i)
+	{
+		MemberCacheLockScope membersLockScope(membersMutex);
+		ErrorReporter errorReporter(results[_i].errors);
+		try
+		{
+			results[_i].success = _pass(*m_sourceOrder[_i], errorReporter);
+		}
+		catch (FatalError const&)
+		{
+			results[_i].fatal = true;
+		}
+	});
+
+	// Report the errors as if the sources had been analysed one after the other, i.e.
+	// stop at the first source that caused a fatal error.
+	bool noErrors = true;
+	for (Result const& result: results)
+	{
+		m_errorReporter.append(result.errors);
+		if (result.fatal)
+			BOOST_THROW_EXCEPTION(FatalError());
+		if (!result.success)
+			noErrors = false;
+	}
+	return noErrors;
+}
+
 bool CompilerStack::isRequestedContract(ContractDefinition const& _contract) const
 {
 	return
@@ -341,13 +418,23 @@ bool CompilerStack::compile()
 		if (!parseAndAnalyze())
 			return false;
 
-	// Only compile contracts individually which have been requested.
-	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
-	for (Source const* source: m_sourceOrder)
-		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
-				if (isRequestedContract(*contract))
-					compileContract(*contract, compiledContracts);
+	m_reusedContracts.clear();
+	if (m_parallelism > 1)
+		compileContractsInParallel();
+	else
+	{
+		// Only compile contracts individually which have been requested.
+		map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+		for (Source const* source: m_sourceOrder)
+			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+				if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+					if (isRequestedContract(*contract))
+						compileContract(*contract, compiledContracts);
+	}
+	// The optimised sub-assemblies are only shared within one compilation.
+	m_optimisedAssemblyCache.clear();
+	if (m_incrementalCompilation)
+		retainCompiledContracts();
 	m_stackState = CompilationSuccessful;
 	this->link();
 	return true;
@@ -558,10 +645,20 @@ Json::Value CompilerStack::methodIdentifiers(string const& _contractName) const
 
 string const& CompilerStack::metadata(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
 
-	return contract(_contractName).metadata;
+	Contract const& contract = this->contract(_contractName);
+	solAssert(contract.contract, "");
+	// The metadata is created by the compilation, but does not depend on it. Contracts that
+	// cannot be deployed have no metadata, as they are never compiled.
+	if (
+		contract.metadata.empty() &&
+		contract.contract->annotation().unimplementedFunctions.empty() &&
+		contract.contract->constructorIsPublic()
+	)
+		contract.metadata = createMetadata(contract);
+	return contract.metadata;
 }
 
 Scanner const& CompilerStack::scanner(string const& _sourceName) const
@@ -582,8 +679,8 @@ SourceUnit const& CompilerStack::ast(string const& _sourceName) const
 
 ContractDefinition const& CompilerStack::contractDefinition(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
 
 	return *contract(_contractName).contract;
 }
@@ -754,32 +851,201 @@ void CompilerStack::compileContract(
 		compileContract(*dependency, _compiledContracts);
 
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
+	ProfilerActivation profilerActivation(Profiler::contractContext(_contract.fullyQualifiedName()));
+	if (!reuseCompiledContract(compiledContract))
+	{
+		generateCode(compiledContract, _compiledContracts);
+		optimiseAndAssemble(compiledContract);
+	}
+
+	_compiledContracts[&_contract] = &compiledContract.compiler->assembly();
+}
+
+void CompilerStack::compileContractsInParallel()
+{
+	solAssert(m_stackState >= AnalysisSuccessful, "");
+
+	// Collect the contracts in the same order and with the same restrictions as the
+	// sequential compileContract. Contracts that are not compiled themselves (e.g. abstract
+	// base contracts) can still contain code that creates other contracts, which is
+	// inherited by the derived contracts, so their dependencies are collected as well.
+	vector<ContractDefinition const*> contracts;
+	set<ContractDefinition const*> contractsSeen;
+	function<void(ContractDefinition const&)> collect = [&](ContractDefinition const& _contract)
+	{
+		if (!contractsSeen.insert(&_contract).second)
+			return;
+		for (auto const* dependency: _contract.annotation().contractDependencies)
+			collect(*dependency);
+		if (_contract.annotation().unimplementedFunctions.empty() && _contract.constructorIsPublic())
+			contracts.push_back(&_contract);
+	};
+	for (Source const* source: m_sourceOrder)
+		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+				if (isRequestedContract(*contract))
+					collect(*contract);
+
+	set<ContractDefinition const*> const compiled(contracts.begin(), contracts.end());
+	function<void(ContractDefinition const&, set<ContractDefinition const*>&)> addDependencies =
+		[&](ContractDefinition const& _contract, set<ContractDefinition const*>& _dependencies)
+		{
+			for (auto const* dependency: _contract.annotation().contractDependencies)
+				if (_dependencies.insert(dependency).second && !compiled.count(dependency))
+					addDependencies(*dependency, _dependencies);
+		};
+	map<ContractDefinition const*, size_t> pendingDependencies;
+	map<ContractDefinition const*, vector<ContractDefinition const*>> dependants;
+	for (auto const* contract: contracts)
+	{
+		set<ContractDefinition const*> dependencies;
+		addDependencies(*contract, dependencies);
+		pendingDependencies[contract] = 0;
+		for (auto const* dependency: dependencies)
+			if (dependency != contract && compiled.count(dependency))
+			{
+				pendingDependencies[contract]++;
+				dependants[dependency].push_back(contract);
+			}
+	}
+
+	// Protects the AST, the types and the bookkeeping above. Code generation caches
+	// information in the AST and the types, so only the optimiser and the assembler,
+	// which dominate the compilation time, run concurrently.
+	mutex codegenMutex;
+	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	// Declared before the pool so that it outlives all running tasks.
+	function<void(ContractDefinition const*)> schedule;
+	ThreadPool pool(min<size_t>(m_parallelism, contracts.size()));
+	schedule = [&](ContractDefinition const* _contract)
+	{
+		pool.enqueue([&, _contract]()
+		{
+			Contract& compiledContract = m_contracts.at(_contract->fullyQualifiedName());
+			ProfilerActivation profilerActivation(Profiler::contractContext(_contract->fullyQualifiedName()));
+			bool reused = false;
+			{
+				lock_guard<mutex> lock(codegenMutex);
+				reused = reuseCompiledContract(compiledContract);
+				if (!reused)
+					generateCode(compiledContract, compiledContracts);
+			}
+			if (!reused)
+				// Threads that are not used for other contracts are used by the optimiser.
+				optimiseAndAssemble(compiledContract, max<size_t>(1, m_parallelism / pool.size()));
+
+			lock_guard<mutex> lock(codegenMutex);
+			compiledContracts[_contract] = &compiledContract.compiler->assembly();
+			for (auto const* dependant: dependants[_contract])
+				if (--pendingDependencies[dependant] == 0)
+					schedule(dependant);
+		});
+	};
+	{
+		// Finished tasks schedule their dependants, so the initial contracts are scheduled
+		// under the lock as well. Otherwise, a contract could be scheduled twice.
+		lock_guard<mutex> lock(codegenMutex);
+		for (auto const* contract: contracts)
+			if (pendingDependencies[contract] == 0)
+				schedule(contract);
+	}
+	pool.wait();
+}
+
+bool CompilerStack::reuseCompiledContract(Contract& _contract)
+{
+	if (!m_incrementalCompilation)
+		return false;
+
+	auto cached = m_compiledContractCache.find(dev::keccak256(createMetadata(_contract)));
+	if (cached == m_compiledContractCache.end())
+		return false;
+
+	// The compiler refers to the AST the contract was compiled from, so the contract
+	// definition is taken over as well.
+	Contract const& cachedContract = cached->second;
+	m_reusedContracts.insert(_contract.contract->fullyQualifiedName());
+	_contract.contract = cachedContract.contract;
+	_contract.compiler = cachedContract.compiler;
+	_contract.object = cachedContract.object;
+	_contract.runtimeObject = cachedContract.runtimeObject;
+	_contract.metadata = cachedContract.metadata;
+	_contract.analysis = cachedContract.analysis;
+	// Source indices depend on all sources, so the source mappings have to be recomputed.
+	_contract.sourceMapping.reset();
+	_contract.runtimeSourceMapping.reset();
+	return true;
+}
+
+void CompilerStack::retainCompiledContracts()
+{
+	auto analysis = make_shared<AnalysisResults>();
+	for (Source const* source: m_sourceOrder)
+		analysis->asts.push_back(source->ast);
+	analysis->globalContext = m_globalContext;
+	analysis->scopes = m_scopes;
+
+	// Only the contracts of the latest compilation are retained.
+	map<h256, Contract> cache;
+	for (auto& contract: m_contracts)
+		if (contract.second.compiler)
+		{
+			if (!contract.second.analysis)
+				contract.second.analysis = analysis;
+			Contract& cachedContract = cache[dev::keccak256(contract.second.metadata)];
+			cachedContract.contract = contract.second.contract;
+			cachedContract.compiler = contract.second.compiler;
+			cachedContract.object = contract.second.object;
+			cachedContract.runtimeObject = contract.second.runtimeObject;
+			cachedContract.metadata = contract.second.metadata;
+			cachedContract.analysis = contract.second.analysis;
+		}
+	m_compiledContractCache = move(cache);
+}
+
+void CompilerStack::generateCode(
+	Contract& _contract,
+	map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+)
+{
+	solAssert(_contract.contract, "");
+	ProfilerScope profilerScope("codegen");
 
 	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimize, m_optimizeRuns);
-	compiledContract.compiler = compiler;
+	_contract.compiler = compiler;
 
-	string metadata = createMetadata(compiledContract);
-	compiledContract.metadata = metadata;
+	string metadata = createMetadata(_contract);
+	_contract.metadata = metadata;
 
 	bytes cborEncodedMetadata = createCBORMetadata(
 		metadata,
-		!onlySafeExperimentalFeaturesActivated(_contract.sourceUnit().annotation().experimentalFeatures)
+		!onlySafeExperimentalFeaturesActivated(_contract.contract->sourceUnit().annotation().experimentalFeatures)
 	);
 
+	compiler->generateCode(*_contract.contract, _compiledContracts, cborEncodedMetadata);
+}
+
+void CompilerStack::optimiseAndAssemble(Contract& _contract, size_t _jobs)
+{
+	solAssert(_contract.compiler, "");
+	Compiler& compiler = *_contract.compiler;
+
 	try
 	{
-		// Run optimiser and compile the contract.
-		compiler->compileContract(_contract, _compiledContracts, cborEncodedMetadata);
+		// Run optimiser.
+		ProfilerScope profilerScope("optimiser");
+		compiler.optimise(&m_optimisedAssemblyCache, _jobs);
 	}
 	catch(eth::OptimizerException const&)
 	{
 		solAssert(false, "Optimizer exception during compilation");
 	}
 
+	ProfilerScope profilerScope("assembler");
 	try
 	{
 		// Assemble deployment (incl. runtime)  object.
-		compiledContract.object = compiler->assembledObject();
+		_contract.object = compiler.assembledObject();
 	}
 	catch(eth::AssemblyException const&)
 	{
@@ -789,14 +1055,12 @@ void CompilerStack::compileContract(
 	try
 	{
 		// Assemble runtime object.
-		compiledContract.runtimeObject = compiler->runtimeObject();
+		_contract.runtimeObject = compiler.runtimeObject();
 	}
 	catch(eth::AssemblyException const&)
 	{
 		solAssert(false, "Assembly exception for deployed bytecode");
 	}
-
-	_compiledContracts[compiledContract.contract] = &compiler->assembly();
 }
 
 CompilerStack::Contract const& CompilerStack::contract(string const& _contractName) const
@@ -30,6 +30,7 @@
 #include <liblangutil/SourceLocation.h>
 
 #include <libevmasm/LinkerObject.h>
+#include <libevmasm/OptimisedAssemblyCache.h>
 
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
@@ -38,6 +39,7 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
 #include <ostream>
 #include <string>
 #include <memory>
@@ -135,6 +137,12 @@ public:
 		m_optimizeRuns = _runs;
 	}
 
+	/// Sets the number of threads used to analyse independent sources and to generate and
+	/// optimise the code of independent contracts. A value of one (the default) processes
+	/// everything sequentially. The output does not depend on this setting.
+	/// Will not take effect before running analysis or compile.
+	void setParallelism(unsigned _jobs) { m_parallelism = std::max(_jobs, 1u); }
+
 	/// Set the EVM version used before running compile.
 	/// When called without an argument it will revert to the default version.
 	void setEVMVersion(EVMVersion _version = EVMVersion{});
@@ -146,6 +154,23 @@ public:
 		m_requestedContractNames = _contractNames;
 	}
 
+	/// Enables or disables incremental compilation. If enabled, the compilation results of every
+	/// contract are retained and reused by later calls to compile if the metadata of the contract
+	/// is unchanged, i.e. if neither the contents of its source and of all sources it imports nor
+	/// the settings changed. Sources are still parsed and analysed again.
+	/// Unlike other settings, this is not changed by reset, so that the results survive
+	/// modifications of the sources. Disabling it discards all retained results.
+	void setIncrementalCompilation(bool _enabled)
+	{
+		m_incrementalCompilation = _enabled;
+		if (!_enabled)
+			m_compiledContractCache.clear();
+	}
+
+	/// @returns the fully qualified names of the contracts whose compilation results were reused
+	/// from an earlier compilation by the last call to compile.
+	std::set<std::string> const& reusedContracts() const { return m_reusedContracts; }
+
 	/// @arg _metadataLiteralSources When true, store sources as literals in the contract metadata.
 	void useMetadataLiteralSources(bool _metadataLiteralSources) { m_metadataLiteralSources = _metadataLiteralSources; }
 
@@ -249,7 +274,8 @@ public:
 	/// @returns a JSON representing a map of method identifiers (hashes) to function names.
 	Json::Value methodIdentifiers(std::string const& _contractName) const;
 
-	/// @returns the Contract Metadata
+	/// @returns the Contract Metadata, which is empty for contracts that cannot be deployed.
+	/// Prerequisite: Successful call to parse or compile.
 	std::string const& metadata(std::string const& _contractName) const;
 
 	/// @returns a JSON representing the estimated gas usage for contract creation, internal and external functions
@@ -265,6 +291,15 @@ private:
 		void reset() { scanner.reset(); ast.reset(); }
 	};
 
+	/// The ASTs and analysis results compiled contracts refer to. Retained in incremental mode,
+	/// where a compiled contract can outlive the compilation it originates from.
+	struct AnalysisResults
+	{
+		std::vector<std::shared_ptr<SourceUnit>> asts;
+		std::shared_ptr<GlobalContext> globalContext;
+		std::map<ASTNode const*, std::shared_ptr<DeclarationContainer>> scopes;
+	};
+
 	/// The state per contract. Filled gradually during compilation.
 	struct Contract
 	{
@@ -272,7 +307,8 @@ private:
 		std::shared_ptr<Compiler> compiler;
 		eth::LinkerObject object; ///< Deployment object (includes the runtime sub-object).
 		eth::LinkerObject runtimeObject; ///< Runtime object.
-		std::string metadata; ///< The metadata json that will be hashed into the chain.
+		mutable std::string metadata; ///< The metadata json that will be hashed into the chain, created on demand if not compiled.
+		std::shared_ptr<AnalysisResults const> analysis; ///< Only set in incremental mode.
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
@@ -287,6 +323,12 @@ private:
 	std::string applyRemapping(std::string const& _path, std::string const& _context);
 	void resolveImports();
 
+	/// Runs the per-source analysis step @a _pass, profiled as @a _name, on all sources, concurrently if parallelism is
+	/// enabled. Every source then reports to its own error reporter and the errors are merged
+	/// in the order of the sources afterwards, so they do not depend on the scheduling.
+	/// @returns false if @a _pass returned false for any source.
+	bool analyzeSources(char const* _name, std::function<bool(Source const&, langutil::ErrorReporter&)> const& _pass);
+
 	/// @returns true if the contract is requested to be compiled.
 	bool isRequestedContract(ContractDefinition const& _contract) const;
 
@@ -296,6 +338,30 @@ private:
 		std::map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
 	);
 
+	/// Compiles the requested contracts and their dependencies on a pool of m_parallelism
+	/// threads, starting each contract as soon as all contracts it creates are compiled.
+	void compileContractsInParallel();
+
+	/// Takes over the compilation results of @a _contract from an earlier compilation in
+	/// incremental mode, including its definition, which then belongs to an earlier AST.
+	/// @returns false if the contract has to be compiled.
+	bool reuseCompiledContract(Contract& _contract);
+
+	/// Retains the compilation results of the last compilation in incremental mode.
+	void retainCompiledContracts();
+
+	/// Creates the compiler and metadata for @a _contract and generates its unoptimised code.
+	/// Requires all contracts created by it to be present in @a _compiledContracts.
+	void generateCode(
+		Contract& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+	);
+
+	/// Runs the optimiser on the code generated for @a _contract and assembles its objects.
+	/// Does not access the AST and thus can run concurrently for different contracts.
+	/// The optimiser uses up to @a _jobs threads.
+	void optimiseAndAssemble(Contract& _contract, size_t _jobs = 1);
+
 	/// Links all the known library addresses in the available objects. Any unknown
 	/// library will still be kept as an unlinked placeholder in the objects.
 	void link();
@@ -343,6 +409,7 @@ private:
 	ReadCallback::Callback m_readFile;
 	bool m_optimize = false;
 	unsigned m_optimizeRuns = 200;
+	unsigned m_parallelism = 1;
 	EVMVersion m_evmVersion;
 	std::set<std::string> m_requestedContractNames;
 	std::map<std::string, h160> m_libraries;
@@ -360,6 +427,14 @@ private:
 	langutil::ErrorList m_errorList;
 	langutil::ErrorReporter m_errorReporter;
 	bool m_metadataLiteralSources = false;
+	bool m_incrementalCompilation = false;
+	/// Compiled contracts of the last compilation in incremental mode, keyed by the keccak256
+	/// hash of their metadata.
+	std::map<h256, Contract> m_compiledContractCache;
+	std::set<std::string> m_reusedContracts;
+	/// Optimised sub-assemblies, shared by the contracts of a compilation, since a contract
+	/// is embedded as sub-assembly into every contract that creates it.
+	eth::OptimisedAssemblyCache m_optimisedAssemblyCache;
 	State m_stackState = Empty;
 };
 
@@ -26,6 +26,7 @@
 #include <libevmasm/Instruction.h>
 #include <libdevcore/JSON.h>
 #include <libdevcore/Keccak256.h>
+#include <libdevcore/Profiler.h>
 
 #include <boost/algorithm/string.hpp>
 
@@ -95,22 +96,6 @@ Json::Value formatErrorWithException(
 	return formatError(_warning, _type, _component, message, formattedMessage, sourceLocation);
 }
 
-set<string> requestedContractNames(Json::Value const& _outputSelection)
-{
-	set<string> names;
-	for (auto const& sourceName: _outputSelection.getMemberNames())
-	{
-		for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
-		{
-			/// Consider the "all sources" shortcuts as requesting everything.
-			if (contractName == "*" || contractName == "")
-				return set<string>();
-			names.insert((sourceName == "*" ? "" : sourceName) + ":" + contractName);
-		}
-	}
-	return names;
-}
-
 /// Returns true iff @a _hash (hex with 0x prefix) is the Keccak256 hash of the binary data in @a _content.
 bool hashMatchesContent(string const& _hash, string const& _content)
 {
@@ -137,9 +122,18 @@ StringMap createSourceList(Json::Value const& _input)
 bool isArtifactRequested(Json::Value const& _outputSelection, string const& _artifact)
 {
 	for (auto const& artifact: _outputSelection)
-		/// @TODO support sub-matching, e.g "evm" matches "evm.assembly"
-		if (artifact == "*" || artifact == _artifact)
+	{
+		if (!artifact.isString())
+			continue;
+		string const requested = artifact.asString();
+		// Selecting an output also selects all its parts, e.g. "evm" matches "evm.assembly".
+		if (
+			requested == "*" ||
+			requested == _artifact ||
+			(_artifact.size() > requested.size() && _artifact.compare(0, requested.size() + 1, requested + ".") == 0)
+		)
 			return true;
+	}
 	return false;
 }
 
@@ -189,6 +183,26 @@ bool isArtifactRequested(Json::Value const& _outputSelection, string const& _fil
 	return false;
 }
 
+/// @returns true if any output of @a _contract in @a _file is requested that requires generating its code.
+/// All other outputs only depend on the analysis.
+bool isCodeRequested(Json::Value const& _outputSelection, string const& _file, string const& _contract)
+{
+	static vector<string> const outputsRequiringCode{
+		"evm.assembly",
+		"evm.legacyAssembly",
+		"evm.gasEstimates",
+		"evm.bytecode.object",
+		"evm.bytecode.opcodes",
+		"evm.bytecode.sourceMap",
+		"evm.bytecode.linkReferences",
+		"evm.deployedBytecode.object",
+		"evm.deployedBytecode.opcodes",
+		"evm.deployedBytecode.sourceMap",
+		"evm.deployedBytecode.linkReferences"
+	};
+	return isArtifactRequested(_outputSelection, _file, _contract, outputsRequiringCode);
+}
+
 Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkReferences)
 {
 	Json::Value ret(Json::objectValue);
@@ -216,13 +230,55 @@ Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkRefere
 	return ret;
 }
 
-Json::Value collectEVMObject(eth::LinkerObject const& _object, string const* _sourceMap)
+/// @returns the parts of @a _object that @a _isRequested, which is called with the name of each part.
+/// The source map is only computed if requested.
+Json::Value collectEVMObject(
+	eth::LinkerObject const& _object,
+	function<string const*()> const& _sourceMap,
+	function<bool(string const&)> const& _isRequested
+)
+{
+	Json::Value output = Json::objectValue;
+	if (_isRequested("object"))
+		output["object"] = _object.toHex();
+	if (_isRequested("opcodes"))
+		output["opcodes"] = solidity::disassemble(_object.bytecode);
+	if (_isRequested("sourceMap"))
+	{
+		string const* sourceMap = _sourceMap();
+		output["sourceMap"] = sourceMap ? *sourceMap : "";
+	}
+	if (_isRequested("linkReferences"))
+		output["linkReferences"] = formatLinkReferences(_object.linkReferences);
+	return output;
+}
+
+Json::Value formatProfilerPhases(Profiler::Phases const& _phases)
+{
+	Json::Value phases = Json::objectValue;
+	for (auto const& phase: _phases)
+	{
+		Json::Value& statistics = phases[phase.first] = Json::objectValue;
+		statistics["calls"] = Json::UInt64(phase.second.calls);
+		statistics["time"] = phase.second.seconds * 1000;
+		if (Profiler::countsAllocations())
+			statistics["peakAllocation"] = Json::Int64(phase.second.peakAllocation);
+		if (phase.second.blocks > 0)
+		{
+			statistics["blocks"] = Json::UInt64(phase.second.blocks);
+			statistics["changedBlocks"] = Json::UInt64(phase.second.changedBlocks);
+		}
+	}
+	return phases;
+}
+
+Json::Value formatProfiler(Profiler const& _profiler)
 {
 	Json::Value output = Json::objectValue;
-	output["object"] = _object.toHex();
-	output["opcodes"] = solidity::disassemble(_object.bytecode);
-	output["sourceMap"] = _sourceMap ? *_sourceMap : "";
-	output["linkReferences"] = formatLinkReferences(_object.linkReferences);
+	output["phases"] = formatProfilerPhases(_profiler.phases());
+	output["contracts"] = Json::objectValue;
+	for (auto const& contract: _profiler.contractPhases())
+		output["contracts"][contract.first] = formatProfilerPhases(contract.second);
 	return output;
 }
 
@@ -384,6 +440,13 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 		}
 	}
 
+	if (settings.isMember("parallelism"))
+	{
+		if (!settings["parallelism"].isUInt() || settings["parallelism"].asUInt() == 0)
+			return formatFatalError("JSONError", "The \"parallelism\" setting must be a positive unsigned number.");
+		m_compilerStack.setParallelism(settings["parallelism"].asUInt());
+	}
+
 	map<string, h160> libraries;
 	Json::Value jsonLibraries = settings.get("libraries", Json::Value(Json::objectValue));
 	if (!jsonLibraries.isObject())
@@ -431,13 +494,38 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	m_compilerStack.useMetadataLiteralSources(metadataSettings.get("useLiteralContent", Json::Value(false)).asBool());
 
 	Json::Value outputSelection = settings.get("outputSelection", Json::Value());
-	m_compilerStack.setRequestedContractNames(requestedContractNames(outputSelection));
+
+	if (settings.isMember("profiling") && !settings["profiling"].isBool())
+		return formatFatalError("JSONError", "The \"profiling\" setting must be a boolean.");
+	Profiler profiler;
+	unique_ptr<ProfilerActivation> profilerActivation;
+	if (settings.get("profiling", false).asBool())
+		profilerActivation.reset(new ProfilerActivation(profiler));
 
 	auto scannerFromSourceName = [&](string const& _sourceName) -> Scanner const& { return m_compilerStack.scanner(_sourceName); };
 
+	// Only the contracts whose code is requested are compiled, together with the contracts they create.
+	// If no code is requested at all, the compiler stops after the analysis.
+	bool codeRequested = false;
 	try
 	{
-		m_compilerStack.compile();
+		if (m_compilerStack.parseAndAnalyze())
+		{
+			set<string> contractsToCompile;
+			for (string const& contractName: m_compilerStack.contractNames())
+			{
+				size_t colon = contractName.rfind(':');
+				solAssert(colon != string::npos, "");
+				if (isCodeRequested(outputSelection, contractName.substr(0, colon), contractName.substr(colon + 1)))
+					contractsToCompile.insert(contractName);
+			}
+			if (!contractsToCompile.empty())
+			{
+				codeRequested = true;
+				m_compilerStack.setRequestedContractNames(contractsToCompile);
+				m_compilerStack.compile();
+			}
+		}
 
 		for (auto const& error: m_compilerStack.errors())
 		{
@@ -528,7 +616,9 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	}
 
 	bool const analysisSuccess = m_compilerStack.state() >= CompilerStack::State::AnalysisSuccessful;
-	bool const compilationSuccess = m_compilerStack.state() == CompilerStack::State::CompilationSuccessful;
+	bool const compilationSuccess = codeRequested ?
+		m_compilerStack.state() == CompilerStack::State::CompilationSuccessful :
+		analysisSuccess;
 
 	/// Inconsistent state - stop here to receive error reports from users
 	if (!compilationSuccess && errors.empty())
@@ -556,6 +646,15 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 		output["sources"][sourceName] = sourceResult;
 	}
 
+	// Only created if the assembly is requested.
+	unique_ptr<StringMap const> sourceList;
+	auto sourceContents = [&]() -> StringMap const&
+	{
+		if (!sourceList)
+			sourceList.reset(new StringMap(createSourceList(_input)));
+		return *sourceList;
+	};
+
 	Json::Value contractsOutput = Json::objectValue;
 	for (string const& contractName: compilationSuccess ? m_compilerStack.contractNames() : vector<string>())
 	{
@@ -563,6 +662,10 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 		solAssert(colon != string::npos, "");
 		string file = contractName.substr(0, colon);
 		string name = contractName.substr(colon + 1);
+		auto isRequested = [&](string const& _artifact)
+		{
+			return isArtifactRequested(outputSelection, file, name, _artifact);
+		};
 
 		// ABI, documentation and metadata
 		Json::Value contractData(Json::objectValue);
@@ -579,35 +682,31 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 		Json::Value evmData(Json::objectValue);
 		// @TODO: add ir
 		if (isArtifactRequested(outputSelection, file, name, "evm.assembly"))
-			evmData["assembly"] = m_compilerStack.assemblyString(contractName, createSourceList(_input));
+			evmData["assembly"] = m_compilerStack.assemblyString(contractName, sourceContents());
 		if (isArtifactRequested(outputSelection, file, name, "evm.legacyAssembly"))
-			evmData["legacyAssembly"] = m_compilerStack.assemblyJSON(contractName, createSourceList(_input));
+			evmData["legacyAssembly"] = m_compilerStack.assemblyJSON(contractName, sourceContents());
 		if (isArtifactRequested(outputSelection, file, name, "evm.methodIdentifiers"))
 			evmData["methodIdentifiers"] = m_compilerStack.methodIdentifiers(contractName);
 		if (isArtifactRequested(outputSelection, file, name, "evm.gasEstimates"))
 			evmData["gasEstimates"] = m_compilerStack.gasEstimates(contractName);
 
-		if (isArtifactRequested(
-			outputSelection,
-			file,
-			name,
-			{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" }
-		))
-			evmData["bytecode"] = collectEVMObject(
+		if (isCodeRequested(outputSelection, file, name))
+		{
+			Json::Value bytecode = collectEVMObject(
 				m_compilerStack.object(contractName),
-				m_compilerStack.sourceMapping(contractName)
+				[&]() { return m_compilerStack.sourceMapping(contractName); },
+				[&](string const& _part) { return isRequested("evm.bytecode." + _part); }
 			);
-
-		if (isArtifactRequested(
-			outputSelection,
-			file,
-			name,
-			{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" }
-		))
-			evmData["deployedBytecode"] = collectEVMObject(
+			if (!bytecode.empty())
+				evmData["bytecode"] = bytecode;
+			Json::Value deployedBytecode = collectEVMObject(
 				m_compilerStack.runtimeObject(contractName),
-				m_compilerStack.runtimeSourceMapping(contractName)
+				[&]() { return m_compilerStack.runtimeSourceMapping(contractName); },
+				[&](string const& _part) { return isRequested("evm.deployedBytecode." + _part); }
 			);
+			if (!deployedBytecode.empty())
+				evmData["deployedBytecode"] = deployedBytecode;
+		}
 
 		contractData["evm"] = evmData;
 
@@ -618,6 +717,12 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	}
 	output["contracts"] = contractsOutput;
 
+	if (profilerActivation)
+	{
+		profilerActivation.reset();
+		output["profiling"] = formatProfiler(profiler);
+	}
+
 	return output;
 }
 
@@ -52,6 +52,10 @@ public:
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input) noexcept;
 
+	/// Enables or disables incremental compilation, which retains the compilation results of
+	/// unchanged contracts across calls to compile (see CompilerStack::setIncrementalCompilation).
+	void setIncrementalCompilation(bool _enabled) { m_compilerStack.setIncrementalCompilation(_enabled); }
+
 private:
 	Json::Value compileInternal(Json::Value const& _input);
 
@@ -304,10 +304,10 @@ Expression Parser::parseExpression()
 
 std::map<string, dev::solidity::Instruction> const& Parser::instructions()
 {
-	// Allowed instructions, lowercase names.
-	static map<string, dev::solidity::Instruction> s_instructions;
-	if (s_instructions.empty())
+	// Allowed instructions, lowercase names. Initialised only once, since compilations can run concurrently.
+	static map<string, dev::solidity::Instruction> const s_instructions = []()
 	{
+		map<string, dev::solidity::Instruction> instructions;
 		for (auto const& instruction: solidity::c_instructions)
 		{
 			if (
@@ -317,23 +317,25 @@ std::map<string, dev::solidity::Instruction> const& Parser::instructions()
 				continue;
 			string name = instruction.first;
 			transform(name.begin(), name.end(), name.begin(), [](unsigned char _c) { return tolower(_c); });
-			s_instructions[name] = instruction.second;
+			instructions[name] = instruction.second;
 		}
-	}
+		return instructions;
+	}();
 	return s_instructions;
 }
 
 std::map<dev::solidity::Instruction, string> const& Parser::instructionNames()
 {
-	static map<dev::solidity::Instruction, string> s_instructionNames;
-	if (s_instructionNames.empty())
+	static map<dev::solidity::Instruction, string> const s_instructionNames = []()
 	{
+		map<dev::solidity::Instruction, string> names;
 		for (auto const& instr: instructions())
-			s_instructionNames[instr.second] = instr.first;
+			names[instr.second] = instr.first;
 		// set the ambiguous instructions to a clear default
-		s_instructionNames[solidity::Instruction::SELFDESTRUCT] = "selfdestruct";
-		s_instructionNames[solidity::Instruction::KECCAK256] = "keccak256";
-	}
+		names[solidity::Instruction::SELFDESTRUCT] = "selfdestruct";
+		names[solidity::Instruction::KECCAK256] = "keccak256";
+		return names;
+	}();
 	return s_instructionNames;
 }
 
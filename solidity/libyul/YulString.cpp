@@ -0,0 +1,134 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * String abstraction that avoids copies.
+ */
+
+#include <libyul/YulString.h>
+
+#include <libyul/Exceptions.h>
+
+using namespace std;
+using namespace yul;
+
+namespace
+{
+/// @returns the @a _count bytes at @a _data as a little endian number, independent of the platform.
+uint64_t readLittleEndian(char const* _data, size_t _count)
+{
+	uint64_t k = 0;
+	for (size_t i = _count; i > 0; --i)
+		k = (k << 8) | uint8_t(_data[i - 1]);
+	return k;
+}
+}
+
+YulStringRepository::YulStringRepository()
+{
+	for (auto& segment: m_segments)
+		segment.store(nullptr, memory_order_relaxed);
+	store(0, string());
+}
+
+YulStringRepository::~YulStringRepository()
+{
+	for (auto& segment: m_segments)
+		delete[] segment.load(memory_order_relaxed);
+}
+
+YulStringRepository::Handle YulStringRepository::stringToHandle(string const& _string)
+{
+	if (_string.empty())
+		return { 0, emptyHash() };
+	uint64_t h = hash(_string);
+	Shard& shard = m_shards[h >> 60];
+	lock_guard<mutex> lock(shard.mutex);
+	auto range = shard.hashToID.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it)
+		if (idToString(it->second) == _string)
+			return Handle{it->second, h};
+	size_t id = m_nextID++;
+	store(id, _string);
+	shard.hashToID.emplace_hint(range.second, make_pair(h, id));
+	return Handle{id, h};
+}
+
+bool YulStringRepository::contains(string const& _string) const
+{
+	if (_string.empty())
+		return true;
+	uint64_t h = hash(_string);
+	Shard const& shard = m_shards[h >> 60];
+	lock_guard<mutex> lock(shard.mutex);
+	auto range = shard.hashToID.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it)
+		if (idToString(it->second) == _string)
+			return true;
+	return false;
+}
+
+void YulStringRepository::store(size_t _id, string const& _string)
+{
+	size_t index = _id >> segmentBits;
+	assertThrow(index < maxSegments, YulException, "Too many distinct Yul strings.");
+	string* segment = m_segments[index].load(memory_order_acquire);
+	if (!segment)
+	{
+		lock_guard<mutex> lock(m_segmentMutex);
+		segment = m_segments[index].load(memory_order_relaxed);
+		if (!segment)
+		{
+			segment = new string[segmentSize];
+			m_segments[index].store(segment, memory_order_release);
+		}
+	}
+	// The ID is only handed out after this assignment, under the lock of the shard.
+	segment[_id & (segmentSize - 1)] = _string;
+}
+
+uint64_t YulStringRepository::hash(string const& v)
+{
+	if (v.empty())
+		return emptyHash();
+
+	uint64_t const m = 0xc6a4a7935bd1e995u;
+	int const r = 47;
+	size_t const len = v.size();
+	char const* data = v.data();
+	uint64_t h = emptyHash() ^ (len * m);
+
+	for (char const* end = data + (len & ~size_t(7)); data != end; data += 8)
+	{
+		uint64_t k = readLittleEndian(data, 8);
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	if (size_t const rest = len & 7)
+	{
+		h ^= readLittleEndian(data, rest);
+		h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
@@ -22,9 +22,11 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
-#include <memory>
-#include <vector>
 #include <string>
 
 namespace yul
@@ -34,6 +36,8 @@ namespace yul
 /// Owns the string data for all YulStrings, which can be referenced by a Handle.
 /// A Handle consists of an ID (that depends on the insertion order of YulStrings and is potentially
 /// non-deterministic) and a deterministic string hash.
+/// The repository can be used from several threads concurrently. Strings are stored in fixed-size
+/// segments that are never moved, so looking up the string of an ID does not need a lock.
 class YulStringRepository: boost::noncopyable
 {
 public:
@@ -42,47 +46,46 @@ public:
 		size_t id;
 		std::uint64_t hash;
 	};
-	YulStringRepository():
-		m_strings{std::make_shared<std::string>()},
-		m_hashToID{std::make_pair(emptyHash(), 0)}
-	{}
+	YulStringRepository();
+	~YulStringRepository();
 	static YulStringRepository& instance()
 	{
 		static YulStringRepository inst;
 		return inst;
 	}
-	Handle stringToHandle(std::string const& _string)
+	Handle stringToHandle(std::string const& _string);
+	/// @returns true if @a _string has a handle already, without creating one.
+	bool contains(std::string const& _string) const;
+	std::string const& idToString(size_t _id) const
 	{
-		if (_string.empty())
-			return { 0, emptyHash() };
-		std::uint64_t h = hash(_string);
-		auto range = m_hashToID.equal_range(h);
-		for (auto it = range.first; it != range.second; ++it)
-			if (*m_strings[it->second] == _string)
-				return Handle{it->second, h};
-		m_strings.emplace_back(std::make_shared<std::string>(_string));
-		size_t id = m_strings.size() - 1;
-		m_hashToID.emplace_hint(range.second, std::make_pair(h, id));
-		return Handle{id, h};
+		return m_segments[_id >> segmentBits].load(std::memory_order_acquire)[_id & (segmentSize - 1)];
 	}
-	std::string const& idToString(size_t _id) const	{ return *m_strings.at(_id); }
 
-	static std::uint64_t hash(std::string const& v)
-	{
-		// FNV hash - can be replaced by a better one, e.g. xxhash64
-		std::uint64_t hash = emptyHash();
-		for (auto c: v)
-		{
-			hash *= 1099511628211u;
-			hash ^= c;
-		}
-
-		return hash;
-	}
+	/// MurmurHash64A of @a v, but emptyHash() for the empty string.
+	static std::uint64_t hash(std::string const& v);
 	static constexpr std::uint64_t emptyHash() { return 14695981039346656037u; }
 private:
-	std::vector<std::shared_ptr<std::string>> m_strings;
-	std::unordered_multimap<std::uint64_t, size_t> m_hashToID;
+	static constexpr size_t segmentBits = 12;
+	static constexpr size_t segmentSize = size_t(1) << segmentBits;
+	static constexpr size_t maxSegments = size_t(1) << 16;
+	static constexpr size_t shardCount = 16;
+
+	/// Part of the hash-to-ID index, selected by the topmost bits of the hash.
+	struct Shard
+	{
+		mutable std::mutex mutex;
+		std::unordered_multimap<std::uint64_t, size_t> hashToID;
+	};
+
+	/// Stores @a _string as the string of @a _id, allocating its segment if needed.
+	void store(size_t _id, std::string const& _string);
+
+	std::array<Shard, shardCount> m_shards;
+	/// Next ID to be assigned. ID zero is the empty string.
+	std::atomic<size_t> m_nextID{1};
+	/// Segments of segmentSize strings each. Only set once and never moved.
+	std::array<std::atomic<std::string*>, maxSegments> m_segments;
+	std::mutex m_segmentMutex;
 };
 
 /// Wrapper around handles into the YulString repository.
@@ -117,6 +120,8 @@ public:
 	bool operator!=(YulString const& _other) const { return m_handle.id != _other.m_handle.id; }
 
 	bool empty() const { return m_handle.id == 0; }
+	/// @returns the deterministic hash of the string.
+	std::uint64_t hash() const { return m_handle.hash; }
 	std::string const& str() const
 	{
 		return YulStringRepository::instance().idToString(m_handle.id);
@@ -128,3 +133,14 @@ private:
 };
 
 }
+
+namespace std
+{
+template<> struct hash<yul::YulString>
+{
+	size_t operator()(yul::YulString const& _x) const
+	{
+		return size_t(_x.hash());
+	}
+};
+}
@@ -56,14 +56,14 @@ void CommonSubexpressionEliminator::visit(Expression& _e)
 	}
 	else
 	{
-		// TODO this search is rather inefficient.
-		for (auto const& var: m_value)
+		for (auto const& name: variablesWithValue(_e))
 		{
-			assertThrow(var.second, OptimizerException, "");
-			assertThrow(inScope(var.first), OptimizerException, "");
-			if (SyntacticalEqualityChecker::equal(_e, *var.second))
+			Expression const* value = m_value.at(name);
+			assertThrow(value, OptimizerException, "");
+			assertThrow(inScope(name), OptimizerException, "");
+			if (SyntacticalEqualityChecker::equal(_e, *value))
 			{
-				_e = Identifier{locationOf(_e), var.first};
+				_e = Identifier{locationOf(_e), name};
 				break;
 			}
 		}
@@ -24,6 +24,7 @@
 
 #include <libyul/optimiser/NameCollector.h>
 #include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SyntacticalEquality.h>
 #include <libyul/Exceptions.h>
 #include <libyul/AsmData.h>
 
@@ -88,9 +89,11 @@ void DataFlowAnalyzer::operator()(FunctionDefinition& _fun)
 	map<YulString, Expression const*> value;
 	map<YulString, set<YulString>> references;
 	map<YulString, set<YulString>> referencedBy;
+	unordered_map<size_t, set<YulString>> valueHashes;
 	m_value.swap(value);
 	m_references.swap(references);
 	m_referencedBy.swap(referencedBy);
+	m_valueHashes.swap(valueHashes);
 	pushScope(true);
 
 	for (auto const& parameter: _fun.parameters)
@@ -103,6 +106,7 @@ void DataFlowAnalyzer::operator()(FunctionDefinition& _fun)
 	m_value.swap(value);
 	m_references.swap(references);
 	m_referencedBy.swap(referencedBy);
+	m_valueHashes.swap(valueHashes);
 }
 
 void DataFlowAnalyzer::operator()(ForLoop& _for)
@@ -147,7 +151,10 @@ void DataFlowAnalyzer::handleAssignment(set<YulString> const& _variables, Expres
 		// Expression has to be movable and cannot contain a reference
 		// to the variable that will be assigned to.
 		if (_value && movableChecker.movable() && !movableChecker.referencedVariables().count(name))
+		{
 			m_value[name] = _value;
+			m_valueHashes[SyntacticalEqualityChecker::hash(*_value)].emplace(name);
+		}
 	}
 
 	auto const& referencedVariables = movableChecker.referencedVariables();
@@ -192,7 +199,17 @@ void DataFlowAnalyzer::clearValues(set<YulString> _variables)
 
 	// Clear the value and update the reference relation.
 	for (auto const& name: _variables)
-		m_value.erase(name);
+	{
+		auto value = m_value.find(name);
+		if (value == m_value.end())
+			continue;
+		auto variables = m_valueHashes.find(SyntacticalEqualityChecker::hash(*value->second));
+		assertThrow(variables != m_valueHashes.end(), OptimizerException, "");
+		variables->second.erase(name);
+		if (variables->second.empty())
+			m_valueHashes.erase(variables);
+		m_value.erase(value);
+	}
 	for (auto const& name: _variables)
 	{
 		for (auto const& ref: m_references[name])
@@ -201,6 +218,13 @@ void DataFlowAnalyzer::clearValues(set<YulString> _variables)
 	}
 }
 
+set<YulString> const& DataFlowAnalyzer::variablesWithValue(Expression const& _expression) const
+{
+	static set<YulString> const noVariables;
+	auto variables = m_valueHashes.find(SyntacticalEqualityChecker::hash(_expression));
+	return variables == m_valueHashes.end() ? noVariables : variables->second;
+}
+
 bool DataFlowAnalyzer::inScope(YulString _variableName) const
 {
 	for (auto const& scope: m_variableScopes | boost::adaptors::reversed)
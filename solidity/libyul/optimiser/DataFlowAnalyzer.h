@@ -27,6 +27,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 namespace yul
 {
@@ -67,12 +68,17 @@ protected:
 	/// Returns true iff the variable is in scope.
 	bool inScope(YulString _variableName) const;
 
+	/// @returns the variables whose current value might be syntactically equal to @a _expression.
+	std::set<YulString> const& variablesWithValue(Expression const& _expression) const;
+
 	/// Current values of variables, always movable.
 	std::map<YulString, Expression const*> m_value;
 	/// m_references[a].contains(b) <=> the current expression assigned to a references b
 	std::map<YulString, std::set<YulString>> m_references;
 	/// m_referencedBy[b].contains(a) <=> the current expression assigned to a references b
 	std::map<YulString, std::set<YulString>> m_referencedBy;
+	/// Variables in m_value by the syntactical hash of their current value.
+	std::unordered_map<std::size_t, std::set<YulString>> m_valueHashes;
 
 	struct Scope
 	{
@@ -22,6 +22,8 @@
 
 #include <libyul/optimiser/NameCollector.h>
 #include <libyul/AsmData.h>
+#include <libyul/Exceptions.h>
+
 
 using namespace std;
 using namespace dev;
@@ -33,8 +35,17 @@ NameDispenser::NameDispenser(Block const& _ast):
 }
 
 NameDispenser::NameDispenser(set<YulString> _usedNames):
-	m_usedNames(std::move(_usedNames))
+	m_usedNames(_usedNames.begin(), _usedNames.end())
+{
+}
+
+NameDispenser::NameDispenser(NameDispenser const& _parent, size_t _namespace, size_t _namespaces):
+	m_parentUsedNames(&_parent.m_usedNames),
+	m_namespace(_namespace),
+	m_namespaces(_namespaces)
 {
+	assertThrow(!_parent.m_parentUsedNames, OptimizerException, "Nested name dispenser namespaces.");
+	assertThrow(_namespace < _namespaces, OptimizerException, "");
 }
 
 YulString NameDispenser::newName(YulString _nameHint, YulString _context)
@@ -48,14 +59,38 @@ YulString NameDispenser::newName(YulString _nameHint, YulString _context)
 	return newNameInternal(prefix);
 }
 
+void NameDispenser::adoptNames(NameDispenser const& _child)
+{
+	assertThrow(_child.m_parentUsedNames == &m_usedNames, OptimizerException, "");
+	m_usedNames.insert(_child.m_usedNames.begin(), _child.m_usedNames.end());
+}
+
 YulString NameDispenser::newNameInternal(YulString _nameHint)
 {
-	YulString name = _nameHint;
-	while (name.empty() || m_usedNames.count(name))
+	// Names without decimals could be chosen by several namespaces.
+	if (!m_parentUsedNames && !_nameHint.empty() && !isUsed(_nameHint))
 	{
-		m_counter++;
-		name = YulString(_nameHint.str() + "_" + to_string(m_counter));
+		m_usedNames.emplace(_nameHint);
+		return _nameHint;
+	}
+
+	// Used names have been interned, so candidates that have not been interned yet are
+	// unused and the others are not interned again.
+	string const prefix = _nameHint.str() + "_";
+	size_t& counter = m_counters[_nameHint];
+	YulString name;
+	while (name.empty())
+	{
+		string candidate = prefix + to_string(counter * m_namespaces + m_namespace + 1);
+		counter++;
+		if (!YulStringRepository::instance().contains(candidate) || !isUsed(YulString{candidate}))
+			name = YulString{candidate};
 	}
 	m_usedNames.emplace(name);
 	return name;
 }
+
+bool NameDispenser::isUsed(YulString _name) const
+{
+	return m_usedNames.count(_name) || (m_parentUsedNames && m_parentUsedNames->count(_name));
+}
@@ -24,6 +24,8 @@
 #include <libyul/YulString.h>
 
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace yul
 {
@@ -33,6 +35,8 @@ namespace yul
  * do not conflict with existing names.
  *
  * Tries to keep names short and appends decimals to disambiguate.
+ * The decimals are counted per name hint, so generating a name does not
+ * retry the decimals already taken for the same hint.
  */
 class NameDispenser
 {
@@ -41,6 +45,11 @@ public:
 	explicit NameDispenser(Block const& _ast);
 	/// Initialize the name dispenser with the given used names.
 	explicit NameDispenser(std::set<YulString> _usedNames);
+	/// Initialize a name dispenser for the namespace @a _namespace out of @a _namespaces
+	/// that avoids the names used by @a _parent. Names of different namespaces never
+	/// collide, so their dispensers can be used concurrently. @a _parent must not be
+	/// used while the new dispenser exists.
+	NameDispenser(NameDispenser const& _parent, size_t _namespace, size_t _namespaces);
 
 	/// @returns a currently unused name that should be similar to _nameHint
 	/// and prefixed by _context if present.
@@ -48,11 +57,21 @@ public:
 	/// and the name hint at the start.
 	YulString newName(YulString _nameHint, YulString _context = {});
 
+	/// Marks the names generated by @a _child, which was created from this dispenser, as used.
+	void adoptNames(NameDispenser const& _child);
+
 private:
 	YulString newNameInternal(YulString _nameHint);
+	bool isUsed(YulString _name) const;
 
-	std::set<YulString> m_usedNames;
-	size_t m_counter = 0;
+	std::unordered_set<YulString> m_usedNames;
+	/// Names used by the parent dispenser, if this dispenser belongs to a namespace.
+	std::unordered_set<YulString> const* m_parentUsedNames = nullptr;
+	/// Number of decimals already tried for each name hint.
+	std::unordered_map<YulString, size_t> m_counters;
+	/// The decimals appended to names of namespace i are i + 1 modulo the number of namespaces.
+	size_t m_namespace = 0;
+	size_t m_namespaces = 1;
 };
 
 }
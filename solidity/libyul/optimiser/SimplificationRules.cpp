@@ -33,6 +33,51 @@ using namespace dev;
 using namespace langutil;
 using namespace yul;
 
+namespace
+{
+
+/// Describes Yul expressions for the rule decision tree. Like Pattern::matches, it resolves
+/// variables that are assigned exactly once to their values.
+struct RuleTreeAdapter
+{
+	solidity::RuleTreeSymbol symbol(Expression const& _expr) const
+	{
+		Expression const& expr = resolve(_expr);
+		solidity::RuleTreeSymbol symbol;
+		if (expr.type() == typeid(FunctionalInstruction))
+		{
+			symbol.kind = solidity::RuleTreeSymbol::Kind::Operation;
+			symbol.code = unsigned(boost::get<FunctionalInstruction>(expr).instruction);
+		}
+		else if (expr.type() == typeid(Literal) && boost::get<Literal>(expr).kind == LiteralKind::Number)
+			symbol.kind = solidity::RuleTreeSymbol::Kind::Leaf;
+		return symbol;
+	}
+	u256 value(Expression const& _expr) const
+	{
+		return u256(boost::get<Literal>(resolve(_expr)).value.str());
+	}
+	void pushArguments(Expression const& _expr, vector<Expression const*>& _pending) const
+	{
+		vector<Expression> const& arguments = boost::get<FunctionalInstruction>(resolve(_expr)).arguments;
+		for (auto it = arguments.rbegin(); it != arguments.rend(); ++it)
+			_pending.push_back(&*it);
+	}
+	Expression const& resolve(Expression const& _expr) const
+	{
+		if (_expr.type() == typeid(Identifier))
+		{
+			auto it = ssaValues.find(boost::get<Identifier>(_expr).name);
+			if (it != ssaValues.end())
+				return *it->second;
+		}
+		return _expr;
+	}
+
+	map<YulString, Expression const*> const& ssaValues;
+};
+
+}
 
 SimplificationRule<Pattern> const* SimplificationRules::findFirstMatch(
 	Expression const& _expr,
@@ -42,22 +87,22 @@ SimplificationRule<Pattern> const* SimplificationRules::findFirstMatch(
 	if (_expr.type() != typeid(FunctionalInstruction))
 		return nullptr;
 
-	static SimplificationRules rules;
+	// The match groups are modified during matching, so every thread uses its own rules.
+	static thread_local SimplificationRules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
-	FunctionalInstruction const& instruction = boost::get<FunctionalInstruction>(_expr);
-	for (auto const& rule: rules.m_rules[uint8_t(instruction.instruction)])
+	for (size_t index: rules.m_tree.candidates(_expr, RuleTreeAdapter{_ssaValues}))
 	{
 		rules.resetMatchGroups();
-		if (rule.pattern.matches(_expr, _ssaValues))
-			return &rule;
+		if (rules.m_rules[index].pattern.matches(_expr, _ssaValues))
+			return &rules.m_rules[index];
 	}
 	return nullptr;
 }
 
 bool SimplificationRules::isInitialized() const
 {
-	return !m_rules[uint8_t(solidity::Instruction::ADD)].empty();
+	return !m_rules.empty();
 }
 
 void SimplificationRules::addRules(vector<SimplificationRule<Pattern>> const& _rules)
@@ -68,7 +113,9 @@ void SimplificationRules::addRules(vector<SimplificationRule<Pattern>> const& _r
 
 void SimplificationRules::addRule(SimplificationRule<Pattern> const& _rule)
 {
-	m_rules[uint8_t(_rule.pattern.instruction())].push_back(_rule);
+	assertThrow(_rule.pattern.ruleTreeSymbol().kind == solidity::RuleTreeSymbol::Kind::Operation, OptimizerException, "");
+	m_tree.addRule(m_rules.size(), _rule.pattern);
+	m_rules.push_back(_rule);
 }
 
 SimplificationRules::SimplificationRules()
@@ -180,6 +227,22 @@ bool Pattern::matches(Expression const& _expr, map<YulString, Expression const*>
 	return true;
 }
 
+solidity::RuleTreeSymbol Pattern::ruleTreeSymbol() const
+{
+	solidity::RuleTreeSymbol symbol;
+	if (m_kind == PatternKind::Operation)
+	{
+		symbol.kind = solidity::RuleTreeSymbol::Kind::Operation;
+		symbol.code = unsigned(m_instruction);
+	}
+	else if (m_kind == PatternKind::Constant)
+	{
+		symbol.kind = solidity::RuleTreeSymbol::Kind::Leaf;
+		symbol.value = m_data.get();
+	}
+	return symbol;
+}
+
 solidity::Instruction Pattern::instruction() const
 {
 	assertThrow(m_kind == PatternKind::Operation, OptimizerException, "");
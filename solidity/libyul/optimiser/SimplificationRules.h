@@ -22,6 +22,7 @@
 
 #include <libevmasm/ExpressionClasses.h>
 #include <libevmasm/SimplificationRule.h>
+#include <libevmasm/SimplificationRuleTree.h>
 
 #include <libyul/AsmDataForward.h>
 #include <libyul/AsmData.h>
@@ -62,7 +63,9 @@ private:
 	void resetMatchGroups() { m_matchGroups.clear(); }
 
 	std::map<unsigned, Expression const*> m_matchGroups;
-	std::vector<SimplificationRule<Pattern>> m_rules[256];
+	std::vector<SimplificationRule<Pattern>> m_rules;
+	/// Decision tree over the patterns of m_rules.
+	dev::solidity::SimplificationRuleTree<Pattern> m_tree;
 };
 
 enum class PatternKind
@@ -94,6 +97,8 @@ public:
 	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(Expression const& _expr, std::map<YulString, Expression const*> const& _ssaValues) const;
+	/// @returns the description of this pattern for the rule decision tree.
+	dev::solidity::RuleTreeSymbol ruleTreeSymbol() const;
 
 	std::vector<Pattern> arguments() const { return m_arguments; }
 
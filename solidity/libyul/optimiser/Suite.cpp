@@ -38,83 +38,228 @@
 #include <libyul/AsmAnalysisInfo.h>
 #include <libyul/AsmData.h>
 #include <libyul/AsmPrinter.h>
+#include <libyul/Exceptions.h>
 
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Profiler.h>
+#include <libdevcore/ThreadPool.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
 
 using namespace std;
 using namespace dev;
 using namespace yul;
 
+namespace
+{
+
+/// The state shared by the steps of one run of the optimiser suite.
+struct StepContext
+{
+	Block& ast;
+	NameDispenser& dispenser;
+	set<YulString> const& reservedIdentifiers;
+};
+
+struct OptimiserStep
+{
+	function<void(StepContext&)> run;
+	/// True if the step only looks at one function at a time and can thus be run on
+	/// each function and on the main block separately.
+	bool functionLocal;
+};
+
+/// @returns all optimiser steps that can be run on an already disambiguated block, by name.
+map<string, OptimiserStep> const& optimiserSteps()
+{
+	static map<string, OptimiserStep> const steps{
+		{"CommonSubexpressionEliminator", {[](StepContext& _c) { CommonSubexpressionEliminator{}(_c.ast); }, true}},
+		{"ExpressionInliner", {[](StepContext& _c) { ExpressionInliner(_c.ast).run(); }, false}},
+		{"ExpressionJoiner", {[](StepContext& _c) { ExpressionJoiner::run(_c.ast); }, true}},
+		{"ExpressionSimplifier", {[](StepContext& _c) { ExpressionSimplifier::run(_c.ast); }, true}},
+		{"ExpressionSplitter", {[](StepContext& _c) { ExpressionSplitter{_c.dispenser}(_c.ast); }, true}},
+		{"ForLoopInitRewriter", {[](StepContext& _c) { (ForLoopInitRewriter{})(_c.ast); }, true}},
+		{"FullInliner", {[](StepContext& _c) { FullInliner{_c.ast, _c.dispenser}.run(); }, false}},
+		{"FunctionGrouper", {[](StepContext& _c) { (FunctionGrouper{})(_c.ast); }, false}},
+		{"FunctionHoister", {[](StepContext& _c) { (FunctionHoister{})(_c.ast); }, false}},
+		{"RedundantAssignEliminator", {[](StepContext& _c) { RedundantAssignEliminator::run(_c.ast); }, true}},
+		{"SSATransform", {[](StepContext& _c) { SSATransform::run(_c.ast, _c.dispenser); }, true}},
+		{"UnusedPruner", {[](StepContext& _c) { UnusedPruner::runUntilStabilised(_c.ast, _c.reservedIdentifiers); }, false}},
+		{"VarDeclPropagator", {[](StepContext& _c) { VarDeclPropagator{}(_c.ast); }, true}}
+	};
+	return steps;
+}
+
+/// @returns the step called @a _name.
+OptimiserStep const& optimiserStep(string const& _name)
+{
+	auto step = optimiserSteps().find(_name);
+	yulAssert(step != optimiserSteps().end(), "Unknown optimiser step: " + _name);
+	return step->second;
+}
+
+/// Runs the function-local steps @a _steps on the main block and on each function of the
+/// grouped block in @a _context separately, using up to @a _jobs threads. Every function
+/// gets its own name dispenser namespace, so the result does not depend on @a _jobs.
+void runStepsPerFunction(vector<string> const& _steps, StepContext& _context, size_t _jobs)
+{
+	// The main block might have been removed by the UnusedPruner.
+	vector<Statement>& statements = _context.ast.statements;
+	vector<Block> units(statements.size());
+	vector<NameDispenser> dispensers;
+	for (size_t i = 0; i < statements.size(); ++i)
+	{
+		yulAssert(
+			statements[i].type() == typeid(Block) || statements[i].type() == typeid(FunctionDefinition),
+			"Functions not grouped."
+		);
+		units[i].location = locationOf(statements[i]);
+		units[i].statements.emplace_back(std::move(statements[i]));
+		dispensers.emplace_back(_context.dispenser, i, statements.size());
+	}
+
+	parallelFor(_jobs, units.size(), [&](size_t _unit)
+	{
+		StepContext context{units[_unit], dispensers[_unit], _context.reservedIdentifiers};
+		for (string const& name: _steps)
+		{
+			ProfilerScope scope(name.c_str());
+			optimiserStep(name).run(context);
+		}
+	});
+
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		statements[i] = std::move(units[i].statements.front());
+		_context.dispenser.adoptNames(dispensers[i]);
+	}
+}
+
+/// Runs the steps @a _steps in order, each measured as a phase of the profiler.
+/// If @a _perFunction is set, consecutive function-local steps are run by runStepsPerFunction.
+void runSteps(vector<string> const& _steps, StepContext& _context, bool _perFunction = false, size_t _jobs = 1)
+{
+	for (auto it = _steps.begin(); it != _steps.end();)
+	{
+		if (_perFunction && optimiserStep(*it).functionLocal)
+		{
+			auto end = find_if(it, _steps.end(), [](string const& _name) { return !optimiserStep(_name).functionLocal; });
+			runStepsPerFunction(vector<string>(it, end), _context, _jobs);
+			it = end;
+		}
+		else
+		{
+			ProfilerScope scope(it->c_str());
+			optimiserStep(*it).run(_context);
+			++it;
+		}
+	}
+}
+
+}
+
+vector<string> const& OptimiserSuite::defaultSteps()
+{
+	static vector<string> const steps{
+		"ExpressionSplitter",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"VarDeclPropagator",
+		"RedundantAssignEliminator",
+
+		"CommonSubexpressionEliminator",
+		"ExpressionSimplifier",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"RedundantAssignEliminator",
+		"UnusedPruner",
+		"CommonSubexpressionEliminator",
+		"UnusedPruner",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"RedundantAssignEliminator",
+
+		"ExpressionJoiner",
+		"ExpressionJoiner",
+		"ExpressionInliner",
+		"UnusedPruner",
+
+		"ExpressionSplitter",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"RedundantAssignEliminator",
+		"CommonSubexpressionEliminator",
+		"FullInliner",
+		"VarDeclPropagator",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"VarDeclPropagator",
+		"RedundantAssignEliminator",
+		"ExpressionSimplifier",
+		"CommonSubexpressionEliminator",
+		"SSATransform",
+		"RedundantAssignEliminator",
+		"VarDeclPropagator",
+		"RedundantAssignEliminator",
+		"UnusedPruner"
+	};
+	return steps;
+}
+
+bool OptimiserSuite::isStep(string const& _name)
+{
+	return optimiserSteps().count(_name);
+}
+
 void OptimiserSuite::run(
 	Block& _ast,
 	AsmAnalysisInfo const& _analysisInfo,
-	set<YulString> const& _externallyUsedIdentifiers
+	set<YulString> const& _externallyUsedIdentifiers,
+	vector<string> const& _steps,
+	bool _perFunction,
+	size_t _jobs
 )
 {
-	set<YulString> reservedIdentifiers = _externallyUsedIdentifiers;
+	ProfilerScope profilerScope("YulOptimiser");
 
-	Block ast = boost::get<Block>(Disambiguator(_analysisInfo, reservedIdentifiers)(_ast));
+	set<YulString> reservedIdentifiers = _externallyUsedIdentifiers;
 
-	(FunctionHoister{})(ast);
-	(FunctionGrouper{})(ast);
-	(ForLoopInitRewriter{})(ast);
+	Block ast;
+	{
+		ProfilerScope scope("Disambiguator");
+		ast = boost::get<Block>(Disambiguator(_analysisInfo, reservedIdentifiers)(_ast));
+	}
 
 	NameDispenser dispenser{ast};
+	StepContext context{ast, dispenser, reservedIdentifiers};
 
-	for (size_t i = 0; i < 4; i++)
+	runSteps({"FunctionHoister", "FunctionGrouper", "ForLoopInitRewriter"}, context);
+
+	// Further rounds cannot find anything once a round leaves the code unchanged.
+	string code = AsmPrinter{}(ast);
+	for (size_t round = 0; round < c_maxRounds; round++)
 	{
-		ExpressionSplitter{dispenser}(ast);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		VarDeclPropagator{}(ast);
-		RedundantAssignEliminator::run(ast);
-
-		CommonSubexpressionEliminator{}(ast);
-		ExpressionSimplifier::run(ast);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		RedundantAssignEliminator::run(ast);
-		UnusedPruner::runUntilStabilised(ast, reservedIdentifiers);
-		CommonSubexpressionEliminator{}(ast);
-		UnusedPruner::runUntilStabilised(ast, reservedIdentifiers);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		RedundantAssignEliminator::run(ast);
-
-		ExpressionJoiner::run(ast);
-		ExpressionJoiner::run(ast);
-		ExpressionInliner(ast).run();
-		UnusedPruner::runUntilStabilised(ast);
-
-		ExpressionSplitter{dispenser}(ast);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		RedundantAssignEliminator::run(ast);
-		CommonSubexpressionEliminator{}(ast);
-		FullInliner{ast, dispenser}.run();
-		VarDeclPropagator{}(ast);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		VarDeclPropagator{}(ast);
-		RedundantAssignEliminator::run(ast);
-		ExpressionSimplifier::run(ast);
-		CommonSubexpressionEliminator{}(ast);
-		SSATransform::run(ast, dispenser);
-		RedundantAssignEliminator::run(ast);
-		VarDeclPropagator{}(ast);
-		RedundantAssignEliminator::run(ast);
-		UnusedPruner::runUntilStabilised(ast, reservedIdentifiers);
+		runSteps(_steps, context, _perFunction, _jobs);
+		string optimisedCode = AsmPrinter{}(ast);
+		if (optimisedCode == code)
+			break;
+		code = std::move(optimisedCode);
 	}
-	ExpressionJoiner::run(ast);
-	VarDeclPropagator{}(ast);
-	UnusedPruner::runUntilStabilised(ast);
-	ExpressionJoiner::run(ast);
-	UnusedPruner::runUntilStabilised(ast);
-	ExpressionJoiner::run(ast);
-	VarDeclPropagator{}(ast);
-	UnusedPruner::runUntilStabilised(ast);
-	ExpressionJoiner::run(ast);
-	UnusedPruner::runUntilStabilised(ast);
+
+	runSteps({
+		"ExpressionJoiner",
+		"VarDeclPropagator",
+		"UnusedPruner",
+		"ExpressionJoiner",
+		"UnusedPruner",
+		"ExpressionJoiner",
+		"VarDeclPropagator",
+		"UnusedPruner",
+		"ExpressionJoiner",
+		"UnusedPruner"
+	}, context, _perFunction, _jobs);
 
 	_ast = std::move(ast);
 }
@@ -24,6 +24,8 @@
 #include <libyul/YulString.h>
 
 #include <set>
+#include <string>
+#include <vector>
 
 namespace yul
 {
@@ -36,12 +38,28 @@ struct AsmAnalysisInfo;
 class OptimiserSuite
 {
 public:
+	/// Maximum number of times the steps are repeated.
+	static size_t const c_maxRounds = 4;
+
+	/// Runs the steps @a _steps, referenced by name, repeatedly until they do not change
+	/// the code anymore, but at most c_maxRounds times.
+	/// If @a _perFunction is set, consecutive steps that only look at one function at a time
+	/// are run on each function separately, using up to @a _jobs threads. Only the other
+	/// steps see the whole program. The result does not depend on @a _jobs.
 	static void run(
 		Block& _ast,
 		AsmAnalysisInfo const& _analysisInfo,
 
-		std::set<YulString> const& _externallyUsedIdentifiers = {}
+		std::set<YulString> const& _externallyUsedIdentifiers = {},
+		std::vector<std::string> const& _steps = defaultSteps(),
+		bool _perFunction = false,
+		size_t _jobs = 1
 	);
+
+	/// @returns the names of the steps that are repeated by default.
+	static std::vector<std::string> const& defaultSteps();
+	/// @returns true if @a _name is the name of an optimiser step.
+	static bool isStep(std::string const& _name);
 };
 
 }
@@ -25,6 +25,8 @@
 
 #include <libdevcore/CommonData.h>
 
+#include <boost/functional/hash.hpp>
+
 using namespace std;
 using namespace dev;
 using namespace yul;
@@ -74,3 +76,34 @@ bool SyntacticalEqualityChecker::equalVector(vector<Expression> const& _e1, vect
 		std::equal(begin(_e1), end(_e1), begin(_e2), SyntacticalEqualityChecker::equal);
 
 }
+
+size_t SyntacticalEqualityChecker::hash(Expression const& _e)
+{
+	size_t seed = _e.which();
+	if (_e.type() == typeid(FunctionalInstruction))
+	{
+		auto const& e = boost::get<FunctionalInstruction>(_e);
+		boost::hash_combine(seed, unsigned(e.instruction));
+		for (auto const& argument: e.arguments)
+			boost::hash_combine(seed, hash(argument));
+	}
+	else if (_e.type() == typeid(FunctionCall))
+	{
+		auto const& e = boost::get<FunctionCall>(_e);
+		boost::hash_combine(seed, e.functionName.name.hash());
+		for (auto const& argument: e.arguments)
+			boost::hash_combine(seed, hash(argument));
+	}
+	else if (_e.type() == typeid(Identifier))
+		boost::hash_combine(seed, boost::get<Identifier>(_e).name.hash());
+	else if (_e.type() == typeid(Literal))
+	{
+		auto const& e = boost::get<Literal>(_e);
+		boost::hash_combine(seed, unsigned(e.kind));
+		boost::hash_combine(seed, e.value.hash());
+		boost::hash_combine(seed, e.type.hash());
+	}
+	else
+		assertThrow(false, OptimizerException, "Invalid expression");
+	return seed;
+}
@@ -22,6 +22,7 @@
 
 #include <libyul/AsmDataForward.h>
 
+#include <cstddef>
 #include <vector>
 
 namespace yul
@@ -39,6 +40,8 @@ class SyntacticalEqualityChecker
 {
 public:
 	static bool equal(Expression const& _e1, Expression const& _e2);
+	/// @returns a hash of @a _e that is identical for all expressions equal to @a _e.
+	static std::size_t hash(Expression const& _e);
 
 protected:
 	static bool equalVector(std::vector<Expression> const& _e1, std::vector<Expression> const& _e2);
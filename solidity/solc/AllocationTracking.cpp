@@ -0,0 +1,115 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Replacement of the global allocation functions, which counts the allocated bytes for the
+ * peak allocations reported by --time-passes and the "profiling" setting.
+ * Only built with the CMake option SOLC_COUNT_ALLOCATIONS, since every allocation carries
+ * a header that records its size and the thread it is counted for.
+ */
+
+#include <libdevcore/Profiler.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+struct AllocationCountingEnabler
+{
+	AllocationCountingEnabler() { dev::Profiler::enableAllocationCounting(); }
+} const s_allocationCountingEnabler;
+
+struct Header
+{
+	/// Counter of the allocating thread, or null if no profiler was active.
+	dev::Profiler::AllocationCounter* counter;
+	std::size_t size;
+};
+static_assert(sizeof(Header) % alignof(std::max_align_t) == 0, "Header breaks the alignment.");
+
+void* allocate(std::size_t _size) noexcept
+{
+	Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + _size));
+	if (!header)
+		return nullptr;
+	header->size = _size;
+	header->counter = dev::Profiler::active() ? dev::Profiler::allocated(_size) : nullptr;
+	return header + 1;
+}
+
+void* allocateOrThrow(std::size_t _size)
+{
+	void* memory = allocate(_size);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void deallocate(void* _memory) noexcept
+{
+	if (!_memory)
+		return;
+	Header* header = static_cast<Header*>(_memory) - 1;
+	// Memory freed by another thread is subtracted from the counter of the allocating thread.
+	if (header->counter)
+		dev::Profiler::deallocated(header->counter, header->size);
+	std::free(header);
+}
+
+}
+
+void* operator new(std::size_t _size)
+{
+	return allocateOrThrow(_size);
+}
+
+void* operator new[](std::size_t _size)
+{
+	return allocateOrThrow(_size);
+}
+
+void* operator new(std::size_t _size, std::nothrow_t const&) noexcept
+{
+	return allocate(_size);
+}
+
+void* operator new[](std::size_t _size, std::nothrow_t const&) noexcept
+{
+	return allocate(_size);
+}
+
+void operator delete(void* _memory) noexcept
+{
+	deallocate(_memory);
+}
+
+void operator delete[](void* _memory) noexcept
+{
+	deallocate(_memory);
+}
+
+void operator delete(void* _memory, std::nothrow_t const&) noexcept
+{
+	deallocate(_memory);
+}
+
+void operator delete[](void* _memory, std::nothrow_t const&) noexcept
+{
+	deallocate(_memory);
+}
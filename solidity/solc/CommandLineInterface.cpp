@@ -34,6 +34,8 @@
 #include <liblangutil/Exceptions.h>
 #include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/interface/StandardCompiler.h>
+#include <libsolidity/interface/CompilationCache.h>
+#include <libsolidity/interface/CompilerServer.h>
 #include <liblangutil/SourceReferenceFormatter.h>
 #include <libsolidity/interface/GasEstimator.h>
 #include <libsolidity/interface/AssemblyStack.h>
@@ -45,10 +47,12 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/JSON.h>
+#include <libdevcore/Profiler.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
 
 #ifdef _WIN32 // windows
 	#include <io.h>
@@ -60,6 +64,10 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <list>
 
 using namespace std;
 using namespace langutil;
@@ -99,6 +107,9 @@ static string const g_strAstJson = "ast-json";
 static string const g_strAstCompactJson = "ast-compact-json";
 static string const g_strBinary = "bin";
 static string const g_strBinaryRuntime = "bin-runtime";
+static string const g_strCacheDir = "cache-dir";
+static string const g_strCacheSize = "cache-size";
+static string const g_strCacheStatistics = "cache-stats";
 static string const g_strCombinedJson = "combined-json";
 static string const g_strCompactJSON = "compact-format";
 static string const g_strContracts = "contracts";
@@ -110,7 +121,10 @@ static string const g_strGas = "gas";
 static string const g_strHelp = "help";
 static string const g_strInputFile = "input-file";
 static string const g_strInterface = "interface";
+static string const g_strJobs = "jobs";
 static string const g_strYul = "yul";
+static string const g_strYulOptimizerPerFunction = "yul-optimizer-per-function";
+static string const g_strYulOptimizerSteps = "yul-optimizer-steps";
 static string const g_strLicense = "license";
 static string const g_strLibraries = "libraries";
 static string const g_strLink = "link";
@@ -124,6 +138,8 @@ static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
+static string const g_strServer = "server";
+static string const g_strServerSocket = "server-socket";
 static string const g_strSignatureHashes = "hashes";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
@@ -131,6 +147,7 @@ static string const g_strSrcMap = "srcmap";
 static string const g_strSrcMapRuntime = "srcmap-runtime";
 static string const g_strStandardJSON = "standard-json";
 static string const g_strStrictAssembly = "strict-assembly";
+static string const g_strTimePasses = "time-passes";
 static string const g_strPrettyJson = "pretty-json";
 static string const g_strVersion = "version";
 static string const g_strIgnoreMissingFiles = "ignore-missing";
@@ -146,12 +163,18 @@ static string const g_argAstCompactJson = g_strAstCompactJson;
 static string const g_argAstJson = g_strAstJson;
 static string const g_argBinary = g_strBinary;
 static string const g_argBinaryRuntime = g_strBinaryRuntime;
+static string const g_argCacheDir = g_strCacheDir;
+static string const g_argCacheSize = g_strCacheSize;
+static string const g_argCacheStatistics = g_strCacheStatistics;
 static string const g_argCombinedJson = g_strCombinedJson;
 static string const g_argCompactJSON = g_strCompactJSON;
 static string const g_argGas = g_strGas;
 static string const g_argHelp = g_strHelp;
 static string const g_argInputFile = g_strInputFile;
+static string const g_argJobs = g_strJobs;
 static string const g_argYul = g_strYul;
+static string const g_argYulOptimizerPerFunction = g_strYulOptimizerPerFunction;
+static string const g_argYulOptimizerSteps = g_strYulOptimizerSteps;
 static string const g_argLibraries = g_strLibraries;
 static string const g_argLink = g_strLink;
 static string const g_argMachine = g_strMachine;
@@ -163,9 +186,12 @@ static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
 static string const g_argOutputDir = g_strOutputDir;
+static string const g_argServer = g_strServer;
+static string const g_argServerSocket = g_strServerSocket;
 static string const g_argSignatureHashes = g_strSignatureHashes;
 static string const g_argStandardJSON = g_strStandardJSON;
 static string const g_argStrictAssembly = g_strStrictAssembly;
+static string const g_argTimePasses = g_strTimePasses;
 static string const g_argVersion = g_strVersion;
 static string const g_stdinFileName = g_stdinFileNameStr;
 static string const g_argIgnoreMissingFiles = g_strIgnoreMissingFiles;
@@ -599,7 +625,17 @@ Allowed options)",
 			"Set for how many contract runs to optimize."
 			"Lower values will optimize more for initial deployment cost, higher values will optimize more for high-frequency usage."
 		)
+		(
+			g_argJobs.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Number of threads used to analyse independent sources and to generate and optimise the code of independent contracts in parallel."
+		)
 		(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")
+		(
+			g_argTimePasses.c_str(),
+			"Print the wall time, the number of calls and the peak allocation of every compiler phase "
+			"per contract to stderr. Use the \"profiling\" setting in Standard JSON mode."
+		)
 		(
 			g_argLibraries.c_str(),
 			po::value<vector<string>>()->value_name("libs"),
@@ -624,6 +660,30 @@ Allowed options)",
 			"Switch to Standard JSON input / output mode, ignoring all options. "
 			"It reads from standard input and provides the result on the standard output."
 		)
+		(
+			g_argCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Directory of a persistent cache of compilation results in Standard JSON mode. "
+			"Inputs that were compiled before with the same compiler version and the same imported files "
+			"are not compiled again."
+		)
+		(
+			g_argCacheSize.c_str(),
+			po::value<unsigned>()->value_name("MiB")->default_value(1024),
+			"Maximum size of the compilation cache. The least recently used results are removed first."
+		)
+		(g_argCacheStatistics.c_str(), "Print the hit and miss statistics of the compilation cache to stderr.")
+		(
+			g_argServer.c_str(),
+			"Switch to compiler server mode, ignoring all options except --allow-paths, --jobs and --server-socket. "
+			"It reads Standard JSON requests from standard input until it ends and handles up to --jobs of them "
+			"concurrently. The compiled contracts of the 32 most recently used projects are kept to speed up later requests."
+		)
+		(
+			g_argServerSocket.c_str(),
+			po::value<string>()->value_name("path"),
+			"Unix domain socket the compiler server listens on instead of standard input."
+		)
 		(
 			g_argAssemble.c_str(),
 			"Switch to assembly mode, ignoring all options except --machine and --optimize and assumes input is assembly."
@@ -632,6 +692,17 @@ Allowed options)",
 			g_argYul.c_str(),
 			"Switch to Yul mode, ignoring all options except --machine and --optimize and assumes input is Yul."
 		)
+		(
+			g_argYulOptimizerSteps.c_str(),
+			po::value<string>()->value_name("steps"),
+			"Comma-separated list of Yul optimizer steps that are repeated until they do not change the code anymore "
+			"in Yul or strict assembly mode with --optimize."
+		)
+		(
+			g_argYulOptimizerPerFunction.c_str(),
+			"Run the Yul optimizer steps that only look at one function at a time on each function separately, "
+			"using up to --jobs threads, in Yul or strict assembly mode with --optimize."
+		)
 		(
 			g_argStrictAssembly.c_str(),
 			"Switch to strict assembly mode, ignoring all options except --machine and --optimize and assumes input is strict assembly."
@@ -726,7 +797,8 @@ Allowed options)",
 
 bool CommandLineInterface::processInput()
 {
-	ReadCallback::Callback fileReader = [this](string const& _path)
+	// Does not modify the state of the interface, so that the compiler server can use it concurrently.
+	ReadCallback::Callback readAllowedFile = [this](string const& _path)
 	{
 		try
 		{
@@ -754,9 +826,7 @@ bool CommandLineInterface::processInput()
 			if (!boost::filesystem::is_regular_file(canonicalPath))
 				return ReadCallback::Result{false, "Not a valid file."};
 
-			auto contents = dev::readFileAsString(canonicalPath.string());
-			m_sourceCodes[path.generic_string()] = contents;
-			return ReadCallback::Result{true, contents};
+			return ReadCallback::Result{true, dev::readFileAsString(canonicalPath.string())};
 		}
 		catch (Exception const& _exception)
 		{
@@ -767,6 +837,14 @@ bool CommandLineInterface::processInput()
 			return ReadCallback::Result{false, "Unknown exception in read callback."};
 		}
 	};
+	// Also records the files that are read, so that they can be output together with the sources.
+	ReadCallback::Callback fileReader = [this, readAllowedFile](string const& _path)
+	{
+		ReadCallback::Result result = readAllowedFile(_path);
+		if (result.success)
+			m_sourceCodes[boost::filesystem::path(_path).generic_string()] = result.responseOrErrorMessage;
+		return result;
+	};
 
 	if (m_args.count(g_argAllowPaths))
 	{
@@ -784,14 +862,27 @@ bool CommandLineInterface::processInput()
 		}
 	}
 
+	if (m_args.count(g_argServer))
+		return serve(readAllowedFile);
+
 	if (m_args.count(g_argStandardJSON))
 	{
 		string input = dev::readStandardInput();
-		StandardCompiler compiler(fileReader);
-		sout() << compiler.compile(input) << endl;
+		if (m_args.count(g_argCacheDir))
+			sout() << compileStandardJSONCached(input, fileReader) << endl;
+		else
+		{
+			StandardCompiler compiler(fileReader);
+			sout() << compiler.compile(input) << endl;
+		}
 		return true;
 	}
 
+	// Statistics are collected until the end of this function and printed by actOnInput.
+	unique_ptr<ProfilerActivation> profilerActivation;
+	if (m_args.count(g_argTimePasses))
+		profilerActivation.reset(new ProfilerActivation(m_profiler));
+
 	if (!readInputFilesAndConfigureRemappings())
 		return false;
 
@@ -847,7 +938,25 @@ bool CommandLineInterface::processInput()
 				endl;
 			return false;
 		}
-		return assemble(inputLanguage, targetMachine, optimize);
+		vector<string> optimizerSteps = yul::OptimiserSuite::defaultSteps();
+		if (m_args.count(g_argYulOptimizerSteps))
+		{
+			boost::split(optimizerSteps, m_args[g_argYulOptimizerSteps].as<string>(), boost::is_any_of(","));
+			for (string const& step: optimizerSteps)
+				if (!yul::OptimiserSuite::isStep(step))
+				{
+					serr() << "Invalid Yul optimizer step: " << step << endl;
+					return false;
+				}
+		}
+		return assemble(
+			inputLanguage,
+			targetMachine,
+			optimize,
+			optimizerSteps,
+			m_args.count(g_argYulOptimizerPerFunction),
+			m_args[g_argJobs].as<unsigned>()
+		);
 	}
 	if (m_args.count(g_argLink))
 	{
@@ -876,6 +985,7 @@ bool CommandLineInterface::processInput()
 		bool optimize = m_args.count(g_argOptimize) > 0;
 		unsigned runs = m_args[g_argOptimizeRuns].as<unsigned>();
 		m_compiler->setOptimiserSettings(optimize, runs);
+		m_compiler->setParallelism(m_args[g_argJobs].as<unsigned>());
 
 		bool successful = m_compiler->compile();
 
@@ -935,6 +1045,124 @@ bool CommandLineInterface::processInput()
 	return true;
 }
 
+bool CommandLineInterface::serve(ReadCallback::Callback const& _fileReader)
+{
+	CompilerServer server(_fileReader, m_args[g_argJobs].as<unsigned>());
+	if (!m_args.count(g_argServerSocket))
+	{
+		if (!server.serve(cin, sout()))
+		{
+			serr() << "Malformed request frame, stopping." << endl;
+			return false;
+		}
+		return true;
+	}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+	using boost::asio::local::stream_protocol;
+	string path = m_args[g_argServerSocket].as<string>();
+	// Every connection is served by its own thread, while the requests share the workers of the server.
+	struct Connection
+	{
+		thread worker;
+		shared_ptr<atomic<bool>> finished;
+	};
+	list<Connection> connections;
+	try
+	{
+		boost::asio::io_service ioService;
+		boost::filesystem::remove(path);
+		stream_protocol::acceptor acceptor(ioService, stream_protocol::endpoint(path));
+		while (true)
+		{
+			shared_ptr<stream_protocol::iostream> stream = make_shared<stream_protocol::iostream>();
+			acceptor.accept(*stream->rdbuf());
+			// The threads of closed connections are joined whenever a new connection is accepted.
+			for (auto it = connections.begin(); it != connections.end();)
+				if (*it->finished)
+				{
+					it->worker.join();
+					it = connections.erase(it);
+				}
+				else
+					++it;
+			auto finished = make_shared<atomic<bool>>(false);
+			connections.push_back(Connection{
+				thread([&server, stream, finished]() { server.serve(*stream, *stream); *finished = true; }),
+				finished
+			});
+		}
+	}
+	catch (exception const& _exception)
+	{
+		serr() << "Compiler server error on " << path << ": " << _exception.what() << endl;
+	}
+	for (Connection& connection: connections)
+		connection.worker.join();
+	return false;
+#else
+	serr() << "Unix domain sockets are not supported on this platform." << endl;
+	return false;
+#endif
+}
+
+string CommandLineInterface::compileStandardJSONCached(string const& _input, ReadCallback::Callback const& _fileReader)
+{
+	unique_ptr<CompilationCache> cache;
+	boost::optional<string> output;
+	try
+	{
+		cache.reset(new CompilationCache(
+			m_args[g_argCacheDir].as<string>(),
+			uint64_t(m_args[g_argCacheSize].as<unsigned>()) * 1024 * 1024
+		));
+		output = cache->lookup(_input, _fileReader);
+	}
+	catch (boost::filesystem::filesystem_error const& _error)
+	{
+		serr() << "Compilation cache not available: " << _error.what() << endl;
+		cache.reset();
+	}
+
+	if (!output)
+	{
+		// Collect the files read during the compilation, which the result depends on.
+		m_sourceCodes.clear();
+		StandardCompiler compiler(_fileReader);
+		output = compiler.compile(_input);
+
+		// Results with errors are not stored, since they might be caused by missing files.
+		// Neither are profiling statistics, which are only valid for one compilation.
+		Json::Value json;
+		bool success = jsonParseStrict(*output, json) && json.isObject() && !json.isMember("profiling");
+		for (Json::Value const& error: json["errors"])
+			if (error["severity"].asString() == "error")
+				success = false;
+		if (cache && success)
+			try
+			{
+				cache->store(_input, m_sourceCodes, *output);
+			}
+			catch (boost::filesystem::filesystem_error const& _error)
+			{
+				serr() << "Could not store result in compilation cache: " << _error.what() << endl;
+			}
+	}
+
+	if (cache && m_args.count(g_argCacheStatistics))
+	{
+		CompilationCache::Statistics total = cache->totalStatistics();
+		serr() <<
+			"Compilation cache: " <<
+			total.hits << " hits, " <<
+			total.misses << " misses, " <<
+			total.stores << " stores, " <<
+			total.evictions << " evictions" <<
+			endl;
+	}
+	return *output;
+}
+
 void CommandLineInterface::handleCombinedJSON()
 {
 	if (!m_args.count(g_argCombinedJson))
@@ -1091,7 +1319,10 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 bool CommandLineInterface::actOnInput()
 {
-	if (m_args.count(g_argStandardJSON) || m_onlyAssemble)
+	if (m_args.count(g_argTimePasses) && !m_args.count(g_argStandardJSON))
+		outputProfilerStatistics();
+
+	if (m_args.count(g_argStandardJSON) || m_args.count(g_argServer) || m_onlyAssemble)
 		// Already done in "processInput" phase.
 		return true;
 	else if (m_onlyLink)
@@ -1101,6 +1332,38 @@ bool CommandLineInterface::actOnInput()
 	return !m_error;
 }
 
+void CommandLineInterface::outputProfilerStatistics()
+{
+	auto printPhases = [](Profiler::Phases const& _phases)
+	{
+		serr(false) << left << setw(64) << "Phase" << right << setw(10) << "Calls" << setw(14) << "Time (ms)";
+		if (Profiler::countsAllocations())
+			serr(false) << setw(20) << "Peak alloc. (KiB)";
+		serr(false) << setw(20) << "Changed blocks";
+		serr(false) << endl;
+		for (auto const& phase: _phases)
+		{
+			serr(false) <<
+				left << setw(64) << phase.first <<
+				right << setw(10) << phase.second.calls <<
+				setw(14) << fixed << setprecision(3) << (phase.second.seconds * 1000);
+			if (Profiler::countsAllocations())
+				serr(false) << setw(20) << (phase.second.peakAllocation / 1024);
+			if (phase.second.blocks > 0)
+				serr(false) << setw(20) << (to_string(phase.second.changedBlocks) + " / " + to_string(phase.second.blocks));
+			serr(false) << endl;
+		}
+	};
+
+	serr(false) << endl << "======= Compiler phases =======" << endl;
+	printPhases(m_profiler.phases());
+	for (auto const& contract: m_profiler.contractPhases())
+	{
+		serr(false) << endl << "======= " << contract.first << " =======" << endl;
+		printPhases(contract.second);
+	}
+}
+
 bool CommandLineInterface::link()
 {
 	// Map from how the libraries will be named inside the bytecode to their addresses.
@@ -1192,7 +1455,10 @@ string CommandLineInterface::objectWithLinkRefsHex(eth::LinkerObject const& _obj
 bool CommandLineInterface::assemble(
 	AssemblyStack::Language _language,
 	AssemblyStack::Machine _targetMachine,
-	bool _optimize
+	bool _optimize,
+	vector<string> const& _optimizerSteps,
+	bool _optimizePerFunction,
+	size_t _jobs
 )
 {
 	bool successful = true;
@@ -1205,7 +1471,7 @@ bool CommandLineInterface::assemble(
 			if (!stack.parseAndAnalyze(src.first, src.second))
 				successful = false;
 			else if (_optimize)
-				stack.optimize();
+				stack.optimize(_optimizerSteps, _optimizePerFunction, _jobs);
 		}
 		catch (Exception const& _exception)
 		{
@@ -25,6 +25,8 @@
 #include <libsolidity/interface/AssemblyStack.h>
 #include <liblangutil/EVMVersion.h>
 
+#include <libdevcore/Profiler.h>
+
 #include <boost/program_options.hpp>
 #include <boost/filesystem/path.hpp>
 
@@ -59,9 +61,26 @@ private:
 	/// @returns the full object with library placeholder hints in hex.
 	static std::string objectWithLinkRefsHex(eth::LinkerObject const& _obj);
 
-	bool assemble(AssemblyStack::Language _language, AssemblyStack::Machine _targetMachine, bool _optimize);
+	bool assemble(
+		AssemblyStack::Language _language,
+		AssemblyStack::Machine _targetMachine,
+		bool _optimize,
+		std::vector<std::string> const& _optimizerSteps,
+		bool _optimizePerFunction,
+		size_t _jobs
+	);
+
+	/// Runs the compiler server on standard input and output or on the socket given by --server-socket.
+	/// @a _fileReader is called concurrently and must not modify the state of the interface.
+	bool serve(ReadCallback::Callback const& _fileReader);
+
+	/// Compiles the standard JSON @a _input, using the compilation cache given by --cache-dir.
+	/// @returns the standard JSON output.
+	std::string compileStandardJSONCached(std::string const& _input, ReadCallback::Callback const& _fileReader);
 
 	void outputCompilationResults();
+	/// Prints the statistics collected for --time-passes.
+	void outputProfilerStatistics();
 
 	void handleCombinedJSON();
 	void handleAst(std::string const& _argStr);
@@ -111,6 +130,8 @@ private:
 	std::unique_ptr<dev::solidity::CompilerStack> m_compiler;
 	/// EVM version to use
 	EVMVersion m_evmVersion;
+	/// Statistics of the compiler phases, collected if requested
+	Profiler m_profiler;
 };
 
 }
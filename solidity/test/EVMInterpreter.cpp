@@ -0,0 +1,1179 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * In-process EVM interpreter that replaces an external node for executing contracts in tests.
+ */
+
+#include <test/EVMInterpreter.h>
+#include <test/EVMPrecompiles.h>
+
+#include <libevmasm/GasMeter.h>
+#include <libevmasm/Instruction.h>
+
+#include <liblangutil/Exceptions.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/Keccak256.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::solidity;
+using namespace dev::test;
+
+struct EVMInterpreter::Message
+{
+	h160 sender;
+	/// Account whose storage and balance is used by the code.
+	h160 recipient;
+	h160 codeAddress;
+	u256 value;
+	/// False for DELEGATECALL, which only forwards the value of the caller.
+	bool transfersValue;
+	bytes input;
+	int64_t gas;
+	unsigned depth;
+	bool isStatic;
+};
+
+struct EVMInterpreter::ExecutionResult
+{
+	enum class Status { Success, Revert, Failure };
+
+	Status status;
+	/// Return data or revert data.
+	bytes output;
+	int64_t gasLeft;
+};
+
+namespace
+{
+
+size_t const c_maxCallDepth = 1024;
+size_t const c_maxCodeSize = 0x6000;
+u256 const c_difficulty = 131072;
+/// Timestamp of the genesis block, fixed to keep test runs reproducible.
+u256 const c_genesisTimestamp = 1546300800;
+u256 const c_accountBalance("0x100000000000000000000000000000000000000000");
+/// Costs of SSTORE under net gas metering if the slot was already written in the transaction.
+int64_t const c_sstoreDirtyGas = 200;
+
+h160 asAddress(u256 const& _value)
+{
+	return h160(h256(_value), h160::AlignRight);
+}
+
+u256 asWord(h160 const& _address)
+{
+	return u256(h256(_address, h256::AlignRight));
+}
+
+h160 createAddress(h160 const& _sender, u256 const& _nonce)
+{
+	bytes nonce;
+	if (_nonce == 0)
+		nonce = bytes{0x80};
+	else if (_nonce < 0x80)
+		nonce = bytes{uint8_t(_nonce)};
+	else
+	{
+		nonce = toCompactBigEndian(_nonce);
+		nonce.insert(nonce.begin(), uint8_t(0x80 + nonce.size()));
+	}
+	bytes payload = bytes{0x94} + _sender.asBytes() + nonce;
+	return h160(keccak256(bytes{uint8_t(0xc0 + payload.size())} + payload), h160::AlignRight);
+}
+
+h160 create2Address(h160 const& _sender, u256 const& _salt, bytes const& _initCode)
+{
+	return h160(
+		keccak256(bytes{0xff} + _sender.asBytes() + toBigEndian(_salt) + keccak256(_initCode).asBytes()),
+		h160::AlignRight
+	);
+}
+
+int64_t memoryCost(uint64_t _words)
+{
+	return int64_t(GasCosts::memoryGas * _words + _words * _words / GasCosts::quadCoeffDiv);
+}
+
+uint64_t words(uint64_t _size)
+{
+	return (_size + 31) / 32;
+}
+
+/// Copies @a _size bytes of @a _source starting at @a _offset to @a _target, padding with zeros.
+void copyPadded(uint8_t* _target, bytes const& _source, u256 const& _offset, uint64_t _size)
+{
+	uint64_t copied = 0;
+	if (_offset < _source.size())
+	{
+		copied = min<uint64_t>(_size, _source.size() - uint64_t(_offset));
+		memcpy(_target, _source.data() + uint64_t(_offset), copied);
+	}
+	memset(_target + copied, 0, _size - copied);
+}
+
+}
+
+EVMInterpreter::EVMInterpreter(EVMVersion _evmVersion):
+	m_evmVersion(_evmVersion),
+	m_gasLimit("0x1000000000000"),
+	m_coinbase("0000000000000010000000000000000000000000")
+{
+	for (unsigned opcode = 0; opcode < 256; ++opcode)
+	{
+		Instruction instruction = Instruction(opcode);
+		if (!isValidInstruction(instruction) || instruction == Instruction::INVALID)
+			continue;
+		InstructionInfo info = instructionInfo(instruction);
+		OpcodeInfo& opcodeInfo = m_opcodes[opcode];
+		opcodeInfo.args = unsigned(info.args);
+		opcodeInfo.ret = unsigned(info.ret);
+		switch (info.gasPriceTier)
+		{
+		case Tier::ExtCode:
+			opcodeInfo.gas = GasCosts::extCodeGas(m_evmVersion);
+			break;
+		case Tier::Balance:
+			opcodeInfo.gas = GasCosts::balanceGas(m_evmVersion);
+			break;
+		case Tier::Special:
+			// The costs are computed during execution.
+			opcodeInfo.gas = instruction == Instruction::JUMPDEST ? GasCosts::jumpdestGas : 0;
+			break;
+		default:
+			opcodeInfo.gas = GasMeter::runGas(instruction);
+			break;
+		}
+		switch (instruction)
+		{
+		case Instruction::RETURNDATASIZE:
+		case Instruction::RETURNDATACOPY:
+			opcodeInfo.valid = m_evmVersion.supportsReturndata();
+			break;
+		case Instruction::STATICCALL:
+			opcodeInfo.valid = m_evmVersion.hasStaticCall();
+			break;
+		case Instruction::REVERT:
+			opcodeInfo.valid = m_evmVersion >= EVMVersion::byzantium();
+			break;
+		case Instruction::SHL:
+		case Instruction::SHR:
+		case Instruction::SAR:
+			opcodeInfo.valid = m_evmVersion.hasBitwiseShifting();
+			break;
+		case Instruction::CREATE2:
+			opcodeInfo.valid = m_evmVersion.hasCreate2();
+			break;
+		case Instruction::EXTCODEHASH:
+			opcodeInfo.valid = m_evmVersion >= EVMVersion::constantinople();
+			break;
+		default:
+			opcodeInfo.valid = true;
+			break;
+		}
+	}
+
+	Block genesis;
+	genesis.number = 0;
+	genesis.timestamp = c_genesisTimestamp;
+	genesis.coinbase = m_coinbase;
+	m_blocks.push_back(genesis);
+
+	// The precompiled contracts are funded such that they are never considered empty.
+	for (unsigned address = 1; address <= 8; ++address)
+		m_state[asAddress(address)].balance = 1;
+}
+
+EVMInterpreter::TransactionResult EVMInterpreter::transact(
+	h160 const& _from,
+	boost::optional<h160> const& _to,
+	u256 const& _value,
+	bytes const& _data,
+	u256 const& _gas,
+	u256 const& _gasPrice
+)
+{
+	TransactionResult result;
+	result.blockNumber = latestBlock().number;
+
+	bigint intrinsicGas = _to ? GasCosts::txGas : GasCosts::txCreateGas;
+	for (uint8_t byte: _data)
+		intrinsicGas += byte ? GasCosts::txDataNonZeroGas : GasCosts::txDataZeroGas;
+	Account const* sender = accountAt(_from);
+	if (
+		_gas > u256(numeric_limits<int64_t>::max()) ||
+		intrinsicGas > _gas ||
+		!sender ||
+		bigint(sender->balance) < bigint(_gas) * _gasPrice + _value
+	)
+		// Invalid transactions are not included in a block.
+		return result;
+
+	newBlock();
+	result.blockNumber = latestBlock().number;
+	m_journal.clear();
+	m_originalStorage.clear();
+	m_origin = _from;
+	m_gasPrice = _gasPrice;
+	m_refund = 0;
+	m_logs.clear();
+	m_selfdestructs.clear();
+
+	u256 nonce = sender->nonce;
+	setBalance(_from, sender->balance - _gas * _gasPrice);
+	setNonce(_from, nonce + 1);
+
+	Message message;
+	message.sender = _from;
+	message.value = _value;
+	message.transfersValue = true;
+	message.gas = int64_t(_gas) - int64_t(intrinsicGas);
+	message.depth = 0;
+	message.isStatic = false;
+	ExecutionResult execution;
+	if (_to)
+	{
+		message.recipient = message.codeAddress = *_to;
+		message.input = _data;
+		execution = call(message);
+	}
+	else
+	{
+		message.recipient = message.codeAddress = createAddress(_from, nonce);
+		result.createdAddress = message.recipient;
+		execution = create(message, _data);
+	}
+
+	int64_t gasUsed = int64_t(_gas) - execution.gasLeft;
+	gasUsed -= min(m_refund, gasUsed / 2);
+	setBalance(_from, accountAt(_from)->balance + (_gas - gasUsed) * _gasPrice);
+	setBalance(latestBlock().coinbase, touch(latestBlock().coinbase).balance + gasUsed * _gasPrice);
+
+	for (h160 const& address: m_selfdestructs)
+		m_state.erase(address);
+	if (m_evmVersion >= EVMVersion::spuriousDragon())
+		for (auto it = m_state.begin(); it != m_state.end();)
+		{
+			if (isEmpty(it->first))
+				it = m_state.erase(it);
+			else
+				++it;
+		}
+	m_journal.clear();
+
+	result.success = execution.status == ExecutionResult::Status::Success;
+	result.gasUsed = gasUsed;
+	result.logs = m_logs;
+	if (_to)
+		result.output = move(execution.output);
+	else if (result.success)
+		result.output = accountAt(result.createdAddress)->code;
+	return result;
+}
+
+void EVMInterpreter::mineBlocks(unsigned _number)
+{
+	for (unsigned i = 0; i < _number; ++i)
+		newBlock();
+}
+
+EVMInterpreter::Block const& EVMInterpreter::block(u256 const& _number) const
+{
+	solAssert(_number < m_blocks.size(), "Block " + _number.str() + " does not exist.");
+	return m_blocks[size_t(_number)];
+}
+
+h160 EVMInterpreter::account(size_t _index)
+{
+	auto it = m_accounts.find(_index);
+	if (it != m_accounts.end())
+		return it->second;
+	h160 address(keccak256("account" + to_string(_index)), h160::AlignRight);
+	m_state[address].balance = c_accountBalance;
+	m_accounts[_index] = address;
+	return address;
+}
+
+EVMInterpreter::Account const* EVMInterpreter::accountAt(h160 const& _address) const
+{
+	auto it = m_state.find(_address);
+	return it == m_state.end() ? nullptr : &it->second;
+}
+
+EVMInterpreter::ExecutionResult EVMInterpreter::call(Message const& _message)
+{
+	size_t checkpoint = m_journal.size();
+	ExecutionResult result{ExecutionResult::Status::Success, {}, _message.gas};
+	if (_message.transfersValue)
+		transfer(_message.sender, _message.recipient, _message.value);
+
+	if (isPrecompiled(_message.codeAddress, m_evmVersion))
+	{
+		bigint cost = precompiledGas(_message.codeAddress, bytesConstRef(&_message.input));
+		boost::optional<bytes> output;
+		if (cost <= _message.gas)
+			output = executePrecompiled(_message.codeAddress, bytesConstRef(&_message.input));
+		if (output)
+		{
+			result.output = move(*output);
+			result.gasLeft = _message.gas - int64_t(cost);
+		}
+		else
+			result.status = ExecutionResult::Status::Failure;
+	}
+	else if (Account const* account = accountAt(_message.codeAddress))
+		if (!account->code.empty())
+			result = execute(_message, account->code);
+
+	if (result.status != ExecutionResult::Status::Success)
+		revert(checkpoint);
+	if (result.status == ExecutionResult::Status::Failure)
+		result.gasLeft = 0;
+	return result;
+}
+
+EVMInterpreter::ExecutionResult EVMInterpreter::create(Message const& _message, bytes const& _initCode)
+{
+	h160 const& address = _message.recipient;
+	if (Account const* account = accountAt(address))
+		if (account->nonce != 0 || !account->code.empty())
+			return {ExecutionResult::Status::Failure, {}, 0};
+
+	size_t checkpoint = m_journal.size();
+	touch(address);
+	if (m_evmVersion >= EVMVersion::spuriousDragon())
+		setNonce(address, 1);
+	transfer(_message.sender, address, _message.value);
+
+	ExecutionResult result = execute(_message, _initCode);
+	if (result.status == ExecutionResult::Status::Success)
+	{
+		int64_t depositCost = int64_t(GasCosts::createDataGas * result.output.size());
+		if (
+			depositCost > result.gasLeft ||
+			(m_evmVersion >= EVMVersion::spuriousDragon() && result.output.size() > c_maxCodeSize)
+		)
+			result.status = ExecutionResult::Status::Failure;
+		else
+		{
+			result.gasLeft -= depositCost;
+			setCode(address, move(result.output));
+			result.output.clear();
+		}
+	}
+
+	if (result.status != ExecutionResult::Status::Success)
+		revert(checkpoint);
+	if (result.status == ExecutionResult::Status::Failure)
+	{
+		result.gasLeft = 0;
+		result.output.clear();
+	}
+	return result;
+}
+
+EVMInterpreter::ExecutionResult EVMInterpreter::execute(Message const& _message, bytes const& _code)
+{
+	using Status = ExecutionResult::Status;
+
+	vector<bool> jumpdests(_code.size(), false);
+	for (size_t i = 0; i < _code.size(); ++i)
+		if (_code[i] == uint8_t(Instruction::JUMPDEST))
+			jumpdests[i] = true;
+		else if (_code[i] >= uint8_t(Instruction::PUSH1) && _code[i] <= uint8_t(Instruction::PUSH32))
+			i += _code[i] - uint8_t(Instruction::PUSH1) + 1;
+
+	vector<u256> stack;
+	stack.reserve(GasCosts::stackLimit);
+	bytes memory;
+	bytes returnData;
+	int64_t gas = _message.gas;
+	size_t pc = 0;
+
+	auto pop = [&]()
+	{
+		u256 value = move(stack.back());
+		stack.pop_back();
+		return value;
+	};
+	auto useGas = [&](uint64_t _amount)
+	{
+		if (_amount > uint64_t(gas))
+			return false;
+		gas -= int64_t(_amount);
+		return true;
+	};
+	// Expands the memory to include the given area and charges for the expansion.
+	auto expandMemory = [&](u256 const& _offset, u256 const& _size)
+	{
+		if (_size == 0)
+			return true;
+		// Larger amounts of memory cannot be paid for.
+		if (_offset > 0xffffffff || _size > 0xffffffff)
+			return false;
+		uint64_t end = uint64_t(_offset) + uint64_t(_size);
+		if (end <= memory.size())
+			return true;
+		uint64_t newWords = words(end);
+		if (!useGas(uint64_t(memoryCost(newWords) - memoryCost(memory.size() / 32))))
+			return false;
+		memory.resize(newWords * 32);
+		return true;
+	};
+	// Pops the memory offset, data offset and size of a copying instruction,
+	// charges for it and copies from @a _source.
+	auto copyToMemory = [&](bytes const& _source)
+	{
+		u256 memoryOffset = pop();
+		u256 sourceOffset = pop();
+		u256 size = pop();
+		if (!expandMemory(memoryOffset, size) || !useGas(GasCosts::copyGas * words(uint64_t(size))))
+			return false;
+		if (size > 0)
+			copyPadded(memory.data() + uint64_t(memoryOffset), _source, sourceOffset, uint64_t(size));
+		return true;
+	};
+	auto memoryArea = [&](u256 const& _offset, u256 const& _size)
+	{
+		if (_size == 0)
+			return bytes();
+		return bytes(memory.begin() + ptrdiff_t(_offset), memory.begin() + ptrdiff_t(_offset + _size));
+	};
+
+	while (true)
+	{
+		if (pc >= _code.size())
+			return {Status::Success, {}, gas};
+		uint8_t opcode = _code[pc];
+		OpcodeInfo const& info = m_opcodes[opcode];
+		if (!info.valid)
+			return {Status::Failure, {}, 0};
+		if (stack.size() < info.args || stack.size() - info.args + info.ret > GasCosts::stackLimit)
+			return {Status::Failure, {}, 0};
+		if (!useGas(uint64_t(info.gas)))
+			return {Status::Failure, {}, 0};
+
+		Instruction instruction = Instruction(opcode);
+		size_t nextPC = pc + 1;
+		switch (instruction)
+		{
+		case Instruction::STOP:
+			return {Status::Success, {}, gas};
+		case Instruction::ADD:
+		{
+			u256 a = pop();
+			stack.back() += a;
+			break;
+		}
+		case Instruction::MUL:
+		{
+			u256 a = pop();
+			stack.back() *= a;
+			break;
+		}
+		case Instruction::SUB:
+		{
+			u256 a = pop();
+			stack.back() = a - stack.back();
+			break;
+		}
+		case Instruction::DIV:
+		{
+			u256 a = pop();
+			stack.back() = stack.back() == 0 ? 0 : a / stack.back();
+			break;
+		}
+		case Instruction::SDIV:
+		{
+			u256 a = pop();
+			stack.back() = stack.back() == 0 ? 0 : s2u(u2s(a) / u2s(stack.back()));
+			break;
+		}
+		case Instruction::MOD:
+		{
+			u256 a = pop();
+			stack.back() = stack.back() == 0 ? 0 : a % stack.back();
+			break;
+		}
+		case Instruction::SMOD:
+		{
+			u256 a = pop();
+			stack.back() = stack.back() == 0 ? 0 : s2u(u2s(a) % u2s(stack.back()));
+			break;
+		}
+		case Instruction::ADDMOD:
+		case Instruction::MULMOD:
+		{
+			bigint a = pop();
+			bigint b = pop();
+			u256 modulus = pop();
+			if (modulus == 0)
+				stack.push_back(0);
+			else
+				stack.push_back(u256((instruction == Instruction::ADDMOD ? bigint(a + b) : bigint(a * b)) % modulus));
+			break;
+		}
+		case Instruction::EXP:
+		{
+			u256 base = pop();
+			u256 exponent = pop();
+			if (!useGas(GasCosts::expGas + GasCosts::expByteGas(m_evmVersion) * (exponent == 0 ? 0 : msb(exponent) / 8 + 1)))
+				return {Status::Failure, {}, 0};
+			u256 result = 1;
+			for (; exponent != 0; exponent >>= 1)
+			{
+				if (exponent & 1)
+					result *= base;
+				base *= base;
+			}
+			stack.push_back(result);
+			break;
+		}
+		case Instruction::SIGNEXTEND:
+		{
+			u256 position = pop();
+			if (position < 31)
+			{
+				unsigned testBit = unsigned(position) * 8 + 7;
+				u256 mask = (u256(1) << testBit) - 1;
+				stack.back() = bit_test(stack.back(), testBit) ? stack.back() | ~mask : stack.back() & mask;
+			}
+			break;
+		}
+		case Instruction::LT:
+		{
+			u256 a = pop();
+			stack.back() = a < stack.back() ? 1 : 0;
+			break;
+		}
+		case Instruction::GT:
+		{
+			u256 a = pop();
+			stack.back() = a > stack.back() ? 1 : 0;
+			break;
+		}
+		case Instruction::SLT:
+		{
+			u256 a = pop();
+			stack.back() = u2s(a) < u2s(stack.back()) ? 1 : 0;
+			break;
+		}
+		case Instruction::SGT:
+		{
+			u256 a = pop();
+			stack.back() = u2s(a) > u2s(stack.back()) ? 1 : 0;
+			break;
+		}
+		case Instruction::EQ:
+		{
+			u256 a = pop();
+			stack.back() = a == stack.back() ? 1 : 0;
+			break;
+		}
+		case Instruction::ISZERO:
+			stack.back() = stack.back() == 0 ? 1 : 0;
+			break;
+		case Instruction::AND:
+		{
+			u256 a = pop();
+			stack.back() &= a;
+			break;
+		}
+		case Instruction::OR:
+		{
+			u256 a = pop();
+			stack.back() |= a;
+			break;
+		}
+		case Instruction::XOR:
+		{
+			u256 a = pop();
+			stack.back() ^= a;
+			break;
+		}
+		case Instruction::NOT:
+			stack.back() = ~stack.back();
+			break;
+		case Instruction::BYTE:
+		{
+			u256 position = pop();
+			stack.back() = position < 32 ? (stack.back() >> unsigned(8 * (31 - position))) & 0xff : 0;
+			break;
+		}
+		case Instruction::SHL:
+		{
+			u256 shift = pop();
+			stack.back() = shift < 256 ? stack.back() << unsigned(shift) : 0;
+			break;
+		}
+		case Instruction::SHR:
+		{
+			u256 shift = pop();
+			stack.back() = shift < 256 ? stack.back() >> unsigned(shift) : 0;
+			break;
+		}
+		case Instruction::SAR:
+		{
+			u256 shift = pop();
+			bool negative = bit_test(stack.back(), 255);
+			if (shift >= 256)
+				stack.back() = negative ? ~u256(0) : 0;
+			else if (negative)
+				stack.back() = ~(~stack.back() >> unsigned(shift));
+			else
+				stack.back() >>= unsigned(shift);
+			break;
+		}
+		case Instruction::KECCAK256:
+		{
+			u256 offset = pop();
+			u256 size = pop();
+			if (
+				!expandMemory(offset, size) ||
+				!useGas(GasCosts::keccak256Gas + GasCosts::keccak256WordGas * words(uint64_t(size)))
+			)
+				return {Status::Failure, {}, 0};
+			stack.push_back(u256(keccak256(memoryArea(offset, size))));
+			break;
+		}
+		case Instruction::ADDRESS:
+			stack.push_back(asWord(_message.recipient));
+			break;
+		case Instruction::BALANCE:
+		{
+			Account const* account = accountAt(asAddress(stack.back()));
+			stack.back() = account ? account->balance : 0;
+			break;
+		}
+		case Instruction::ORIGIN:
+			stack.push_back(asWord(m_origin));
+			break;
+		case Instruction::CALLER:
+			stack.push_back(asWord(_message.sender));
+			break;
+		case Instruction::CALLVALUE:
+			stack.push_back(_message.value);
+			break;
+		case Instruction::CALLDATALOAD:
+		{
+			bytes word(32);
+			copyPadded(word.data(), _message.input, stack.back(), 32);
+			stack.back() = fromBigEndian<u256>(word);
+			break;
+		}
+		case Instruction::CALLDATASIZE:
+			stack.push_back(_message.input.size());
+			break;
+		case Instruction::CALLDATACOPY:
+			if (!copyToMemory(_message.input))
+				return {Status::Failure, {}, 0};
+			break;
+		case Instruction::CODESIZE:
+			stack.push_back(_code.size());
+			break;
+		case Instruction::CODECOPY:
+			if (!copyToMemory(_code))
+				return {Status::Failure, {}, 0};
+			break;
+		case Instruction::GASPRICE:
+			stack.push_back(m_gasPrice);
+			break;
+		case Instruction::EXTCODESIZE:
+		{
+			Account const* account = accountAt(asAddress(stack.back()));
+			stack.back() = account ? account->code.size() : 0;
+			break;
+		}
+		case Instruction::EXTCODECOPY:
+		{
+			Account const* account = accountAt(asAddress(pop()));
+			if (!copyToMemory(account ? account->code : bytes()))
+				return {Status::Failure, {}, 0};
+			break;
+		}
+		case Instruction::RETURNDATASIZE:
+			stack.push_back(returnData.size());
+			break;
+		case Instruction::RETURNDATACOPY:
+			if (bigint(stack[stack.size() - 2]) + stack[stack.size() - 3] > returnData.size())
+				return {Status::Failure, {}, 0};
+			if (!copyToMemory(returnData))
+				return {Status::Failure, {}, 0};
+			break;
+		case Instruction::EXTCODEHASH:
+		{
+			h160 address = asAddress(stack.back());
+			if (!exists(address) || (m_evmVersion >= EVMVersion::spuriousDragon() && isEmpty(address)))
+				stack.back() = 0;
+			else
+				stack.back() = u256(keccak256(accountAt(address)->code));
+			break;
+		}
+		case Instruction::BLOCKHASH:
+		{
+			u256 const& current = latestBlock().number;
+			u256 number = stack.back();
+			stack.back() = number < current && current - number <= 256 ? u256(block(number).hash) : 0;
+			break;
+		}
+		case Instruction::COINBASE:
+			stack.push_back(asWord(latestBlock().coinbase));
+			break;
+		case Instruction::TIMESTAMP:
+			stack.push_back(latestBlock().timestamp);
+			break;
+		case Instruction::NUMBER:
+			stack.push_back(latestBlock().number);
+			break;
+		case Instruction::DIFFICULTY:
+			stack.push_back(c_difficulty);
+			break;
+		case Instruction::GASLIMIT:
+			stack.push_back(m_gasLimit);
+			break;
+		case Instruction::ETHASH:
+		{
+			u256 blockNumber = pop();
+			h256 headerHash(pop());
+			h256 mixHash(pop());
+			u256 nonce = pop();
+			u256 difficulty = pop();
+			bool valid = m_ethashVerifier && m_ethashVerifier(blockNumber, headerHash, mixHash, nonce, difficulty);
+			stack.push_back(valid ? 1 : 0);
+			break;
+		}
+		case Instruction::POP:
+			stack.pop_back();
+			break;
+		case Instruction::MLOAD:
+			if (!expandMemory(stack.back(), 32))
+				return {Status::Failure, {}, 0};
+			stack.back() = fromBigEndian<u256>(bytesConstRef(memory.data() + uint64_t(stack.back()), 32));
+			break;
+		case Instruction::MSTORE:
+		{
+			u256 offset = pop();
+			u256 value = pop();
+			if (!expandMemory(offset, 32))
+				return {Status::Failure, {}, 0};
+			bytesRef target(memory.data() + uint64_t(offset), 32);
+			toBigEndian(value, target);
+			break;
+		}
+		case Instruction::MSTORE8:
+		{
+			u256 offset = pop();
+			u256 value = pop();
+			if (!expandMemory(offset, 1))
+				return {Status::Failure, {}, 0};
+			memory[uint64_t(offset)] = uint8_t(value & 0xff);
+			break;
+		}
+		case Instruction::SLOAD:
+		{
+			if (!useGas(GasCosts::sloadGas(m_evmVersion)))
+				return {Status::Failure, {}, 0};
+			Account const* account = accountAt(_message.recipient);
+			auto it = account ? account->storage.find(stack.back()) : map<u256, u256>::const_iterator();
+			stack.back() = account && it != account->storage.end() ? it->second : 0;
+			break;
+		}
+		case Instruction::SSTORE:
+		{
+			if (_message.isStatic)
+				return {Status::Failure, {}, 0};
+			u256 key = pop();
+			u256 value = pop();
+			Account const* account = accountAt(_message.recipient);
+			auto it = account ? account->storage.find(key) : map<u256, u256>::const_iterator();
+			u256 current = account && it != account->storage.end() ? it->second : 0;
+			if (m_evmVersion >= EVMVersion::constantinople())
+			{
+				// Net gas metering (EIP-1283) relative to the value at the start of the transaction.
+				u256 original = m_originalStorage.emplace(make_pair(_message.recipient, key), current).first->second;
+				bool fresh = current != value && original == current;
+				if (!useGas(fresh ? (original == 0 ? GasCosts::sstoreSetGas : GasCosts::sstoreResetGas) : c_sstoreDirtyGas))
+					return {Status::Failure, {}, 0};
+				if (fresh && value == 0)
+					addRefund(GasCosts::sstoreRefundGas);
+				else if (!fresh && current != value)
+				{
+					if (original != 0 && current == 0)
+						addRefund(-int64_t(GasCosts::sstoreRefundGas));
+					if (original != 0 && value == 0)
+						addRefund(GasCosts::sstoreRefundGas);
+					if (original == value)
+						addRefund((original == 0 ? GasCosts::sstoreSetGas : GasCosts::sstoreResetGas) - c_sstoreDirtyGas);
+				}
+			}
+			else
+			{
+				if (!useGas(current == 0 && value != 0 ? GasCosts::sstoreSetGas : GasCosts::sstoreResetGas))
+					return {Status::Failure, {}, 0};
+				if (current != 0 && value == 0)
+					addRefund(GasCosts::sstoreRefundGas);
+			}
+			setStorage(_message.recipient, key, value);
+			break;
+		}
+		case Instruction::JUMP:
+		case Instruction::JUMPI:
+		{
+			u256 target = pop();
+			if (instruction == Instruction::JUMPI && pop() == 0)
+				break;
+			if (target >= _code.size() || !jumpdests[size_t(target)])
+				return {Status::Failure, {}, 0};
+			nextPC = size_t(target);
+			break;
+		}
+		case Instruction::PC:
+			stack.push_back(pc);
+			break;
+		case Instruction::MSIZE:
+			stack.push_back(memory.size());
+			break;
+		case Instruction::GAS:
+			stack.push_back(gas);
+			break;
+		case Instruction::JUMPDEST:
+			break;
+		case Instruction::LOG0:
+		case Instruction::LOG1:
+		case Instruction::LOG2:
+		case Instruction::LOG3:
+		case Instruction::LOG4:
+		{
+			if (_message.isStatic)
+				return {Status::Failure, {}, 0};
+			unsigned topics = opcode - uint8_t(Instruction::LOG0);
+			u256 offset = pop();
+			u256 size = pop();
+			LogEntry log;
+			log.address = _message.recipient;
+			for (unsigned i = 0; i < topics; ++i)
+				log.topics.push_back(h256(pop()));
+			if (
+				!expandMemory(offset, size) ||
+				!useGas(GasCosts::logGas + GasCosts::logTopicGas * topics + GasCosts::logDataGas * uint64_t(size))
+			)
+				return {Status::Failure, {}, 0};
+			log.data = memoryArea(offset, size);
+			addLog(move(log));
+			break;
+		}
+		case Instruction::CREATE:
+		case Instruction::CREATE2:
+		{
+			if (_message.isStatic)
+				return {Status::Failure, {}, 0};
+			u256 value = pop();
+			u256 offset = pop();
+			u256 size = pop();
+			u256 salt = instruction == Instruction::CREATE2 ? pop() : 0;
+			if (!expandMemory(offset, size) || !useGas(GasCosts::createGas))
+				return {Status::Failure, {}, 0};
+			if (instruction == Instruction::CREATE2 && !useGas(GasCosts::keccak256WordGas * words(uint64_t(size))))
+				return {Status::Failure, {}, 0};
+			bytes initCode = memoryArea(offset, size);
+
+			Message message;
+			message.sender = _message.recipient;
+			message.value = value;
+			message.transfersValue = true;
+			message.gas = m_evmVersion.canOverchargeGasForCall() ? gas - gas / 64 : gas;
+			message.depth = _message.depth + 1;
+			message.isStatic = false;
+			gas -= message.gas;
+			returnData.clear();
+			Account const& sender = *accountAt(_message.recipient);
+			if (_message.depth >= c_maxCallDepth || sender.balance < value)
+			{
+				gas += message.gas;
+				stack.push_back(0);
+				break;
+			}
+			if (instruction == Instruction::CREATE)
+				message.recipient = createAddress(_message.recipient, sender.nonce);
+			else
+				message.recipient = create2Address(_message.recipient, salt, initCode);
+			message.codeAddress = message.recipient;
+			setNonce(_message.recipient, sender.nonce + 1);
+
+			ExecutionResult result = create(message, initCode);
+			gas += result.gasLeft;
+			if (result.status == Status::Revert)
+				returnData = move(result.output);
+			stack.push_back(result.status == Status::Success ? asWord(message.recipient) : 0);
+			break;
+		}
+		case Instruction::CALL:
+		case Instruction::CALLCODE:
+		case Instruction::DELEGATECALL:
+		case Instruction::STATICCALL:
+		{
+			u256 gasArgument = pop();
+			h160 to = asAddress(pop());
+			u256 value;
+			if (instruction == Instruction::CALL || instruction == Instruction::CALLCODE)
+				value = pop();
+			u256 inputOffset = pop();
+			u256 inputSize = pop();
+			u256 outputOffset = pop();
+			u256 outputSize = pop();
+			if (instruction == Instruction::CALL && _message.isStatic && value != 0)
+				return {Status::Failure, {}, 0};
+			if (!expandMemory(inputOffset, inputSize) || !expandMemory(outputOffset, outputSize))
+				return {Status::Failure, {}, 0};
+
+			uint64_t cost = GasCosts::callGas(m_evmVersion);
+			if (value != 0)
+				cost += GasCosts::callValueTransferGas;
+			if (instruction == Instruction::CALL)
+			{
+				if (m_evmVersion >= EVMVersion::spuriousDragon())
+				{
+					if (value != 0 && isEmpty(to))
+						cost += GasCosts::callNewAccountGas;
+				}
+				else if (!exists(to))
+					cost += GasCosts::callNewAccountGas;
+			}
+			if (!useGas(cost))
+				return {Status::Failure, {}, 0};
+
+			Message message;
+			if (m_evmVersion.canOverchargeGasForCall())
+				message.gas = int64_t(min<u256>(gasArgument, gas - gas / 64));
+			else if (gasArgument > gas)
+				return {Status::Failure, {}, 0};
+			else
+				message.gas = int64_t(gasArgument);
+			gas -= message.gas;
+			if (value != 0)
+				message.gas += GasCosts::callStipend;
+
+			message.sender = _message.recipient;
+			message.recipient = to;
+			message.codeAddress = to;
+			message.value = value;
+			message.transfersValue = true;
+			message.input = memoryArea(inputOffset, inputSize);
+			message.depth = _message.depth + 1;
+			message.isStatic = _message.isStatic || instruction == Instruction::STATICCALL;
+			if (instruction == Instruction::CALLCODE)
+				message.recipient = _message.recipient;
+			else if (instruction == Instruction::DELEGATECALL)
+			{
+				message.sender = _message.sender;
+				message.recipient = _message.recipient;
+				message.value = _message.value;
+				message.transfersValue = false;
+			}
+
+			returnData.clear();
+			if (_message.depth >= c_maxCallDepth || (value != 0 && accountAt(_message.recipient)->balance < value))
+			{
+				gas += message.gas;
+				stack.push_back(0);
+				break;
+			}
+			ExecutionResult result = call(message);
+			gas += result.gasLeft;
+			returnData = move(result.output);
+			if (outputSize > 0)
+				memcpy(
+					memory.data() + uint64_t(outputOffset),
+					returnData.data(),
+					min<size_t>(returnData.size(), size_t(outputSize))
+				);
+			stack.push_back(result.status == Status::Success ? 1 : 0);
+			break;
+		}
+		case Instruction::RETURN:
+		case Instruction::REVERT:
+		{
+			u256 offset = pop();
+			u256 size = pop();
+			if (!expandMemory(offset, size))
+				return {Status::Failure, {}, 0};
+			return {instruction == Instruction::RETURN ? Status::Success : Status::Revert, memoryArea(offset, size), gas};
+		}
+		case Instruction::SELFDESTRUCT:
+		{
+			if (_message.isStatic)
+				return {Status::Failure, {}, 0};
+			h160 beneficiary = asAddress(pop());
+			u256 balance = accountAt(_message.recipient)->balance;
+			uint64_t cost = GasCosts::selfdestructGas(m_evmVersion);
+			if (m_evmVersion >= EVMVersion::spuriousDragon())
+			{
+				if (balance != 0 && isEmpty(beneficiary))
+					cost += GasCosts::callNewAccountGas;
+			}
+			else if (m_evmVersion >= EVMVersion::tangerineWhistle() && !exists(beneficiary))
+				cost += GasCosts::callNewAccountGas;
+			if (!useGas(cost))
+				return {Status::Failure, {}, 0};
+			if (!m_selfdestructs.count(_message.recipient))
+				addRefund(GasCosts::selfdestructRefundGas);
+			transfer(_message.recipient, beneficiary, balance);
+			// A contract that destroys itself in favour of itself burns its balance.
+			setBalance(_message.recipient, 0);
+			selfdestruct(_message.recipient);
+			return {Status::Success, {}, gas};
+		}
+		default:
+			if (opcode >= uint8_t(Instruction::PUSH1) && opcode <= uint8_t(Instruction::PUSH32))
+			{
+				size_t length = opcode - uint8_t(Instruction::PUSH1) + 1;
+				u256 value = 0;
+				for (size_t i = 0; i < length; ++i)
+					value = (value << 8) | (pc + 1 + i < _code.size() ? _code[pc + 1 + i] : 0);
+				stack.push_back(value);
+				nextPC = pc + 1 + length;
+			}
+			else if (opcode >= uint8_t(Instruction::DUP1) && opcode <= uint8_t(Instruction::DUP16))
+				stack.push_back(stack[stack.size() - 1 - (opcode - uint8_t(Instruction::DUP1))]);
+			else if (opcode >= uint8_t(Instruction::SWAP1) && opcode <= uint8_t(Instruction::SWAP16))
+				swap(stack.back(), stack[stack.size() - 2 - (opcode - uint8_t(Instruction::SWAP1))]);
+			else
+				return {Status::Failure, {}, 0};
+			break;
+		}
+		pc = nextPC;
+	}
+}
+
+bool EVMInterpreter::isEmpty(h160 const& _address) const
+{
+	Account const* account = accountAt(_address);
+	return !account || (account->nonce == 0 && account->balance == 0 && account->code.empty());
+}
+
+EVMInterpreter::Account& EVMInterpreter::touch(h160 const& _address)
+{
+	auto it = m_state.find(_address);
+	if (it == m_state.end())
+	{
+		it = m_state.emplace(_address, Account{}).first;
+		m_journal.emplace_back([this, _address]() { m_state.erase(_address); });
+	}
+	return it->second;
+}
+
+void EVMInterpreter::setStorage(h160 const& _address, u256 const& _key, u256 const& _value)
+{
+	map<u256, u256>& storage = touch(_address).storage;
+	auto it = storage.find(_key);
+	u256 previous = it == storage.end() ? 0 : it->second;
+	if (previous == _value)
+		return;
+	m_journal.emplace_back([this, _address, _key, previous]()
+	{
+		if (previous == 0)
+			m_state[_address].storage.erase(_key);
+		else
+			m_state[_address].storage[_key] = previous;
+	});
+	if (_value == 0)
+		storage.erase(it);
+	else
+		storage[_key] = _value;
+}
+
+void EVMInterpreter::setBalance(h160 const& _address, u256 const& _balance)
+{
+	Account& account = touch(_address);
+	u256 previous = account.balance;
+	m_journal.emplace_back([this, _address, previous]() { m_state[_address].balance = previous; });
+	account.balance = _balance;
+}
+
+void EVMInterpreter::setNonce(h160 const& _address, u256 const& _nonce)
+{
+	Account& account = touch(_address);
+	u256 previous = account.nonce;
+	m_journal.emplace_back([this, _address, previous]() { m_state[_address].nonce = previous; });
+	account.nonce = _nonce;
+}
+
+void EVMInterpreter::setCode(h160 const& _address, bytes _code)
+{
+	Account& account = touch(_address);
+	solAssert(account.code.empty(), "");
+	m_journal.emplace_back([this, _address]() { m_state[_address].code.clear(); });
+	account.code = move(_code);
+}
+
+bool EVMInterpreter::transfer(h160 const& _from, h160 const& _to, u256 const& _value)
+{
+	u256 fromBalance = touch(_from).balance;
+	if (fromBalance < _value)
+		return false;
+	setBalance(_from, fromBalance - _value);
+	setBalance(_to, touch(_to).balance + _value);
+	return true;
+}
+
+void EVMInterpreter::addRefund(int64_t _refund)
+{
+	m_refund += _refund;
+	m_journal.emplace_back([this, _refund]() { m_refund -= _refund; });
+}
+
+void EVMInterpreter::addLog(LogEntry _log)
+{
+	m_logs.emplace_back(move(_log));
+	m_journal.emplace_back([this]() { m_logs.pop_back(); });
+}
+
+void EVMInterpreter::selfdestruct(h160 const& _address)
+{
+	if (m_selfdestructs.insert(_address).second)
+		m_journal.emplace_back([this, _address]() { m_selfdestructs.erase(_address); });
+}
+
+void EVMInterpreter::revert(size_t _checkpoint)
+{
+	while (m_journal.size() > _checkpoint)
+	{
+		m_journal.back()();
+		m_journal.pop_back();
+	}
+}
+
+void EVMInterpreter::newBlock()
+{
+	Block const& parent = latestBlock();
+	Block block;
+	block.number = parent.number + 1;
+	block.timestamp = m_nextTimestamp ? *m_nextTimestamp : parent.timestamp + 1;
+	block.coinbase = m_coinbase;
+	block.hash = keccak256(
+		parent.hash.asBytes() +
+		toBigEndian(block.number) +
+		toBigEndian(block.timestamp) +
+		block.coinbase.asBytes()
+	);
+	m_nextTimestamp.reset();
+	m_blocks.push_back(block);
+}
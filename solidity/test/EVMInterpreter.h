@@ -0,0 +1,180 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * In-process EVM interpreter that replaces an external node for executing contracts in tests.
+ */
+
+#pragma once
+
+#include <liblangutil/EVMVersion.h>
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace test
+{
+
+/**
+ * Interpreter for EVM bytecode together with a minimal blockchain that mines every
+ * transaction into a block of its own. Gas is accounted as in the Ethereum network
+ * at the given EVM version, using the costs in GasCosts and the tiers in Instruction.cpp.
+ * State changes are recorded in a journal so that failing calls can be rolled back.
+ */
+class EVMInterpreter
+{
+public:
+	struct Account
+	{
+		u256 nonce;
+		u256 balance;
+		bytes code;
+		std::map<u256, u256> storage;
+	};
+
+	struct LogEntry
+	{
+		h160 address;
+		std::vector<h256> topics;
+		bytes data;
+	};
+
+	struct Block
+	{
+		u256 number;
+		u256 timestamp;
+		h160 coinbase;
+		h256 hash;
+	};
+
+	struct TransactionResult
+	{
+		bool success = false;
+		/// Return data of a call or code of the created contract.
+		bytes output;
+		u256 gasUsed;
+		/// Address of the new contract, if the transaction was a contract creation.
+		h160 createdAddress;
+		std::vector<LogEntry> logs;
+		u256 blockNumber;
+	};
+
+	/// Evaluates the ETHASH instruction, i.e. verifies the proof of work of a block header.
+	/// The arguments are the block number, header hash, mix hash, nonce and difficulty.
+	using EthashVerifier = std::function<bool(u256 const&, h256 const&, h256 const&, u256 const&, u256 const&)>;
+
+	explicit EVMInterpreter(solidity::EVMVersion _evmVersion);
+
+	/// Executes a transaction in a newly mined block. Invalid transactions are rejected
+	/// without mining a block.
+	/// @param _to the recipient, or nothing for a contract creation.
+	TransactionResult transact(
+		h160 const& _from,
+		boost::optional<h160> const& _to,
+		u256 const& _value,
+		bytes const& _data,
+		u256 const& _gas,
+		u256 const& _gasPrice
+	);
+
+	/// Mines @a _number empty blocks.
+	void mineBlocks(unsigned _number);
+	/// Sets the timestamp of the next block. The timestamps of later blocks increase by one per block.
+	void setNextTimestamp(u256 const& _timestamp) { m_nextTimestamp = _timestamp; }
+	/// Sets the beneficiary of all following blocks.
+	void setCoinbase(h160 const& _coinbase) { m_coinbase = _coinbase; }
+	/// Sets the function used to evaluate the ETHASH instruction. Without verifier, it always returns false.
+	void setEthashVerifier(EthashVerifier _verifier) { m_ethashVerifier = std::move(_verifier); }
+
+	Block const& latestBlock() const { return m_blocks.back(); }
+	/// @returns the block with the given number, which has to exist.
+	Block const& block(u256 const& _number) const;
+	u256 const& gasLimit() const { return m_gasLimit; }
+
+	/// @returns the address of the @a _index th account owned by the tests, which is funded on first use.
+	h160 account(size_t _index);
+	/// @returns the account at @a _address or nullptr if it does not exist.
+	Account const* accountAt(h160 const& _address) const;
+
+private:
+	struct Message;
+	struct ExecutionResult;
+	struct OpcodeInfo
+	{
+		bool valid = false;
+		unsigned args = 0;
+		unsigned ret = 0;
+		/// Constant part of the gas costs.
+		int64_t gas = 0;
+	};
+
+	ExecutionResult call(Message const& _message);
+	ExecutionResult create(Message const& _message, bytes const& _initCode);
+	ExecutionResult execute(Message const& _message, bytes const& _code);
+
+	bool exists(h160 const& _address) const { return m_state.count(_address); }
+	bool isEmpty(h160 const& _address) const;
+	/// @returns the account at @a _address, creating it if necessary.
+	Account& touch(h160 const& _address);
+	void setStorage(h160 const& _address, u256 const& _key, u256 const& _value);
+	void setBalance(h160 const& _address, u256 const& _balance);
+	void setNonce(h160 const& _address, u256 const& _nonce);
+	void setCode(h160 const& _address, bytes _code);
+	/// @returns false if the balance of @a _from is insufficient.
+	bool transfer(h160 const& _from, h160 const& _to, u256 const& _value);
+	void addRefund(int64_t _refund);
+	void addLog(LogEntry _log);
+	void selfdestruct(h160 const& _address);
+
+	/// Reverts all state changes recorded in the journal after @a _checkpoint.
+	void revert(size_t _checkpoint);
+
+	void newBlock();
+
+	solidity::EVMVersion m_evmVersion;
+	std::array<OpcodeInfo, 256> m_opcodes;
+	u256 m_gasLimit;
+	h160 m_coinbase;
+	boost::optional<u256> m_nextTimestamp;
+	std::vector<Block> m_blocks;
+	std::map<h160, Account> m_state;
+	std::map<size_t, h160> m_accounts;
+	EthashVerifier m_ethashVerifier;
+
+	/// Functions that undo the state changes of the current transaction.
+	std::vector<std::function<void()>> m_journal;
+	/// Context of the current transaction.
+	h160 m_origin;
+	u256 m_gasPrice;
+	int64_t m_refund = 0;
+	std::vector<LogEntry> m_logs;
+	std::set<h160> m_selfdestructs;
+	/// Values of the storage slots written by the current transaction at its start.
+	std::map<std::pair<h160, u256>, u256> m_originalStorage;
+};
+
+}
+}
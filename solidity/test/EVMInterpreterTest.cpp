@@ -0,0 +1,135 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the in-process EVM interpreter.
+ */
+
+#include <test/EVMInterpreter.h>
+
+#include <libevmasm/GasMeter.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev::eth;
+using namespace dev::solidity;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+
+u256 const c_gas = 1000000;
+
+u256 intrinsicGas(bytes const& _data, bool _isCreation)
+{
+	u256 gas = _isCreation ? GasCosts::txCreateGas : GasCosts::txGas;
+	for (uint8_t byte: _data)
+		gas += byte ? GasCosts::txDataNonZeroGas : GasCosts::txDataZeroGas;
+	return gas;
+}
+
+/// @returns the gas used by executing @a _initCode in a contract creation, after refunds.
+u256 creationGas(EVMVersion _evmVersion, bytes const& _initCode)
+{
+	EVMInterpreter evm(_evmVersion);
+	auto result = evm.transact(evm.account(0), boost::none, 0, _initCode, c_gas, 1);
+	BOOST_REQUIRE(result.success);
+	return result.gasUsed - intrinsicGas(_initCode, true);
+}
+
+/// @returns the gas used by a call that sets storage slot zero first to @a _first and
+/// then to @a _second, after slot zero was set to @a _initial by an earlier transaction.
+u256 storageUpdateGas(EVMVersion _evmVersion, u256 const& _initial, u256 const& _first, u256 const& _second)
+{
+	// sstore(0, calldataload(0)) sstore(0, calldataload(0x20))
+	bytes runtime = fromHex("600035600055602035600055" "00");
+	bytes initCode = bytes{0x60, uint8_t(runtime.size()), 0x80, 0x60, 12, 0x60, 0, 0x39, 0x60, 0, 0xf3, 0} + runtime;
+	EVMInterpreter evm(_evmVersion);
+	h160 sender = evm.account(0);
+	auto creation = evm.transact(sender, boost::none, 0, initCode, c_gas, 1);
+	BOOST_REQUIRE(creation.success);
+	h160 contract = creation.createdAddress;
+	BOOST_REQUIRE(evm.transact(sender, contract, 0, toBigEndian(_initial) + toBigEndian(_initial), c_gas, 1).success);
+	bytes data = toBigEndian(_first) + toBigEndian(_second);
+	auto result = evm.transact(sender, contract, 0, data, c_gas, 1);
+	BOOST_REQUIRE(result.success);
+	return result.gasUsed - intrinsicGas(data, false);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(EVMInterpreterTest)
+
+BOOST_AUTO_TEST_CASE(invalid_transaction_mines_no_block)
+{
+	EVMInterpreter evm(EVMVersion::constantinople());
+	h160 sender = evm.account(0);
+	auto result = evm.transact(sender, boost::none, 0, bytes{0x00}, GasCosts::txCreateGas, 1);
+	BOOST_CHECK(!result.success);
+	BOOST_CHECK_EQUAL(result.blockNumber, 0);
+	BOOST_CHECK_EQUAL(evm.latestBlock().number, 0);
+	BOOST_CHECK_EQUAL(evm.accountAt(sender)->nonce, 0);
+
+	result = evm.transact(sender, boost::none, 0, bytes{0x00}, c_gas, 1);
+	BOOST_CHECK(result.success);
+	BOOST_CHECK_EQUAL(result.blockNumber, 1);
+	BOOST_CHECK_EQUAL(evm.latestBlock().number, 1);
+	BOOST_CHECK_EQUAL(evm.accountAt(sender)->nonce, 1);
+}
+
+BOOST_AUTO_TEST_CASE(sstore_fresh_slot)
+{
+	// sstore(0, 1) sstore(0, 2)
+	bytes setTwice = fromHex("6001600055600260005500");
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::byzantium(), setTwice), 20000 + 5000 + 4 * 3);
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::constantinople(), setTwice), 20000 + 200 + 4 * 3);
+
+	// sstore(0, 1) sstore(0, 0)
+	bytes setAndClear = fromHex("6001600055600060005500");
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::byzantium(), setAndClear), 20000 + 5000 - 15000 + 4 * 3);
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::constantinople(), setAndClear), 20000 + 200 - 19800 + 4 * 3);
+
+	// sstore(0, 0)
+	bytes noop = fromHex("600060005500");
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::byzantium(), noop), 5000 + 2 * 3);
+	BOOST_CHECK_EQUAL(creationGas(EVMVersion::constantinople(), noop), 200 + 2 * 3);
+}
+
+BOOST_AUTO_TEST_CASE(sstore_existing_slot)
+{
+	// Two PUSH1, CALLDATALOAD and PUSH1 per store.
+	int const otherGas = 2 * 3 * 3;
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::byzantium(), 1, 2, 3), 5000 + 5000 + otherGas);
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::constantinople(), 1, 2, 3), 5000 + 200 + otherGas);
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::constantinople(), 1, 2, 1), 5000 + 200 - 4800 + otherGas);
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::constantinople(), 1, 1, 1), 200 + 200 + otherGas);
+	// Clearing the slot refunds 15000, which is taken back when it is set again.
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::byzantium(), 1, 0, 1), 5000 + 20000 - 15000 + otherGas);
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::constantinople(), 1, 0, 1), 5000 + 200 - 4800 + otherGas);
+	BOOST_CHECK_EQUAL(storageUpdateGas(EVMVersion::constantinople(), 0, 1, 0), 20000 + 200 - 19800 + otherGas);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,657 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Precompiled contracts of the in-process EVM interpreter.
+ * The elliptic curve operations are straightforward implementations on top of
+ * arbitrary precision integers that favour simplicity over speed.
+ */
+
+#include <test/EVMPrecompiles.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/Keccak256.h>
+
+#include <array>
+#include <cstring>
+
+using namespace std;
+using namespace dev;
+using namespace dev::test;
+
+namespace
+{
+
+uint32_t rotateRight(uint32_t _x, unsigned _n)
+{
+	return (_x >> _n) | (_x << (32 - _n));
+}
+
+uint32_t rotateLeft(uint32_t _x, unsigned _n)
+{
+	return (_x << _n) | (_x >> (32 - _n));
+}
+
+/// @returns @a _input padded with zeros such that it consists of a multiple of 64 bytes and
+/// ends in the length of the input in bits, as required by SHA-256 and RIPEMD-160.
+bytes padMessage(bytesConstRef _input, bool _bigEndianLength)
+{
+	bytes message(_input.begin(), _input.end());
+	message.push_back(0x80);
+	while (message.size() % 64 != 56)
+		message.push_back(0);
+	uint64_t bitLength = uint64_t(_input.size()) * 8;
+	for (unsigned i = 0; i < 8; ++i)
+		message.push_back(uint8_t(bitLength >> (_bigEndianLength ? 56 - 8 * i : 8 * i)));
+	return message;
+}
+
+/// @returns the word of @a _input at @a _offset, padded with zeros to the right.
+bigint wordAt(bytesConstRef _input, size_t _offset, size_t _length = 32)
+{
+	bytes word(_length, 0);
+	if (_offset < _input.size())
+		memcpy(word.data(), _input.data() + _offset, min(_length, _input.size() - _offset));
+	return fromBigEndian<bigint>(word);
+}
+
+bytes toBytes(bigint const& _value, size_t _length = 32)
+{
+	bytes result(_length, 0);
+	bigint value = _value;
+	for (size_t i = _length; i > 0 && value > 0; --i, value >>= 8)
+		result[i - 1] = uint8_t(value & 0xff);
+	return result;
+}
+
+bigint modulo(bigint const& _value, bigint const& _modulus)
+{
+	bigint result = _value % _modulus;
+	return result < 0 ? result + _modulus : result;
+}
+
+bigint inverse(bigint const& _value, bigint const& _modulus)
+{
+	return boost::multiprecision::powm(modulo(_value, _modulus), _modulus - 2, _modulus);
+}
+
+/// Point in Jacobian coordinates on a curve y^2 = x^3 + b over a prime field.
+/// A zero z coordinate denotes the point at infinity.
+struct CurvePoint
+{
+	bigint x;
+	bigint y;
+	bigint z;
+};
+
+CurvePoint doublePoint(CurvePoint const& _point, bigint const& _p)
+{
+	if (_point.z == 0 || _point.y == 0)
+		return {0, 1, 0};
+	bigint a = modulo(_point.x * _point.x, _p);
+	bigint b = modulo(_point.y * _point.y, _p);
+	bigint c = modulo(b * b, _p);
+	bigint d = modulo(2 * (modulo((_point.x + b) * (_point.x + b), _p) - a - c), _p);
+	bigint e = modulo(3 * a, _p);
+	bigint x = modulo(e * e - 2 * d, _p);
+	bigint y = modulo(e * (d - x) - 8 * c, _p);
+	bigint z = modulo(2 * _point.y * _point.z, _p);
+	return {x, y, z};
+}
+
+CurvePoint addPoints(CurvePoint const& _a, CurvePoint const& _b, bigint const& _p)
+{
+	if (_a.z == 0)
+		return _b;
+	if (_b.z == 0)
+		return _a;
+	bigint z1z1 = modulo(_a.z * _a.z, _p);
+	bigint z2z2 = modulo(_b.z * _b.z, _p);
+	bigint u1 = modulo(_a.x * z2z2, _p);
+	bigint u2 = modulo(_b.x * z1z1, _p);
+	bigint s1 = modulo(_a.y * _b.z * z2z2, _p);
+	bigint s2 = modulo(_b.y * _a.z * z1z1, _p);
+	if (u1 == u2)
+		return s1 == s2 ? doublePoint(_a, _p) : CurvePoint{0, 1, 0};
+	bigint h = modulo(u2 - u1, _p);
+	bigint r = modulo(s2 - s1, _p);
+	bigint hh = modulo(h * h, _p);
+	bigint hhh = modulo(h * hh, _p);
+	bigint v = modulo(u1 * hh, _p);
+	bigint x = modulo(r * r - hhh - 2 * v, _p);
+	bigint y = modulo(r * (v - x) - s1 * hhh, _p);
+	bigint z = modulo(h * _a.z * _b.z, _p);
+	return {x, y, z};
+}
+
+CurvePoint multiplyPoint(CurvePoint const& _point, bigint const& _scalar, bigint const& _p)
+{
+	CurvePoint result{0, 1, 0};
+	for (int i = int(msb(_scalar | 1)); i >= 0; --i)
+	{
+		result = doublePoint(result, _p);
+		if (bit_test(_scalar, unsigned(i)))
+			result = addPoints(result, _point, _p);
+	}
+	return result;
+}
+
+/// @returns the affine coordinates of @a _point, or (0, 0) for the point at infinity.
+pair<bigint, bigint> toAffine(CurvePoint const& _point, bigint const& _p)
+{
+	if (_point.z == 0)
+		return {0, 0};
+	bigint zInverse = inverse(_point.z, _p);
+	bigint zInverse2 = modulo(zInverse * zInverse, _p);
+	return {modulo(_point.x * zInverse2, _p), modulo(_point.y * zInverse2 * zInverse, _p)};
+}
+
+bigint const c_secp256k1P("0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f");
+bigint const c_secp256k1N("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141");
+CurvePoint const c_secp256k1G{
+	bigint("0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"),
+	bigint("0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"),
+	1
+};
+
+bytes ecrecover(bytesConstRef _input)
+{
+	bigint hash = wordAt(_input, 0);
+	bigint v = wordAt(_input, 32);
+	bigint r = wordAt(_input, 64);
+	bigint s = wordAt(_input, 96);
+	if ((v != 27 && v != 28) || r == 0 || r >= c_secp256k1N || s == 0 || s >= c_secp256k1N)
+		return {};
+
+	bigint ySquared = modulo(r * r * r + 7, c_secp256k1P);
+	bigint y = boost::multiprecision::powm(ySquared, (c_secp256k1P + 1) / 4, c_secp256k1P);
+	if (modulo(y * y, c_secp256k1P) != ySquared)
+		return {};
+	if (bigint(y & 1) != v - 27)
+		y = c_secp256k1P - y;
+
+	bigint rInverse = inverse(r, c_secp256k1N);
+	CurvePoint publicKey = addPoints(
+		multiplyPoint(c_secp256k1G, modulo(-hash * rInverse, c_secp256k1N), c_secp256k1P),
+		multiplyPoint(CurvePoint{r, y, 1}, modulo(s * rInverse, c_secp256k1N), c_secp256k1P),
+		c_secp256k1P
+	);
+	if (publicKey.z == 0)
+		return {};
+	auto coordinates = toAffine(publicKey, c_secp256k1P);
+	h256 publicKeyHash = keccak256(toBytes(coordinates.first) + toBytes(coordinates.second));
+	return bytes(12, 0) + h160(publicKeyHash, h160::AlignRight).asBytes();
+}
+
+bytes modexp(bytesConstRef _input)
+{
+	size_t baseLength = size_t(wordAt(_input, 0));
+	size_t exponentLength = size_t(wordAt(_input, 32));
+	size_t modulusLength = size_t(wordAt(_input, 64));
+	bigint base = wordAt(_input, 96, baseLength);
+	bigint exponent = wordAt(_input, 96 + baseLength, exponentLength);
+	bigint modulus = wordAt(_input, 96 + baseLength + exponentLength, modulusLength);
+	if (modulus == 0)
+		return bytes(modulusLength, 0);
+	return toBytes(boost::multiprecision::powm(base, exponent, modulus), modulusLength);
+}
+
+bigint modexpGas(bytesConstRef _input)
+{
+	bigint baseLength = wordAt(_input, 0);
+	bigint exponentLength = wordAt(_input, 32);
+	bigint modulusLength = wordAt(_input, 64);
+
+	bigint exponentHead = 0;
+	if (96 + baseLength < _input.size())
+		exponentHead = wordAt(_input, 96 + size_t(baseLength), size_t(min<bigint>(exponentLength, 32)));
+	bigint adjustedExponentLength = exponentHead == 0 ? 0 : bigint(msb(exponentHead));
+	if (exponentLength > 32)
+		adjustedExponentLength += 8 * (exponentLength - 32);
+
+	bigint x = max(baseLength, modulusLength);
+	bigint multiplicationComplexity;
+	if (x <= 64)
+		multiplicationComplexity = x * x;
+	else if (x <= 1024)
+		multiplicationComplexity = x * x / 4 + 96 * x - 3072;
+	else
+		multiplicationComplexity = x * x / 16 + 480 * x - 199680;
+	return multiplicationComplexity * max<bigint>(adjustedExponentLength, 1) / 20;
+}
+
+bigint const c_bn128P("0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47");
+
+/// Reads a point of the alt_bn128 G1 group at @a _offset of @a _input.
+boost::optional<CurvePoint> readG1Point(bytesConstRef _input, size_t _offset)
+{
+	bigint x = wordAt(_input, _offset);
+	bigint y = wordAt(_input, _offset + 32);
+	if (x >= c_bn128P || y >= c_bn128P)
+		return {};
+	if (x == 0 && y == 0)
+		return CurvePoint{0, 1, 0};
+	if (modulo(y * y, c_bn128P) != modulo(x * x * x + 3, c_bn128P))
+		return {};
+	return CurvePoint{x, y, 1};
+}
+
+bytes writeG1Point(CurvePoint const& _point)
+{
+	auto coordinates = toAffine(_point, c_bn128P);
+	return toBytes(coordinates.first) + toBytes(coordinates.second);
+}
+
+boost::optional<bytes> bn128Add(bytesConstRef _input)
+{
+	auto a = readG1Point(_input, 0);
+	auto b = readG1Point(_input, 64);
+	if (!a || !b)
+		return {};
+	return writeG1Point(addPoints(*a, *b, c_bn128P));
+}
+
+boost::optional<bytes> bn128Mul(bytesConstRef _input)
+{
+	auto point = readG1Point(_input, 0);
+	if (!point)
+		return {};
+	return writeG1Point(multiplyPoint(*point, wordAt(_input, 64), c_bn128P));
+}
+
+/// Element a + b * i of the quadratic extension field with i^2 = -1.
+struct FQ2
+{
+	bigint a;
+	bigint b;
+};
+
+FQ2 operator+(FQ2 const& _x, FQ2 const& _y) { return {modulo(_x.a + _y.a, c_bn128P), modulo(_x.b + _y.b, c_bn128P)}; }
+FQ2 operator-(FQ2 const& _x, FQ2 const& _y) { return {modulo(_x.a - _y.a, c_bn128P), modulo(_x.b - _y.b, c_bn128P)}; }
+FQ2 operator*(FQ2 const& _x, FQ2 const& _y)
+{
+	return {modulo(_x.a * _y.a - _x.b * _y.b, c_bn128P), modulo(_x.a * _y.b + _x.b * _y.a, c_bn128P)};
+}
+bool operator==(FQ2 const& _x, FQ2 const& _y) { return _x.a == _y.a && _x.b == _y.b; }
+bool operator!=(FQ2 const& _x, FQ2 const& _y) { return !(_x == _y); }
+
+FQ2 inverse(FQ2 const& _x)
+{
+	bigint normInverse = inverse(_x.a * _x.a + _x.b * _x.b, c_bn128P);
+	return {modulo(_x.a * normInverse, c_bn128P), modulo(-_x.b * normInverse, c_bn128P)};
+}
+
+FQ2 power(FQ2 const& _x, bigint const& _exponent)
+{
+	FQ2 result{1, 0};
+	for (int i = int(msb(_exponent | 1)); i >= 0; --i)
+	{
+		result = result * result;
+		if (bit_test(_exponent, unsigned(i)))
+			result = result * _x;
+	}
+	return result;
+}
+
+/// Element of the degree 12 extension field, represented as polynomial in w with w^12 = 18 * w^6 - 82.
+/// The quadratic extension is embedded via i = w^6 - 9.
+using FQ12 = array<bigint, 12>;
+
+FQ12 operator*(FQ12 const& _x, FQ12 const& _y)
+{
+	array<bigint, 23> product;
+	for (size_t i = 0; i < 12; ++i)
+		if (_x[i] != 0)
+			for (size_t j = 0; j < 12; ++j)
+				product[i + j] += _x[i] * _y[j];
+	for (size_t i = 22; i >= 12; --i)
+	{
+		product[i - 6] += 18 * product[i];
+		product[i - 12] -= 82 * product[i];
+	}
+	FQ12 result;
+	for (size_t i = 0; i < 12; ++i)
+		result[i] = modulo(product[i], c_bn128P);
+	return result;
+}
+
+FQ12 one()
+{
+	FQ12 result;
+	result[0] = 1;
+	return result;
+}
+
+/// Adds @a _x times w^@a _shift to @a _target.
+void addEmbedded(FQ12& _target, FQ2 const& _x, size_t _shift)
+{
+	_target[_shift] = modulo(_target[_shift] + _x.a - 9 * _x.b, c_bn128P);
+	_target[_shift + 6] = modulo(_target[_shift + 6] + _x.b, c_bn128P);
+}
+
+/// Point on the twisted curve y^2 = x^3 + 3 / (9 + i) over the quadratic extension field.
+/// It corresponds to the point (x * w^2, y * w^3) on the curve y^2 = x^3 + 3 over the degree 12 extension.
+struct TwistPoint
+{
+	FQ2 x;
+	FQ2 y;
+	bool infinity;
+};
+
+FQ2 const c_twistB = FQ2{3, 0} * inverse(FQ2{9, 1});
+
+TwistPoint addTwistPoints(TwistPoint const& _a, TwistPoint const& _b)
+{
+	if (_a.infinity)
+		return _b;
+	if (_b.infinity)
+		return _a;
+	FQ2 slope;
+	if (_a.x == _b.x)
+	{
+		if (_a.y != _b.y || _a.y == FQ2{0, 0})
+			return {{0, 0}, {0, 0}, true};
+		slope = FQ2{3, 0} * _a.x * _a.x * inverse(FQ2{2, 0} * _a.y);
+	}
+	else
+		slope = (_b.y - _a.y) * inverse(_b.x - _a.x);
+	FQ2 x = slope * slope - _a.x - _b.x;
+	return {x, slope * (_a.x - x) - _a.y, false};
+}
+
+/// @returns the line through @a _a and @a _b (the tangent if they are equal), evaluated at the G1 point (@a _x, @a _y).
+FQ12 lineFunction(TwistPoint const& _a, TwistPoint const& _b, bigint const& _x, bigint const& _y)
+{
+	FQ12 result;
+	result[0] = modulo(-_y, c_bn128P);
+	if (_a.x == _b.x && _a.y != _b.y)
+	{
+		// Vertical line x - x_a * w^2.
+		result[0] = _x;
+		addEmbedded(result, FQ2{0, 0} - _a.x, 2);
+		return result;
+	}
+	FQ2 slope = _a.x == _b.x ?
+		FQ2{3, 0} * _a.x * _a.x * inverse(FQ2{2, 0} * _a.y) :
+		(_b.y - _a.y) * inverse(_b.x - _a.x);
+	// The slope on the untwisted curve is slope * w, so the line is
+	// slope * w * (x - x_a * w^2) - (y - y_a * w^3).
+	addEmbedded(result, slope * FQ2{_x, 0}, 1);
+	addEmbedded(result, _a.y - slope * _a.x, 3);
+	return result;
+}
+
+/// @returns the image of @a _point under the Frobenius endomorphism, expressed on the twisted curve.
+TwistPoint frobenius(TwistPoint const& _point)
+{
+	static FQ2 const xFactor = power(FQ2{9, 1}, (c_bn128P - 1) / 3);
+	static FQ2 const yFactor = power(FQ2{9, 1}, (c_bn128P - 1) / 2);
+	FQ2 x{_point.x.a, modulo(-_point.x.b, c_bn128P)};
+	FQ2 y{_point.y.a, modulo(-_point.y.b, c_bn128P)};
+	return {x * xFactor, y * yFactor, _point.infinity};
+}
+
+/// Optimal ate pairing without the final exponentiation.
+FQ12 millerLoop(TwistPoint const& _q, bigint const& _x, bigint const& _y)
+{
+	static bigint const ateLoopCount("29793968203157093288");
+	TwistPoint r = _q;
+	FQ12 f = one();
+	for (int i = 63; i >= 0; --i)
+	{
+		f = f * f * lineFunction(r, r, _x, _y);
+		r = addTwistPoints(r, r);
+		if (bit_test(ateLoopCount, unsigned(i)))
+		{
+			f = f * lineFunction(r, _q, _x, _y);
+			r = addTwistPoints(r, _q);
+		}
+	}
+	TwistPoint q1 = frobenius(_q);
+	TwistPoint nq2 = frobenius(q1);
+	nq2.y = FQ2{0, 0} - nq2.y;
+	f = f * lineFunction(r, q1, _x, _y);
+	r = addTwistPoints(r, q1);
+	return f * lineFunction(r, nq2, _x, _y);
+}
+
+boost::optional<bytes> bn128Pairing(bytesConstRef _input)
+{
+	static bigint const curveOrder("0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001");
+	static bigint const finalExponent = (boost::multiprecision::pow(c_bn128P, 12) - 1) / curveOrder;
+
+	if (_input.size() % 192 != 0)
+		return {};
+	FQ12 product = one();
+	for (size_t offset = 0; offset < _input.size(); offset += 192)
+	{
+		auto p = readG1Point(_input, offset);
+		if (!p)
+			return {};
+		array<bigint, 4> coordinates;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			coordinates[i] = wordAt(_input, offset + 64 + 32 * i);
+			if (coordinates[i] >= c_bn128P)
+				return {};
+		}
+		// The imaginary part comes first in the encoding.
+		TwistPoint q{{coordinates[1], coordinates[0]}, {coordinates[3], coordinates[2]}, false};
+		if (q.x == FQ2{0, 0} && q.y == FQ2{0, 0})
+			q.infinity = true;
+		else if (q.y * q.y != q.x * q.x * q.x + c_twistB)
+			return {};
+		// Membership of q in the correct subgroup is not checked.
+		if (p->z != 0 && !q.infinity)
+			product = product * millerLoop(q, p->x, p->y);
+	}
+
+	FQ12 result = one();
+	for (int i = int(msb(finalExponent)); i >= 0; --i)
+	{
+		result = result * result;
+		if (bit_test(finalExponent, unsigned(i)))
+			result = result * product;
+	}
+	return toBytes(result == one() ? 1 : 0);
+}
+
+}
+
+h256 dev::test::sha256(bytesConstRef _input)
+{
+	static uint32_t const k[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+	uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+	bytes message = padMessage(_input, true);
+	for (size_t chunk = 0; chunk < message.size(); chunk += 64)
+	{
+		uint32_t w[64];
+		for (size_t i = 0; i < 16; ++i)
+			w[i] =
+				(uint32_t(message[chunk + 4 * i]) << 24) |
+				(uint32_t(message[chunk + 4 * i + 1]) << 16) |
+				(uint32_t(message[chunk + 4 * i + 2]) << 8) |
+				uint32_t(message[chunk + 4 * i + 3]);
+		for (size_t i = 16; i < 64; ++i)
+		{
+			uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+		for (size_t i = 0; i < 64; ++i)
+		{
+			uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+			uint32_t choice = (e & f) ^ (~e & g);
+			uint32_t temp1 = hh + s1 + choice + k[i] + w[i];
+			uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+			uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+			uint32_t temp2 = s0 + majority;
+			hh = g;
+			g = f;
+			f = e;
+			e = d + temp1;
+			d = c;
+			c = b;
+			b = a;
+			a = temp1 + temp2;
+		}
+		h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+		h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+	}
+
+	h256 result;
+	for (size_t i = 0; i < 32; ++i)
+		result[i] = uint8_t(h[i / 4] >> (24 - 8 * (i % 4)));
+	return result;
+}
+
+h160 dev::test::ripemd160(bytesConstRef _input)
+{
+	static unsigned const r[80] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+		3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+		1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+		4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+	};
+	static unsigned const rPrime[80] = {
+		5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+		6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+		15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+		8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+		12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+	};
+	static unsigned const s[80] = {
+		11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+		7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+		11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+		11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+		9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+	};
+	static unsigned const sPrime[80] = {
+		8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+		9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+		9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+		15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+		8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+	};
+	static uint32_t const k[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+	static uint32_t const kPrime[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+	auto f = [](size_t _round, uint32_t _x, uint32_t _y, uint32_t _z) -> uint32_t
+	{
+		switch (_round / 16)
+		{
+		case 0: return _x ^ _y ^ _z;
+		case 1: return (_x & _y) | (~_x & _z);
+		case 2: return (_x | ~_y) ^ _z;
+		case 3: return (_x & _z) | (_y & ~_z);
+		default: return _x ^ (_y | ~_z);
+		}
+	};
+	uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+	bytes message = padMessage(_input, false);
+	for (size_t chunk = 0; chunk < message.size(); chunk += 64)
+	{
+		uint32_t x[16];
+		for (size_t i = 0; i < 16; ++i)
+			x[i] =
+				uint32_t(message[chunk + 4 * i]) |
+				(uint32_t(message[chunk + 4 * i + 1]) << 8) |
+				(uint32_t(message[chunk + 4 * i + 2]) << 16) |
+				(uint32_t(message[chunk + 4 * i + 3]) << 24);
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+		uint32_t aPrime = h[0], bPrime = h[1], cPrime = h[2], dPrime = h[3], ePrime = h[4];
+		for (size_t j = 0; j < 80; ++j)
+		{
+			uint32_t t = rotateLeft(a + f(j, b, c, d) + x[r[j]] + k[j / 16], s[j]) + e;
+			a = e;
+			e = d;
+			d = rotateLeft(c, 10);
+			c = b;
+			b = t;
+			t = rotateLeft(aPrime + f(79 - j, bPrime, cPrime, dPrime) + x[rPrime[j]] + kPrime[j / 16], sPrime[j]) + ePrime;
+			aPrime = ePrime;
+			ePrime = dPrime;
+			dPrime = rotateLeft(cPrime, 10);
+			cPrime = bPrime;
+			bPrime = t;
+		}
+		uint32_t t = h[1] + c + dPrime;
+		h[1] = h[2] + d + ePrime;
+		h[2] = h[3] + e + aPrime;
+		h[3] = h[4] + a + bPrime;
+		h[4] = h[0] + b + cPrime;
+		h[0] = t;
+	}
+
+	h160 result;
+	for (size_t i = 0; i < 20; ++i)
+		result[i] = uint8_t(h[i / 4] >> (8 * (i % 4)));
+	return result;
+}
+
+bool dev::test::isPrecompiled(h160 const& _address, solidity::EVMVersion _evmVersion)
+{
+	u160 address(_address);
+	if (address >= 1 && address <= 4)
+		return true;
+	return address >= 5 && address <= 8 && _evmVersion >= solidity::EVMVersion::byzantium();
+}
+
+bigint dev::test::precompiledGas(h160 const& _address, bytesConstRef _input)
+{
+	bigint words = (bigint(_input.size()) + 31) / 32;
+	switch (unsigned(u160(_address)))
+	{
+	case 1: return 3000;
+	case 2: return 60 + 12 * words;
+	case 3: return 600 + 120 * words;
+	case 4: return 15 + 3 * words;
+	case 5: return modexpGas(_input);
+	case 6: return 500;
+	case 7: return 40000;
+	case 8: return 100000 + 80000 * bigint(_input.size() / 192);
+	}
+	return 0;
+}
+
+boost::optional<bytes> dev::test::executePrecompiled(h160 const& _address, bytesConstRef _input)
+{
+	switch (unsigned(u160(_address)))
+	{
+	case 1: return ecrecover(_input);
+	case 2: return sha256(_input).asBytes();
+	case 3: return bytes(12, 0) + ripemd160(_input).asBytes();
+	case 4: return _input.toBytes();
+	case 5: return modexp(_input);
+	case 6: return bn128Add(_input);
+	case 7: return bn128Mul(_input);
+	case 8: return bn128Pairing(_input);
+	}
+	return {};
+}
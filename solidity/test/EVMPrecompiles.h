@@ -0,0 +1,49 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Precompiled contracts of the in-process EVM interpreter.
+ */
+
+#pragma once
+
+#include <liblangutil/EVMVersion.h>
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <boost/optional.hpp>
+
+namespace dev
+{
+namespace test
+{
+
+/// @returns true if @a _address is a precompiled contract in @a _evmVersion.
+bool isPrecompiled(h160 const& _address, solidity::EVMVersion _evmVersion);
+
+/// @returns the gas costs of calling the precompiled contract at @a _address with @a _input.
+bigint precompiledGas(h160 const& _address, bytesConstRef _input);
+
+/// Executes the precompiled contract at @a _address.
+/// @returns the output or nothing if the input is invalid, which consumes all gas of the call.
+boost::optional<bytes> executePrecompiled(h160 const& _address, bytesConstRef _input);
+
+h256 sha256(bytesConstRef _input);
+h160 ripemd160(bytesConstRef _input);
+
+}
+}
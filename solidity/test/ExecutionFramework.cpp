@@ -23,6 +23,7 @@
 #include <test/ExecutionFramework.h>
 
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/ThreadPool.h>
 
 #include <boost/test/framework.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -47,16 +48,47 @@ string getIPCSocketPath()
 	return ipcPath;
 }
 
+unique_ptr<ethash::Verifier> createEthashVerifier()
+{
+	unique_ptr<ethash::Verifier> verifier(new ethash::Verifier());
+	boost::filesystem::path const& datasetPath = dev::test::Options::get().ethashDatasetPath;
+	if (!datasetPath.empty())
+		verifier->useFullDatasets(datasetPath, ThreadPool::hardwareConcurrency());
+	return verifier;
+}
+
 }
 
 ExecutionFramework::ExecutionFramework() :
-	m_rpc(RPCSession::instance(getIPCSocketPath())),
 	m_evmVersion(dev::test::Options::get().evmVersion()),
 	m_optimize(dev::test::Options::get().optimize),
-	m_showMessages(dev::test::Options::get().showMessages),
-	m_sender(m_rpc.account(0))
+	m_showMessages(dev::test::Options::get().showMessages)
 {
-	m_rpc.test_rewindToBlock(0);
+	if (dev::test::Options::get().useEVMInterpreter)
+	{
+		m_evm.reset(new EVMInterpreter(m_evmVersion));
+		m_evm->setEthashVerifier([](
+			u256 const& _blockNumber,
+			h256 const& _headerHash,
+			h256 const& _mixHash,
+			u256 const& _nonce,
+			u256 const& _difficulty
+		) {
+			return ethashVerifier().verify(_blockNumber, _headerHash, _mixHash, _nonce, _difficulty);
+		});
+	}
+	else
+	{
+		m_rpc = &RPCSession::instance(getIPCSocketPath());
+		m_rpc->test_rewindToBlock(0);
+	}
+	m_sender = account(0);
+}
+
+ethash::Verifier& ExecutionFramework::ethashVerifier()
+{
+	static unique_ptr<ethash::Verifier> verifier = createEthashVerifier();
+	return *verifier;
 }
 
 std::pair<bool, string> ExecutionFramework::compareAndCreateMessage(
@@ -87,18 +119,24 @@ std::pair<bool, string> ExecutionFramework::compareAndCreateMessage(
 
 u256 ExecutionFramework::gasLimit() const
 {
-	auto latestBlock = m_rpc.eth_getBlockByNumber("latest", false);
+	if (m_evm)
+		return m_evm->gasLimit();
+	auto latestBlock = m_rpc->eth_getBlockByNumber("latest", false);
 	return u256(latestBlock["gasLimit"].asString());
 }
 
 u256 ExecutionFramework::gasPrice() const
 {
-	return u256(m_rpc.eth_gasPrice());
+	if (m_evm)
+		return m_gasPrice;
+	return u256(m_rpc->eth_gasPrice());
 }
 
 u256 ExecutionFramework::blockHash(u256 const& _blockNumber) const
 {
-	return u256(m_rpc.eth_getBlockByNumber(toHex(_blockNumber, HexPrefix::Add), false)["hash"].asString());
+	if (m_evm)
+		return u256(m_evm->block(_blockNumber).hash);
+	return u256(m_rpc->eth_getBlockByNumber(toHex(_blockNumber, HexPrefix::Add), false)["hash"].asString());
 }
 
 void ExecutionFramework::sendMessage(bytes const& _data, bool _isCreation, u256 const& _value)
@@ -113,6 +151,11 @@ void ExecutionFramework::sendMessage(bytes const& _data, bool _isCreation, u256
 			cout << " value: " << _value << endl;
 		cout << " in:      " << toHex(_data) << endl;
 	}
+	if (m_evm)
+	{
+		sendMessageToInterpreter(_data, _isCreation, _value);
+		return;
+	}
 	RPCSession::TransactionData d;
 	d.data = "0x" + toHex(_data);
 	d.from = "0x" + toString(m_sender);
@@ -122,14 +165,14 @@ void ExecutionFramework::sendMessage(bytes const& _data, bool _isCreation, u256
 	if (!_isCreation)
 	{
 		d.to = dev::toString(m_contractAddress);
-		BOOST_REQUIRE(m_rpc.eth_getCode(d.to, "pending").size() > 2);
+		BOOST_REQUIRE(m_rpc->eth_getCode(d.to, "pending").size() > 2);
 		// Use eth_call to get the output
-		m_output = fromHex(m_rpc.eth_call(d, "pending"), WhenError::Throw);
+		m_output = fromHex(m_rpc->eth_call(d, "pending"), WhenError::Throw);
 	}
 
-	string txHash = m_rpc.eth_sendTransaction(d);
-	m_rpc.test_mineBlocks(1);
-	RPCSession::TransactionReceipt receipt(m_rpc.eth_getTransactionReceipt(txHash));
+	string txHash = m_rpc->eth_sendTransaction(d);
+	m_rpc->test_mineBlocks(1);
+	RPCSession::TransactionReceipt receipt(m_rpc->eth_getTransactionReceipt(txHash));
 
 	m_blockNumber = u256(receipt.blockNumber);
 
@@ -137,7 +180,7 @@ void ExecutionFramework::sendMessage(bytes const& _data, bool _isCreation, u256
 	{
 		m_contractAddress = Address(receipt.contractAddress);
 		BOOST_REQUIRE(m_contractAddress);
-		string code = m_rpc.eth_getCode(receipt.contractAddress, "latest");
+		string code = m_rpc->eth_getCode(receipt.contractAddress, "latest");
 		m_output = fromHex(code, WhenError::Throw);
 	}
 
@@ -165,8 +208,41 @@ void ExecutionFramework::sendMessage(bytes const& _data, bool _isCreation, u256
 		m_transactionSuccessful = (m_gas != m_gasUsed);
 }
 
+void ExecutionFramework::sendMessageToInterpreter(bytes const& _data, bool _isCreation, u256 const& _value)
+{
+	boost::optional<Address> to;
+	if (!_isCreation)
+	{
+		BOOST_REQUIRE(addressHasCode(m_contractAddress));
+		to = m_contractAddress;
+	}
+	EVMInterpreter::TransactionResult result = m_evm->transact(m_sender, to, _value, _data, m_gas, m_gasPrice);
+
+	m_blockNumber = result.blockNumber;
+	m_output = result.output;
+	if (_isCreation)
+	{
+		m_contractAddress = result.createdAddress;
+		BOOST_REQUIRE(m_contractAddress);
+	}
+
+	if (m_showMessages)
+		cout << " out:     " << toHex(m_output) << endl;
+
+	m_gasUsed = result.gasUsed;
+	m_logs.clear();
+	for (auto const& log: result.logs)
+		m_logs.push_back(LogEntry{log.address, log.topics, log.data});
+	m_transactionSuccessful = result.success;
+}
+
 void ExecutionFramework::sendEther(Address const& _to, u256 const& _value)
 {
+	if (m_evm)
+	{
+		m_evm->transact(m_sender, _to, _value, bytes(), m_gas, m_gasPrice);
+		return;
+	}
 	RPCSession::TransactionData d;
 	d.data = "0x";
 	d.from = "0x" + toString(m_sender);
@@ -175,41 +251,86 @@ void ExecutionFramework::sendEther(Address const& _to, u256 const& _value)
 	d.value = toHex(_value, HexPrefix::Add);
 	d.to = dev::toString(_to);
 
-	string txHash = m_rpc.eth_sendTransaction(d);
-	m_rpc.test_mineBlocks(1);
+	string txHash = m_rpc->eth_sendTransaction(d);
+	m_rpc->test_mineBlocks(1);
 }
 
 size_t ExecutionFramework::currentTimestamp()
 {
-	auto latestBlock = m_rpc.eth_getBlockByNumber("latest", false);
+	if (m_evm)
+		return size_t(m_evm->latestBlock().timestamp);
+	auto latestBlock = m_rpc->eth_getBlockByNumber("latest", false);
 	return size_t(u256(latestBlock.get("timestamp", "invalid").asString()));
 }
 
 size_t ExecutionFramework::blockTimestamp(u256 _number)
 {
-	auto latestBlock = m_rpc.eth_getBlockByNumber(toString(_number), false);
+	if (m_evm)
+		return size_t(m_evm->block(_number).timestamp);
+	auto latestBlock = m_rpc->eth_getBlockByNumber(toString(_number), false);
 	return size_t(u256(latestBlock.get("timestamp", "invalid").asString()));
 }
 
+void ExecutionFramework::mineBlocks(unsigned _number)
+{
+	if (m_evm)
+		m_evm->mineBlocks(_number);
+	else
+		m_rpc->test_mineBlocks(int(_number));
+}
+
+void ExecutionFramework::modifyTimestamp(size_t _timestamp)
+{
+	if (m_evm)
+		m_evm->setNextTimestamp(_timestamp);
+	else
+		m_rpc->test_modifyTimestamp(_timestamp);
+}
+
+void ExecutionFramework::setCoinbase(Address const& _coinbase)
+{
+	if (m_evm)
+		m_evm->setCoinbase(_coinbase);
+	else
+		BOOST_REQUIRE(m_rpc->rpcCall("miner_setEtherbase", {"\"0x" + _coinbase.hex() + "\""}).asBool());
+}
+
 Address ExecutionFramework::account(size_t _i)
 {
-	return Address(m_rpc.accountCreateIfNotExists(_i));
+	if (m_evm)
+		return m_evm->account(_i);
+	return Address(m_rpc->accountCreateIfNotExists(_i));
 }
 
 bool ExecutionFramework::addressHasCode(Address const& _addr)
 {
-	string code = m_rpc.eth_getCode(toString(_addr), "latest");
+	if (m_evm)
+	{
+		EVMInterpreter::Account const* account = m_evm->accountAt(_addr);
+		return account && !account->code.empty();
+	}
+	string code = m_rpc->eth_getCode(toString(_addr), "latest");
 	return !code.empty() && code != "0x";
 }
 
 u256 ExecutionFramework::balanceAt(Address const& _addr)
 {
-	return u256(m_rpc.eth_getBalance(toString(_addr), "latest"));
+	if (m_evm)
+	{
+		EVMInterpreter::Account const* account = m_evm->accountAt(_addr);
+		return account ? account->balance : 0;
+	}
+	return u256(m_rpc->eth_getBalance(toString(_addr), "latest"));
 }
 
 bool ExecutionFramework::storageEmpty(Address const& _addr)
 {
-	h256 root(m_rpc.eth_getStorageRoot(toString(_addr), "latest"));
+	if (m_evm)
+	{
+		EVMInterpreter::Account const* account = m_evm->accountAt(_addr);
+		return !account || account->storage.empty();
+	}
+	h256 root(m_rpc->eth_getStorageRoot(toString(_addr), "latest"));
 	BOOST_CHECK(root);
 	return root == EmptyTrie;
 }
@@ -22,15 +22,18 @@
 
 #pragma once
 
+#include <test/EVMInterpreter.h>
 #include <test/Options.h>
 #include <test/RPCSession.h>
 
 #include <liblangutil/EVMVersion.h>
 
+#include <libdevcore/Ethash.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Keccak256.h>
 
 #include <functional>
+#include <memory>
 
 namespace dev
 {
@@ -202,6 +205,8 @@ public:
 	}
 
 private:
+	void sendMessageToInterpreter(bytes const& _data, bool _isCreation, u256 const& _value);
+
 	template <class CppFunction, class... Args>
 	auto callCppAndEncodeResult(CppFunction const& _cppFunction, Args const&... _arguments)
 	-> typename std::enable_if<std::is_void<decltype(_cppFunction(_arguments...))>::value, bytes>::type
@@ -221,6 +226,14 @@ protected:
 	void sendEther(Address const& _to, u256 const& _value);
 	size_t currentTimestamp();
 	size_t blockTimestamp(u256 _number);
+	void mineBlocks(unsigned _number);
+	/// Sets the timestamp of the next block.
+	void modifyTimestamp(size_t _timestamp);
+	/// Sets the beneficiary of all following blocks.
+	void setCoinbase(Address const& _coinbase);
+	/// @returns the verifier evaluating the ETHASH instruction on the interpreter,
+	/// which is shared by all tests such that light caches are only generated once.
+	static ethash::Verifier& ethashVerifier();
 
 	/// @returns the (potentially newly created) _ith address.
 	Address account(size_t _i);
@@ -229,7 +242,10 @@ protected:
 	bool storageEmpty(Address const& _addr);
 	bool addressHasCode(Address const& _addr);
 
-	RPCSession& m_rpc;
+	/// Backend executing the transactions: either an external node reached via RPC
+	/// or, if requested by the options, the in-process interpreter.
+	RPCSession* m_rpc = nullptr;
+	std::unique_ptr<EVMInterpreter> m_evm;
 
 	struct LogEntry
 	{
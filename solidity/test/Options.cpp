@@ -64,10 +64,17 @@ Options::Options()
 			showMessages = true;
 		else if (string(suite.argv[i]) == "--no-ipc")
 			disableIPC = true;
+		else if (string(suite.argv[i]) == "--evm-interpreter")
+			useEVMInterpreter = true;
+		else if (string(suite.argv[i]) == "--ethash-dag-dir" && i + 1 < suite.argc)
+		{
+			ethashDatasetPath = suite.argv[i + 1];
+			i++;
+		}
 		else if (string(suite.argv[i]) == "--no-smt")
 			disableSMT = true;
 
-	if (!disableIPC && ipcPath.empty())
+	if (!disableIPC && !useEVMInterpreter && ipcPath.empty())
 		if (auto path = getenv("ETH_TEST_IPC"))
 			ipcPath = path;
 
@@ -85,10 +92,10 @@ void Options::validate() const
 		!dev::test::Options::get().testPath.empty(),
 		"No test path specified. The --testpath argument is required."
 	);
-	if (!disableIPC)
+	if (!disableIPC && !useEVMInterpreter)
 		solAssert(
 			!dev::test::Options::get().ipcPath.empty(),
-			"No ipc path specified. The --ipcpath argument is required, unless --no-ipc is used."
+			"No ipc path specified. The --ipcpath argument is required, unless --no-ipc or --evm-interpreter is used."
 		);
 }
 
@@ -40,6 +40,10 @@ struct Options: boost::noncopyable
 	bool showMessages = false;
 	bool optimize = false;
 	bool disableIPC = false;
+	/// Execute contracts using the in-process EVM interpreter instead of an external node.
+	bool useEVMInterpreter = false;
+	/// Directory of the full Ethash datasets used by the interpreter. If empty, light caches are used.
+	boost::filesystem::path ethashDatasetPath;
 	bool disableSMT = false;
 
 	void validate() const;
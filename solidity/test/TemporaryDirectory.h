@@ -0,0 +1,47 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Temporary directory for tests that work with files.
+ */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+namespace dev
+{
+namespace test
+{
+
+/// Directory with a unique name in the temporary directory of the system,
+/// which is removed at the end of the test.
+class TemporaryDirectory
+{
+public:
+	explicit TemporaryDirectory(std::string const& _prefix = "solidity-test"):
+		m_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(_prefix + "-%%%%-%%%%"))
+	{}
+	~TemporaryDirectory() { boost::filesystem::remove_all(m_path); }
+	boost::filesystem::path const& path() const { return m_path; }
+private:
+	boost::filesystem::path m_path;
+};
+
+}
+}
@@ -162,7 +162,7 @@ test_suite* init_unit_test_suite( int /*argc*/, char* /*argv*/[] )
 			SMTCheckerTest::create
 		) > 0, "no SMT checker JSON tests found");
 	}
-	if (dev::test::Options::get().disableIPC)
+	if (dev::test::Options::get().disableIPC && !dev::test::Options::get().useEVMInterpreter)
 	{
 		for (auto suite: {
 			"ABIDecoderTest",
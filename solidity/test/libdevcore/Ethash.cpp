@@ -0,0 +1,183 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the Ethash light client verification.
+ */
+
+#include <libdevcore/Ethash.h>
+#include <libdevcore/Keccak256.h>
+
+#include <test/Options.h>
+#include <test/TemporaryDirectory.h>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(Ethash)
+
+BOOST_AUTO_TEST_CASE(keccak512)
+{
+	BOOST_CHECK_EQUAL(
+		toHex(dev::keccak512(bytesConstRef()).asBytes()),
+		"0eab42de4c3ceb9235fc91acffe746b29c29a8c366b7c60e4e67c466f36a4304"
+		"c00fa9caf9d87976ba469bcbe06713b435f091ef2769fb160cdab33d3670680e"
+	);
+}
+
+BOOST_AUTO_TEST_CASE(seed_hash)
+{
+	BOOST_CHECK_EQUAL(ethash::seedHash(0), h256());
+	BOOST_CHECK_EQUAL(ethash::seedHash(1), h256("290decd9548b62a8d60345a988386fc84ba6bc95484008f6362f93160ef3e563"));
+	BOOST_CHECK_EQUAL(ethash::seedHash(2), keccak256(ethash::seedHash(1)));
+}
+
+BOOST_AUTO_TEST_CASE(sizes)
+{
+	BOOST_CHECK_EQUAL(ethash::lightCacheSize(0), 16776896);
+	BOOST_CHECK_EQUAL(ethash::datasetSize(0), 1073739904);
+	BOOST_CHECK_EQUAL(ethash::lightCacheSize(1), 16907456);
+	BOOST_CHECK_EQUAL(ethash::datasetSize(1), 1082130304);
+}
+
+BOOST_AUTO_TEST_CASE(hashimoto_light)
+{
+	// Cache of 1 KB and dataset of 32 KB for epoch 0.
+	ethash::LightCache cache(h256(), 1024, 32 * 1024);
+	ethash::Result result = cache.hashimoto(h256("c9149cc0386e689d789a1c2f3d5d169a61a6218ed30e74414dc736e442ef3d1f"), 0);
+	BOOST_CHECK_EQUAL(result.mixHash, h256("e4073cffaef931d37117cefd9afd27ea0f1cad6a981dd2605c4a1ac97c519800"));
+	BOOST_CHECK_EQUAL(result.finalHash, h256("d3539235ee2e6f8db665c0a72169f55b7f6c605712330b778ec3944f0eb5a557"));
+}
+
+BOOST_AUTO_TEST_CASE(hashimoto_batch)
+{
+	ethash::LightCache cache(h256(), 1024, 32 * 1024);
+	// Not a multiple of the number of lanes.
+	vector<ethash::HashimotoInput> inputs;
+	for (uint64_t i = 0; i < 2 * ethash::c_lanes + 3; ++i)
+		inputs.emplace_back(keccak256(to_string(i)), i * 7);
+	vector<ethash::Result> results = cache.hashimoto(inputs);
+	BOOST_REQUIRE_EQUAL(results.size(), inputs.size());
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		ethash::Result expectation = cache.hashimoto(inputs[i].first, inputs[i].second);
+		BOOST_CHECK_EQUAL(results[i].mixHash, expectation.mixHash);
+		BOOST_CHECK_EQUAL(results[i].finalHash, expectation.finalHash);
+	}
+
+	TemporaryDirectory directory("solidity-ethash");
+	ethash::Dataset dataset(cache, directory.path() / "dataset", 1);
+	results = dataset.hashimoto(inputs);
+	BOOST_REQUIRE_EQUAL(results.size(), inputs.size());
+	for (size_t i = 0; i < inputs.size(); ++i)
+		BOOST_CHECK_EQUAL(results[i].mixHash, cache.hashimoto(inputs[i].first, inputs[i].second).mixHash);
+
+	BOOST_CHECK(cache.hashimoto(vector<ethash::HashimotoInput>{}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(full_dataset)
+{
+	TemporaryDirectory directory("solidity-ethash");
+	boost::filesystem::path file = directory.path() / ethash::datasetFileName(0);
+	BOOST_CHECK_EQUAL(file.filename().string(), "full-R23-0000000000000000");
+
+	ethash::LightCache cache(h256(), 1024, 32 * 1024);
+	h256 header("c9149cc0386e689d789a1c2f3d5d169a61a6218ed30e74414dc736e442ef3d1f");
+	{
+		ethash::Dataset dataset(cache, file, 3);
+		BOOST_CHECK(dataset.generated());
+		BOOST_CHECK_EQUAL(dataset.size(), 32 * 1024);
+		for (uint32_t i = 0; i < dataset.size() / 64; ++i)
+			BOOST_REQUIRE_EQUAL(dataset.item(i), cache.datasetItem(i));
+		ethash::Result result = dataset.hashimoto(header, 0);
+		BOOST_CHECK_EQUAL(result.mixHash, h256("e4073cffaef931d37117cefd9afd27ea0f1cad6a981dd2605c4a1ac97c519800"));
+		BOOST_CHECK_EQUAL(result.finalHash, h256("d3539235ee2e6f8db665c0a72169f55b7f6c605712330b778ec3944f0eb5a557"));
+	}
+
+	// The file is reused.
+	{
+		ethash::Dataset dataset(cache, file, 1);
+		BOOST_CHECK(!dataset.generated());
+		BOOST_CHECK_EQUAL(dataset.hashimoto(header, 0).mixHash, cache.hashimoto(header, 0).mixHash);
+	}
+
+	// Incomplete files are regenerated.
+	boost::filesystem::resize_file(file, 1024);
+	{
+		ethash::Dataset dataset(cache, file, 2);
+		BOOST_CHECK(dataset.generated());
+		BOOST_CHECK_EQUAL(dataset.hashimoto(header, 7).mixHash, cache.hashimoto(header, 7).mixHash);
+	}
+	BOOST_CHECK_EQUAL(boost::filesystem::file_size(file), 8 + 32 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(verifier)
+{
+	ethash::Verifier verifier(1);
+	h256 header = keccak256("header");
+	ethash::Result result = verifier.lightCache(0)->hashimoto(header, 42);
+	BOOST_CHECK_EQUAL(verifier.generatedCaches(), 1);
+
+	BOOST_CHECK(verifier.verify(0, header, result.mixHash, 42, 1));
+	BOOST_CHECK(verifier.verify(ethash::c_epochLength - 1, header, result.mixHash, 42, 1));
+	BOOST_CHECK(!verifier.verify(0, header, result.mixHash, 43, 1));
+	BOOST_CHECK(!verifier.verify(0, header, ~result.mixHash, 42, 1));
+	BOOST_CHECK(!verifier.verify(0, header, result.mixHash, 42, 0));
+	BOOST_CHECK(!verifier.verify(0, header, result.mixHash, (u256(1) << 64) + 42, 1));
+	BOOST_CHECK(!verifier.verify(0, header, result.mixHash, 42, u256(-1)));
+	// Largest difficulty met by the final hash.
+	u256 difficulty = u256((bigint(1) << 256) / bigint(u256(result.finalHash)));
+	BOOST_CHECK(verifier.verify(0, header, result.mixHash, 42, difficulty));
+	BOOST_CHECK(!verifier.verify(0, header, result.mixHash, 42, difficulty + 1));
+	// All checks used the kept light cache.
+	BOOST_CHECK_EQUAL(verifier.generatedCaches(), 1);
+
+	BOOST_CHECK(!verifier.verify((ethash::c_maxEpoch + 1) * ethash::c_epochLength, header, result.mixHash, 42, 1));
+	BOOST_CHECK_EQUAL(verifier.generatedCaches(), 1);
+
+	BOOST_CHECK_THROW(verifier.dataset(0), ethash::EthashError);
+
+	vector<ethash::ProofOfWork> proofs;
+	vector<bool> expectations;
+	for (uint64_t i = 0; i < 20; ++i)
+	{
+		h256 headerHash = keccak256(to_string(i));
+		h256 mixHash = verifier.lightCache(0)->hashimoto(headerHash, i).mixHash;
+		proofs.push_back({i * 1000, headerHash, mixHash, i, 1});
+		expectations.push_back(true);
+		proofs.push_back({i * 1000, headerHash, mixHash, i + 1, 1});
+		expectations.push_back(false);
+	}
+	proofs.push_back({0, header, result.mixHash, 42, u256(-1)});
+	expectations.push_back(false);
+	proofs.push_back({(ethash::c_maxEpoch + 1) * ethash::c_epochLength, header, result.mixHash, 42, 1});
+	expectations.push_back(false);
+	for (size_t threads: {1, 3})
+	{
+		vector<bool> valid = verifier.verify(proofs, threads);
+		BOOST_CHECK_EQUAL_COLLECTIONS(valid.begin(), valid.end(), expectations.begin(), expectations.end());
+	}
+	BOOST_CHECK_EQUAL(verifier.generatedCaches(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
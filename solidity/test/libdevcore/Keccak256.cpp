@@ -0,0 +1,133 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the Keccak-256 hash function.
+ */
+
+#include <libdevcore/Keccak256.h>
+
+#include <test/Options.h>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(Keccak256)
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+	BOOST_CHECK_EQUAL(
+		keccak256(bytes()),
+		h256("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470")
+	);
+}
+
+BOOST_AUTO_TEST_CASE(short_inputs)
+{
+	BOOST_CHECK_EQUAL(
+		keccak256("abc"),
+		h256("4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45")
+	);
+}
+
+namespace
+{
+/// Hashes of inputs consisting of the letter "a", around multiples of the rate of 136 bytes.
+vector<pair<size_t, h256>> const c_longInputs{
+	{135, h256("34367dc248bbd832f4e3e69dfaac2f92638bd0bbd18f2912ba4ef454919cf446")},
+	{136, h256("a6c4d403279fe3e0af03729caada8374b5ca54d8065329a3ebcaeb4b60aa386e")},
+	{137, h256("d869f639c7046b4929fc92a4d988a8b22c55fbadb802c0c66ebcd484f1915f39")},
+	{200, h256("96ea54061def936c4be90b518992fdc6f12f535068a256229aca54267b4d084d")},
+	{272, h256("cf7fcd4f705ee749930d19ca84561a9bf62516bd90a471545fa2f49fdc7e63c8")},
+	{1000, h256("b6a4ac1f51884d71f30fa397a5e155de3099e11fc0edef5d08b646e621e19de9")}
+};
+}
+
+BOOST_AUTO_TEST_CASE(long_inputs)
+{
+	for (auto const& input: c_longInputs)
+		BOOST_CHECK_EQUAL(keccak256(string(input.first, 'a')), input.second);
+}
+
+BOOST_AUTO_TEST_CASE(batch_long_inputs)
+{
+	// Several inputs of each length, such that they are hashed in parallel lanes.
+	vector<string> data;
+	for (auto const& input: c_longInputs)
+		for (size_t i = 0; i < 5; ++i)
+			data.push_back(string(input.first, 'a'));
+	vector<bytesConstRef> inputs;
+	for (string const& input: data)
+		inputs.push_back(bytesConstRef(input));
+	vector<h256> hashes = keccak256(inputs);
+	BOOST_REQUIRE_EQUAL(hashes.size(), inputs.size());
+	for (size_t i = 0; i < hashes.size(); ++i)
+		BOOST_CHECK_EQUAL(hashes[i], c_longInputs[i / 5].second);
+}
+
+BOOST_AUTO_TEST_CASE(batch)
+{
+	// Lengths around multiples of the rate, such that groups of inputs have the same number
+	// of blocks, followed by inputs that are left over.
+	vector<bytes> data;
+	for (size_t length = 0; length < 300; ++length)
+	{
+		data.push_back(bytes(length));
+		for (size_t i = 0; i < length; ++i)
+			data.back()[i] = uint8_t(length * 31 + i);
+	}
+	vector<bytesConstRef> inputs;
+	for (bytes const& input: data)
+		inputs.push_back(bytesConstRef(&input));
+	vector<h256> hashes = keccak256(inputs);
+	BOOST_REQUIRE_EQUAL(hashes.size(), inputs.size());
+	for (size_t i = 0; i < inputs.size(); ++i)
+		BOOST_CHECK_EQUAL(hashes[i], keccak256(inputs[i]));
+
+	BOOST_CHECK(keccak256(vector<bytesConstRef>{}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(keccak512_batch)
+{
+	vector<pair<string, h512>> const known{
+		{"", h512("0eab42de4c3ceb9235fc91acffe746b29c29a8c366b7c60e4e67c466f36a4304c00fa9caf9d87976ba469bcbe06713b435f091ef2769fb160cdab33d3670680e")},
+		{"abc", h512("18587dc2ea106b9a1563e32b3312421ca164c7f1f07bc922a9c83d77cea3a1e5d0c69910739025372dc14ac9642629379540c17e2a65b19d77aa511a9d00bb96")},
+		{string(71, 'a'), h512("a57dce7da8ec781665705f3d69310beaaa5b0cae0c9c34c9b1c5b7238bbd2ce385bbe2f37694d2b8e9a55eb889eecb80d74ff4f9086067b47fd3f43c16c0b506")},
+		{string(72, 'a'), h512("4cb1cecbc96415025c7a9d6fb89f82a8482773fd9664c378691a05323ff4700fa3e60414e6064814f98b36a61a87f62dffa7c56a2371355868dd37b8a654cf50")},
+		{string(144, 'a'), h512("2a50e1f8ac7438c5694d5f46036bb5f2e590c1108869d14953b3a68ab79b6309fe04bf52f23b10995165440f07330ba72f2a4523c9fe3f9534c32b72e9eb4639")}
+	};
+	// Thirteen copies of each input, such that there are groups of eight and four and a single input left.
+	vector<bytesConstRef> inputs;
+	for (auto const& input: known)
+	{
+		BOOST_CHECK_EQUAL(keccak512(bytesConstRef(input.first)), input.second);
+		for (size_t i = 0; i < 13; ++i)
+			inputs.push_back(bytesConstRef(input.first));
+	}
+	vector<h512> hashes = keccak512(inputs);
+	BOOST_REQUIRE_EQUAL(hashes.size(), inputs.size());
+	for (size_t i = 0; i < hashes.size(); ++i)
+		BOOST_CHECK_EQUAL(hashes[i], known[i / 13].second);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,159 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the profiler of compiler phases.
+ */
+
+#include <libdevcore/Profiler.h>
+#include <libdevcore/ThreadPool.h>
+
+#include <test/Options.h>
+
+#include <thread>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(ProfilerTest)
+
+BOOST_AUTO_TEST_CASE(inactive)
+{
+	BOOST_CHECK(!Profiler::current().profiler);
+	BOOST_CHECK(!Profiler::active());
+	{
+		ProfilerScope scope("phase");
+		BOOST_CHECK(Profiler::current().phase.empty());
+	}
+	Profiler profiler;
+	{
+		ProfilerActivation activation(profiler);
+		BOOST_CHECK_EQUAL(Profiler::current().profiler, &profiler);
+	}
+	BOOST_CHECK(!Profiler::current().profiler);
+	BOOST_CHECK(profiler.phases().empty());
+}
+
+BOOST_AUTO_TEST_CASE(nested_phases)
+{
+	Profiler profiler;
+	{
+		ProfilerActivation activation(profiler);
+		ProfilerScope outer("outer");
+		for (size_t i = 0; i < 3; ++i)
+		{
+			ProfilerScope inner("inner");
+			BOOST_CHECK_EQUAL(Profiler::current().phase, "outer/inner");
+		}
+		BOOST_CHECK_EQUAL(Profiler::current().phase, "outer");
+		ProfilerActivation contractActivation(Profiler::contractContext("C"));
+		ProfilerScope contractPhase("codegen");
+	}
+	Profiler::Phases phases = profiler.phases();
+	BOOST_REQUIRE_EQUAL(phases.size(), 2);
+	BOOST_CHECK_EQUAL(phases["outer"].calls, 1);
+	BOOST_CHECK_EQUAL(phases["outer/inner"].calls, 3);
+	BOOST_CHECK(phases["outer"].seconds >= phases["outer/inner"].seconds);
+
+	map<string, Profiler::Phases> contractPhases = profiler.contractPhases();
+	BOOST_REQUIRE_EQUAL(contractPhases.size(), 1);
+	BOOST_CHECK_EQUAL(contractPhases["C"].size(), 1);
+	BOOST_CHECK_EQUAL(contractPhases["C"]["codegen"].calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_tasks)
+{
+	Profiler profiler;
+	{
+		ProfilerActivation activation(profiler);
+		ProfilerScope scope("parallel");
+		parallelFor(4, 20, [](size_t)
+		{
+			ProfilerScope task("task");
+		});
+	}
+	Profiler::Phases phases = profiler.phases();
+	BOOST_CHECK_EQUAL(phases["parallel"].calls, 1);
+	BOOST_CHECK_EQUAL(phases["parallel/task"].calls, 20);
+}
+
+BOOST_AUTO_TEST_CASE(changed_blocks)
+{
+	Profiler profiler;
+	{
+		ProfilerActivation activation(profiler);
+		for (size_t i = 0; i < 2; ++i)
+		{
+			ProfilerScope scope("blocks");
+			scope.countBlocks(10, i);
+		}
+		ProfilerScope other("other");
+	}
+	Profiler::Phases phases = profiler.phases();
+	BOOST_CHECK_EQUAL(phases["blocks"].blocks, 20);
+	BOOST_CHECK_EQUAL(phases["blocks"].changedBlocks, 1);
+	BOOST_CHECK_EQUAL(phases["other"].blocks, 0);
+}
+
+BOOST_AUTO_TEST_CASE(peak_allocation)
+{
+	Profiler profiler;
+	{
+		ProfilerActivation activation(profiler);
+		ProfilerScope outer("outer");
+		{
+			ProfilerScope inner("inner");
+			Profiler::deallocated(Profiler::allocated(1000), 1000);
+		}
+		Profiler::deallocated(Profiler::allocated(300), 300);
+	}
+	Profiler::Phases phases = profiler.phases();
+	BOOST_CHECK_EQUAL(phases["outer/inner"].peakAllocation, 1000);
+	BOOST_CHECK_EQUAL(phases["outer"].peakAllocation, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(allocation_freed_by_other_thread)
+{
+	Profiler profiler;
+	ProfilerActivation activation(profiler);
+	BOOST_CHECK(Profiler::active());
+	Profiler::AllocationCounter* counter = Profiler::allocated(1000);
+	Profiler::Context context = Profiler::current();
+	thread([&]()
+	{
+		ProfilerActivation threadActivation(context);
+		ProfilerScope scope("other");
+		// Freeing memory of another thread does not offset the allocations of this thread.
+		Profiler::deallocated(counter, 1000);
+		Profiler::deallocated(Profiler::allocated(700), 700);
+	}).join();
+	{
+		ProfilerScope scope("own");
+		Profiler::deallocated(Profiler::allocated(200), 200);
+	}
+	Profiler::Phases phases = profiler.phases();
+	BOOST_CHECK_EQUAL(phases["other"].peakAllocation, 700);
+	BOOST_CHECK_EQUAL(phases["own"].peakAllocation, 200);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,127 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the thread pool.
+ */
+
+#include <libdevcore/ThreadPool.h>
+#include <libdevcore/Exceptions.h>
+
+#include <test/Options.h>
+
+#include <atomic>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(ThreadPoolTest)
+
+BOOST_AUTO_TEST_CASE(runs_all_tasks)
+{
+	ThreadPool pool(4);
+	atomic<size_t> sum{0};
+	for (size_t i = 1; i <= 100; ++i)
+		pool.enqueue([&sum, i]() { sum += i; });
+	pool.wait();
+	BOOST_CHECK_EQUAL(sum, 5050);
+}
+
+BOOST_AUTO_TEST_CASE(tasks_enqueue_tasks)
+{
+	ThreadPool pool(3);
+	atomic<size_t> count{0};
+	function<void(size_t)> spawn = [&](size_t _depth)
+	{
+		++count;
+		if (_depth > 0)
+			for (size_t i = 0; i < 2; ++i)
+				pool.enqueue([&spawn, _depth]() { spawn(_depth - 1); });
+	};
+	pool.enqueue([&spawn]() { spawn(5); });
+	pool.wait();
+	BOOST_CHECK_EQUAL(count, 63);
+}
+
+BOOST_AUTO_TEST_CASE(rethrows_exception)
+{
+	ThreadPool pool(2);
+	for (size_t i = 0; i < 10; ++i)
+		pool.enqueue([i]()
+		{
+			if (i == 3)
+				BOOST_THROW_EXCEPTION(FileError());
+		});
+	BOOST_CHECK_THROW(pool.wait(), FileError);
+	// The pool remains usable after an exception has been reported.
+	bool ran = false;
+	pool.enqueue([&ran]() { ran = true; });
+	pool.wait();
+	BOOST_CHECK(ran);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for)
+{
+	for (size_t jobs: {1, 2, 7})
+	{
+		vector<size_t> results(50, 0);
+		parallelFor(jobs, results.size(), [&](size_t _i) { results[_i] = _i * _i; });
+		for (size_t i = 0; i < results.size(); ++i)
+			BOOST_CHECK_EQUAL(results[i], i * i);
+	}
+	auto failing = [](size_t _i)
+	{
+		if (_i == 4)
+			BOOST_THROW_EXCEPTION(FileError());
+	};
+	BOOST_CHECK_THROW(parallelFor(3, 5, failing), FileError);
+}
+
+BOOST_AUTO_TEST_CASE(nested_parallel_for)
+{
+	// Tasks wait for nested calls on the same pool without blocking its only worker.
+	ThreadPool pool(1);
+	vector<size_t> results(8, 0);
+	pool.parallelFor(results.size(), [&](size_t _i)
+	{
+		atomic<size_t> sum{0};
+		pool.parallelFor(10, [&](size_t _j) { sum += _j; });
+		results[_i] = sum + _i;
+	});
+	for (size_t i = 0; i < results.size(); ++i)
+		BOOST_CHECK_EQUAL(results[i], 45 + i);
+
+	auto failing = [](size_t _i)
+	{
+		if (_i == 2)
+			BOOST_THROW_EXCEPTION(FileError());
+	};
+	BOOST_CHECK_THROW(pool.parallelFor(5, failing), FileError);
+	// The exception is not reported by wait.
+	pool.wait();
+	atomic<size_t> count{0};
+	pool.parallelFor(3, [&](size_t) { ++count; });
+	BOOST_CHECK_EQUAL(count, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
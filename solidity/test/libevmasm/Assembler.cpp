@@ -148,6 +148,193 @@ BOOST_AUTO_TEST_CASE(all_assembly_items)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(assembly_item_data)
+{
+	u256 const narrow = u256(1) << 63;
+	u256 const wide = u256(1) << 64;
+	vector<AssemblyItem> items{
+		AssemblyItem(Push, 0),
+		AssemblyItem(Push, narrow),
+		AssemblyItem(Push, wide),
+		AssemblyItem(Push, wide + 1),
+		AssemblyItem(Push, ~u256(0))
+	};
+	for (size_t i = 0; i < items.size(); ++i)
+		for (size_t j = 0; j < items.size(); ++j)
+		{
+			BOOST_CHECK_EQUAL(items[i] == items[j], i == j);
+			BOOST_CHECK_EQUAL(items[i] < items[j], i < j);
+			BOOST_CHECK_EQUAL(items[i] == items[j], items[i].data() == items[j].data());
+		}
+	BOOST_CHECK_EQUAL(items[4].data(), ~u256(0));
+	BOOST_CHECK(AssemblyItem(Push, wide + 1) == items[3]);
+	BOOST_CHECK_EQUAL(AssemblyItem(Push, wide + 1).hash(), items[3].hash());
+
+	AssemblyItem item(PushTag, 7);
+	item.setData(wide);
+	BOOST_CHECK_EQUAL(item.data(), wide);
+	item.setData(narrow);
+	BOOST_CHECK_EQUAL(item.data(), narrow);
+	BOOST_CHECK(item == AssemblyItem(PushTag, narrow));
+
+	AssemblyItem subSize(PushSubSize, 0);
+	BOOST_CHECK(!subSize.pushedValue());
+	subSize.setPushedValue(42);
+	BOOST_REQUIRE(subSize.pushedValue());
+	BOOST_CHECK_EQUAL(*subSize.pushedValue(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(wide_data_arena)
+{
+	u256 const wide = u256(1) << 200;
+	// Outside of an assembly, items own a copy of their wide data.
+	AssemblyItem loose(Push, wide);
+	AssemblyItem looseCopy = loose;
+	BOOST_CHECK(looseCopy == loose);
+	BOOST_CHECK_EQUAL(looseCopy.data(), wide);
+	{
+		Assembly assembly;
+		assembly.append(loose);
+		assembly.append(AssemblyItem(Push, wide));
+		assembly.append(Instruction::ADD);
+		// Items of the same assembly share their wide data.
+		BOOST_CHECK(assembly.items()[0] == assembly.items()[1]);
+		BOOST_CHECK(assembly.items()[0] == loose);
+		assembly.optimise(true, EVMVersion(), false, 200);
+		BOOST_CHECK(WideDataArena::current() == nullptr);
+	}
+	BOOST_CHECK_EQUAL(loose.data(), wide);
+
+	WideDataArena arena;
+	{
+		WideDataArena::Scope scope(arena);
+		BOOST_CHECK(WideDataArena::current() == &arena);
+		AssemblyItem a(Push, wide + 1);
+		AssemblyItem b(Push, wide + 1);
+		BOOST_CHECK(a == b);
+		BOOST_CHECK_EQUAL(a.hash(), b.hash());
+		BOOST_CHECK(a != looseCopy);
+	}
+	BOOST_CHECK(WideDataArena::current() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(optimised_sub_assembly_cache)
+{
+	auto source = make_shared<CharStream>("", "child.asm");
+	auto createChild = [&]()
+	{
+		auto runtime = make_shared<Assembly>();
+		runtime->setSourceLocation(SourceLocation(4, 9, source));
+		*runtime << u256(2) << u256(3) << Instruction::ADD << u256(0) << Instruction::SSTORE;
+		*runtime << Instruction::DUP1 << Instruction::POP << Instruction::STOP;
+		auto child = make_shared<Assembly>();
+		child->setSourceLocation(SourceLocation(1, 12, source));
+		*child << u256(0) << Instruction::DUP1 << Instruction::POP << Instruction::POP;
+		child->pushSubroutineSize(size_t(child->appendSubroutine(runtime).data()));
+		*child << Instruction::RETURN;
+		return child;
+	};
+	auto createParent = [&]()
+	{
+		auto parent = make_shared<Assembly>();
+		parent->appendSubroutine(createChild());
+		parent->appendSubroutine(createChild());
+		*parent << Instruction::STOP;
+		return parent;
+	};
+
+	AssemblyPointer uncached = createParent();
+	uncached->optimise(true, EVMVersion(), true, 200);
+
+	OptimisedAssemblyCache cache;
+	AssemblyPointer first = createParent();
+	first->optimise(true, EVMVersion(), true, 200, &cache);
+	// The second child is taken from the cache, which also contains the runtime code.
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 2);
+	AssemblyPointer second = createParent();
+	second->optimise(true, EVMVersion(), true, 200, &cache);
+	BOOST_CHECK_EQUAL(cache.hits(), 3);
+	BOOST_CHECK_EQUAL(cache.misses(), 2);
+
+	for (AssemblyPointer const& assembly: {first, second})
+	{
+		BOOST_CHECK_EQUAL(assembly->assemblyString(), uncached->assemblyString());
+		BOOST_CHECK_EQUAL(assembly->assemble().toHex(), uncached->assemble().toHex());
+	}
+	// Modifying an assembly does not modify the cached sub-assemblies.
+	first->sub(0) << Instruction::INVALID;
+	BOOST_CHECK(first->sub(0).structuralHash() != second->sub(0).structuralHash());
+	BOOST_CHECK_EQUAL(second->sub(1).structuralHash(), second->sub(0).structuralHash());
+
+	// Other settings do not use the same entries.
+	AssemblyPointer runs = createParent();
+	runs->optimise(true, EVMVersion(), true, 1, &cache);
+	BOOST_CHECK_EQUAL(cache.misses(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_cse)
+{
+	auto source = make_shared<CharStream>("", "chunks.asm");
+	auto createAssembly = [&]()
+	{
+		auto assembly = make_shared<Assembly>();
+		assembly->setSourceLocation(SourceLocation(1, 3, source));
+		// Many chunks separated by jump destinations, of which some can be simplified.
+		for (unsigned i = 0; i < 300; ++i)
+		{
+			*assembly << assembly->newTag();
+			*assembly << u256(i) << u256(i % 7) << Instruction::ADD << u256(0) << Instruction::ADD;
+			*assembly << Instruction::DUP1 << u256(i) << Instruction::SSTORE << Instruction::SLOAD;
+			*assembly << Instruction::CALLVALUE << Instruction::MSTORE;
+		}
+		*assembly << Instruction::STOP;
+		return assembly;
+	};
+
+	AssemblyPointer serial = createAssembly();
+	serial->optimise(true, EVMVersion(), true, 200, nullptr, 1);
+	AssemblyPointer parallel = createAssembly();
+	parallel->optimise(true, EVMVersion(), true, 200, nullptr, 4);
+	BOOST_CHECK_LT(serial->items().size(), createAssembly()->items().size());
+	BOOST_CHECK_EQUAL(parallel->assemblyString(), serial->assemblyString());
+	BOOST_CHECK_EQUAL(parallel->assemble().toHex(), serial->assemble().toHex());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_sub_assemblies)
+{
+	auto source = make_shared<CharStream>("", "subs.asm");
+	auto createParent = [&]()
+	{
+		auto parent = make_shared<Assembly>();
+		parent->setSourceLocation(SourceLocation(1, 3, source));
+		for (unsigned i = 0; i < 6; ++i)
+		{
+			// Sub-assemblies with the same value of i % 3 are identical and share a cache entry.
+			auto sub = make_shared<Assembly>();
+			sub->setSourceLocation(SourceLocation(1, 3, source));
+			AssemblyItem tag = sub->newTag();
+			*sub << u256(i % 3) << u256(1) << Instruction::ADD << u256(0) << Instruction::SSTORE;
+			*sub << tag.pushTag() << Instruction::JUMP << tag << Instruction::STOP;
+			parent->pushSubroutineSize(size_t(parent->appendSubroutine(sub).data()));
+			*parent << Instruction::POP;
+		}
+		*parent << Instruction::STOP;
+		return parent;
+	};
+
+	AssemblyPointer serial = createParent();
+	serial->optimise(true, EVMVersion(), true, 200, nullptr, 1);
+	for (size_t jobs: {2, 4, 8})
+	{
+		OptimisedAssemblyCache cache;
+		AssemblyPointer parallel = createParent();
+		parallel->optimise(true, EVMVersion(), true, 200, &cache, jobs);
+		BOOST_CHECK_EQUAL(parallel->assemblyString(), serial->assemblyString());
+		BOOST_CHECK_EQUAL(parallel->assemble().toHex(), serial->assemble().toHex());
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -656,6 +656,25 @@ BOOST_AUTO_TEST_CASE(cse_optimise_return)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(expression_classes_structural_equality)
+{
+	ExpressionClasses classes;
+	ExpressionClasses::Id a = classes.newClass(SourceLocation());
+	ExpressionClasses::Id b = classes.newClass(SourceLocation());
+	BOOST_CHECK(a != b);
+	BOOST_CHECK_EQUAL(classes.find(Instruction::ADD, {a, b}), classes.find(Instruction::ADD, {b, a}));
+	BOOST_CHECK(classes.find(Instruction::SUB, {a, b}) != classes.find(Instruction::SUB, {b, a}));
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(u256(1) << 200)), classes.find(AssemblyItem(u256(1) << 200)));
+	BOOST_CHECK(classes.find(AssemblyItem(u256(1) << 200)) != classes.find(AssemblyItem((u256(1) << 200) + 1)));
+	BOOST_CHECK(classes.find(AssemblyItem(PushTag, 1)) != classes.find(AssemblyItem(u256(1))));
+	// Loads are only equal if they are at the same storage sequence number.
+	ExpressionClasses::Id load = classes.find(Instruction::SLOAD, {a}, true, 1);
+	BOOST_CHECK_EQUAL(load, classes.find(Instruction::SLOAD, {a}, true, 1));
+	BOOST_CHECK(load != classes.find(Instruction::SLOAD, {a}, true, 3));
+	// Non-deterministic operations always create new classes.
+	BOOST_CHECK(classes.find(Instruction::GAS) != classes.find(Instruction::GAS));
+}
+
 BOOST_AUTO_TEST_CASE(control_flow_graph_remove_unused)
 {
 	// remove parts of the code that are unused
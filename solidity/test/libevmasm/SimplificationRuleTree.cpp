@@ -0,0 +1,231 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the decision tree over the patterns of simplification rules.
+ */
+
+#include <libevmasm/SimplificationRuleTree.h>
+#include <libevmasm/SimplificationRules.h>
+#include <libevmasm/ExpressionClasses.h>
+#include <libevmasm/RuleList.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace langutil;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+using Expression = ExpressionClasses::Expression;
+
+/// Describes the expressions of the common subexpression eliminator for the rule decision tree.
+struct RuleTreeAdapter
+{
+	RuleTreeSymbol symbol(Expression const& _expr) const
+	{
+		RuleTreeSymbol symbol;
+		if (!_expr.item)
+			return symbol;
+		symbol.kind = _expr.item->type() == Operation ? RuleTreeSymbol::Kind::Operation : RuleTreeSymbol::Kind::Leaf;
+		symbol.code = _expr.item->type() == Operation ? unsigned(_expr.item->instruction()) : unsigned(_expr.item->type());
+		return symbol;
+	}
+	u256 value(Expression const& _expr) const { return _expr.item->data(); }
+	void pushArguments(Expression const& _expr, vector<Expression const*>& _pending) const
+	{
+		for (auto it = _expr.arguments.rbegin(); it != _expr.arguments.rend(); ++it)
+			_pending.push_back(&classes.representative(*it));
+	}
+
+	ExpressionClasses const& classes;
+};
+
+/// The simplification rules of the optimiser, which can be searched in order or via the tree.
+class RuleSet
+{
+public:
+	RuleSet()
+	{
+		Pattern A(Push);
+		Pattern B(Push);
+		Pattern C(Push);
+		Pattern X;
+		Pattern Y;
+		A.setMatchGroup(1, m_matchGroups);
+		B.setMatchGroup(2, m_matchGroups);
+		C.setMatchGroup(3, m_matchGroups);
+		X.setMatchGroup(4, m_matchGroups);
+		Y.setMatchGroup(5, m_matchGroups);
+		m_rules = simplificationRuleList(A, B, C, X, Y);
+		for (size_t i = 0; i < m_rules.size(); ++i)
+			m_tree.addRule(i, m_rules[i].pattern);
+	}
+
+	/// @returns the index of the first rule that matches @a _expr, found by trying every rule
+	/// in order, or the number of rules if none matches.
+	size_t linearFirstMatch(Expression const& _expr, ExpressionClasses const& _classes)
+	{
+		for (size_t i = 0; i < m_rules.size(); ++i)
+			if (matches(i, _expr, _classes))
+				return i;
+		return m_rules.size();
+	}
+	/// @returns the index of the first rule that matches @a _expr, found by trying the
+	/// candidates of the tree, or the number of rules if none matches.
+	size_t treeFirstMatch(Expression const& _expr, ExpressionClasses const& _classes)
+	{
+		for (size_t i: m_tree.candidates(_expr, RuleTreeAdapter{_classes}))
+			if (matches(i, _expr, _classes))
+				return i;
+		return m_rules.size();
+	}
+
+	vector<SimplificationRule<Pattern>> const& rules() const { return m_rules; }
+
+private:
+	bool matches(size_t _index, Expression const& _expr, ExpressionClasses const& _classes)
+	{
+		m_matchGroups.clear();
+		return m_rules[_index].pattern.matches(_expr, _classes);
+	}
+
+	map<unsigned, Expression const*> m_matchGroups;
+	vector<SimplificationRule<Pattern>> m_rules;
+	SimplificationRuleTree<Pattern> m_tree;
+};
+
+/// @returns the operation @a _item applied to @a _arguments, without simplifying it.
+Expression operation(AssemblyItem const& _item, ExpressionClasses::Ids const& _arguments, ExpressionClasses const& _classes)
+{
+	Expression expression;
+	expression.id = _classes.size();
+	expression.item = &_item;
+	expression.arguments = _arguments;
+	return expression;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(SimplificationRuleTreeTest)
+
+BOOST_AUTO_TEST_CASE(wildcards_and_constants)
+{
+	Pattern X;
+	Pattern Y;
+	vector<Pattern> patterns{
+		Pattern(Instruction::ADD, {X, u256(0)}),
+		Pattern(Instruction::ADD, {Pattern(Push), Pattern(Push)}),
+		Pattern(Instruction::ADD, {X, Y}),
+		Pattern(Instruction::AND, {X, u256(0xff)}),
+		// Operations without argument patterns match any arguments.
+		Pattern(Instruction::AND)
+	};
+	SimplificationRuleTree<Pattern> tree;
+	for (size_t i = 0; i < patterns.size(); ++i)
+		tree.addRule(i, patterns[i]);
+
+	ExpressionClasses classes;
+	ExpressionClasses::Id x = classes.newClass(SourceLocation());
+	ExpressionClasses::Id zero = classes.find(AssemblyItem(u256(0)));
+	ExpressionClasses::Id one = classes.find(AssemblyItem(u256(1)));
+	ExpressionClasses::Id mask = classes.find(AssemblyItem(u256(0xff)));
+	AssemblyItem add(Instruction::ADD);
+	AssemblyItem bitAnd(Instruction::AND);
+	AssemblyItem mul(Instruction::MUL);
+	RuleTreeAdapter adapter{classes};
+	auto candidates = [&](AssemblyItem const& _item, ExpressionClasses::Ids const& _arguments)
+	{
+		return tree.candidates(operation(_item, _arguments, classes), adapter);
+	};
+
+	BOOST_CHECK((candidates(add, {x, zero}) == vector<size_t>{0, 2}));
+	BOOST_CHECK((candidates(add, {one, zero}) == vector<size_t>{0, 1, 2}));
+	BOOST_CHECK((candidates(add, {one, one}) == vector<size_t>{1, 2}));
+	BOOST_CHECK((candidates(add, {x, x}) == vector<size_t>{2}));
+	BOOST_CHECK((candidates(bitAnd, {x, mask}) == vector<size_t>{3, 4}));
+	BOOST_CHECK((candidates(bitAnd, {x, one}) == vector<size_t>{4}));
+	BOOST_CHECK(candidates(mul, {x, zero}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(same_first_match_as_linear_scan)
+{
+	RuleSet ruleSet;
+	ExpressionClasses classes;
+	ExpressionClasses::Id x = classes.newClass(SourceLocation());
+	ExpressionClasses::Id y = classes.newClass(SourceLocation());
+	// Constants that occur in the rules and others, unknown values and operations that occur in
+	// nested patterns.
+	ExpressionClasses::Ids arguments{x, y};
+	for (u256 const& value: {
+		u256(0), u256(1), u256(2), u256(31), u256(32), u256(0xff),
+		(u256(1) << 160) - 1, u256(1) << 255, ~u256(0)
+	})
+		arguments.push_back(classes.find(AssemblyItem(value)));
+	arguments.push_back(classes.find(Instruction::NOT, {x}));
+	arguments.push_back(classes.find(Instruction::ISZERO, {x}));
+	arguments.push_back(classes.find(Instruction::AND, {x, y}));
+	arguments.push_back(classes.find(Instruction::ADD, {x, arguments[3]}));
+
+	set<Instruction> operations;
+	for (auto const& rule: ruleSet.rules())
+		operations.insert(rule.pattern.instruction());
+
+	size_t matched = 0;
+	for (Instruction instruction: operations)
+	{
+		AssemblyItem item(instruction);
+		// Every combination of the arguments above.
+		vector<size_t> choice(instructionInfo(instruction).args, 0);
+		while (true)
+		{
+			ExpressionClasses::Ids operationArguments;
+			for (size_t index: choice)
+				operationArguments.push_back(arguments[index]);
+			Expression expression = operation(item, operationArguments, classes);
+			size_t expected = ruleSet.linearFirstMatch(expression, classes);
+			BOOST_REQUIRE_EQUAL(ruleSet.treeFirstMatch(expression, classes), expected);
+			if (expected < ruleSet.rules().size())
+				matched++;
+
+			size_t position = 0;
+			while (position < choice.size() && ++choice[position] == arguments.size())
+				choice[position++] = 0;
+			if (position == choice.size())
+				break;
+		}
+	}
+	// Make sure that the expressions exercise a good part of the rules.
+	BOOST_CHECK_GT(matched, 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
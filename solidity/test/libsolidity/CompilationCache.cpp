@@ -0,0 +1,112 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the persistent compilation cache.
+ */
+
+#include <libsolidity/interface/CompilationCache.h>
+
+#include <test/Options.h>
+#include <test/TemporaryDirectory.h>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+using namespace std;
+using dev::test::TemporaryDirectory;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(CompilationCacheTest)
+
+BOOST_AUTO_TEST_CASE(store_and_lookup)
+{
+	TemporaryDirectory directory("solidity-cache");
+	CompilationCache cache(directory.path(), 1024 * 1024);
+	BOOST_CHECK(!cache.lookup("input", ReadCallback::Callback()));
+	cache.store("input", {}, "output");
+	BOOST_CHECK(!cache.lookup("other input", ReadCallback::Callback()));
+	BOOST_REQUIRE(cache.lookup("input", ReadCallback::Callback()));
+	BOOST_CHECK_EQUAL(*cache.lookup("input", ReadCallback::Callback()), "output");
+
+	// Results are persistent.
+	CompilationCache reopened(directory.path(), 1024 * 1024);
+	BOOST_REQUIRE(reopened.lookup("input", ReadCallback::Callback()));
+	BOOST_CHECK_EQUAL(*reopened.lookup("input", ReadCallback::Callback()), "output");
+
+	BOOST_CHECK_EQUAL(cache.statistics().hits, 2);
+	BOOST_CHECK_EQUAL(cache.statistics().misses, 2);
+	BOOST_CHECK_EQUAL(cache.statistics().stores, 1);
+	CompilationCache::Statistics total = reopened.totalStatistics();
+	BOOST_CHECK_EQUAL(total.hits, 4);
+	BOOST_CHECK_EQUAL(total.misses, 2);
+	BOOST_CHECK_EQUAL(total.stores, 1);
+	BOOST_CHECK_EQUAL(total.evictions, 0);
+}
+
+BOOST_AUTO_TEST_CASE(imported_files)
+{
+	TemporaryDirectory directory("solidity-cache");
+	CompilationCache cache(directory.path(), 1024 * 1024);
+	map<string, string> files{{"lib.sol", "contract L {}"}};
+	ReadCallback::Callback readFile = [&](string const& _path)
+	{
+		if (files.count(_path))
+			return ReadCallback::Result{true, files[_path]};
+		return ReadCallback::Result{false, "File not found."};
+	};
+	cache.store("input", files, "output");
+	BOOST_CHECK(cache.lookup("input", readFile));
+	BOOST_CHECK(!cache.lookup("input", ReadCallback::Callback()));
+
+	files["lib.sol"] = "contract L { uint x; }";
+	BOOST_CHECK(!cache.lookup("input", readFile));
+	files.erase("lib.sol");
+	BOOST_CHECK(!cache.lookup("input", readFile));
+}
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+	TemporaryDirectory directory("solidity-cache");
+	CompilationCache cache(directory.path(), 2500);
+	string const output(1000, 'x');
+	cache.store("a", {}, output);
+	cache.store("b", {}, output);
+	BOOST_CHECK(cache.lookup("a", ReadCallback::Callback()));
+	BOOST_CHECK(cache.lookup("b", ReadCallback::Callback()));
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 0);
+
+	cache.store("c", {}, output);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 1);
+	BOOST_CHECK(cache.lookup("c", ReadCallback::Callback()));
+	BOOST_CHECK_EQUAL(
+		int(bool(cache.lookup("a", ReadCallback::Callback()))) + int(bool(cache.lookup("b", ReadCallback::Callback()))),
+		1
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
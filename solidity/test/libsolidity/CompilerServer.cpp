@@ -0,0 +1,225 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the compiler server.
+ */
+
+#include <libsolidity/interface/CompilerServer.h>
+
+#include <libdevcore/JSON.h>
+
+#include <test/Options.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+string request(string const& _project, string const& _id, string const& _sourceA, string const& _sourceB)
+{
+	return R"({
+		"id": )" + _id + R"(,
+		"project": ")" + _project + R"(",
+		"input": {
+			"language": "Solidity",
+			"sources": {
+				"a.sol": { "content": ")" + _sourceA + R"(" },
+				"b.sol": { "content": ")" + _sourceB + R"(" }
+			},
+			"settings": {
+				"profiling": true,
+				"outputSelection": { "*": { "*": [ "evm.bytecode.object" ] } }
+			}
+		}
+	})";
+}
+
+Json::Value parse(string const& _json)
+{
+	Json::Value value;
+	BOOST_REQUIRE(jsonParseStrict(_json, value));
+	return value;
+}
+
+/// @returns the fully qualified names of the contracts compiled for the response @a _response.
+vector<string> compiledContracts(Json::Value const& _response)
+{
+	return _response["output"]["profiling"]["contracts"].getMemberNames();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(CompilerServerTest)
+
+BOOST_AUTO_TEST_CASE(framing)
+{
+	stringstream stream;
+	CompilerServer::writeFrame(stream, "{}");
+	CompilerServer::writeFrame(stream, "first\r\nsecond");
+	stream << "\r\ncontent-length:  3\nContent-Type: application/json\n\nabc";
+	BOOST_CHECK_EQUAL(*CompilerServer::readFrame(stream), "{}");
+	BOOST_CHECK_EQUAL(*CompilerServer::readFrame(stream), "first\r\nsecond");
+	BOOST_CHECK_EQUAL(*CompilerServer::readFrame(stream), "abc");
+	BOOST_CHECK(!CompilerServer::readFrame(stream));
+
+	for (char const* malformed: {
+		"Content-Length: 10\r\n\r\nshort",
+		"Content-Length: x\r\n\r\n",
+		"Content-Type: application/json\r\n\r\n{}",
+		"Content-Length 2\r\n\r\n{}",
+		"Content-Length: 2\r\n"
+	})
+	{
+		stringstream input(malformed);
+		BOOST_CHECK_THROW(CompilerServer::readFrame(input), InvalidFrame);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(invalid_requests)
+{
+	CompilerServer server(ReadCallback::Callback(), 1);
+	auto error = [&](string const& _request)
+	{
+		Json::Value response = parse(server.handle(_request));
+		BOOST_REQUIRE(response["output"]["errors"].isArray());
+		return response["output"]["errors"][0]["message"].asString();
+	};
+	BOOST_CHECK(!error("{").empty());
+	BOOST_CHECK_EQUAL(error("[]"), "The request must be an object.");
+	BOOST_CHECK_EQUAL(error(R"({ "input": 1 })"), "\"input\" must be an object containing the Standard JSON input.");
+	BOOST_CHECK_EQUAL(error(R"({ "input": {}, "project": 1 })"), "\"project\" must be a string.");
+
+	Json::Value response = parse(server.handle(R"({ "id": "x", "input": { "language": "Solidity" } })"));
+	BOOST_CHECK_EQUAL(response["id"].asString(), "x");
+	BOOST_CHECK_EQUAL(response["output"]["errors"][0]["message"].asString(), "No input sources specified.");
+	BOOST_CHECK_EQUAL(server.projectCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(warm_state)
+{
+	CompilerServer server(ReadCallback::Callback(), 1);
+	string const sourceA = "contract A { function f() public pure returns (uint) { return 1; } }";
+	string const sourceB = "import \\\"a.sol\\\"; contract B { function g() public returns (address) { return address(new A()); } }";
+	string const changedB = "import \\\"a.sol\\\"; contract B { function g() public returns (address) { return address(0); } }";
+
+	Json::Value cold = parse(server.handle(request("p", "1", sourceA, sourceB)));
+	BOOST_CHECK_EQUAL(cold["id"].asInt(), 1);
+	BOOST_CHECK(compiledContracts(cold) == vector<string>({ "a.sol:A", "b.sol:B" }));
+
+	// Unchanged contracts of the project are not compiled again.
+	Json::Value warm = parse(server.handle(request("p", "2", sourceA, sourceB)));
+	BOOST_CHECK(compiledContracts(warm).empty());
+	BOOST_CHECK_EQUAL(jsonCompactPrint(warm["output"]["contracts"]), jsonCompactPrint(cold["output"]["contracts"]));
+
+	warm = parse(server.handle(request("p", "3", sourceA, changedB)));
+	BOOST_CHECK(compiledContracts(warm) == vector<string>({ "b.sol:B" }));
+	BOOST_CHECK_EQUAL(
+		warm["output"]["contracts"]["a.sol"]["A"]["evm"]["bytecode"]["object"].asString(),
+		cold["output"]["contracts"]["a.sol"]["A"]["evm"]["bytecode"]["object"].asString()
+	);
+
+	// Other projects and requests without project start from scratch.
+	Json::Value other = parse(server.handle(request("q", "4", sourceA, sourceB)));
+	BOOST_CHECK(compiledContracts(other) == vector<string>({ "a.sol:A", "b.sol:B" }));
+	other = parse(server.handle(request("", "5", sourceA, sourceB)));
+	BOOST_CHECK(compiledContracts(other) == vector<string>({ "a.sol:A", "b.sol:B" }));
+	BOOST_CHECK_EQUAL(server.projectCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(serve)
+{
+	CompilerServer server(ReadCallback::Callback(), 4);
+	string const source = "contract C { function f() public pure {} }";
+	stringstream input;
+	for (size_t i = 0; i < 8; ++i)
+		CompilerServer::writeFrame(input, request("p" + to_string(i % 3), to_string(i), source, source));
+	stringstream output;
+	BOOST_CHECK(server.serve(input, output));
+
+	set<int> ids;
+	while (boost::optional<string> response = CompilerServer::readFrame(output))
+	{
+		Json::Value value = parse(*response);
+		BOOST_CHECK(value["output"]["contracts"]["a.sol"]["C"]["evm"]["bytecode"]["object"].isString());
+		ids.insert(value["id"].asInt());
+	}
+	BOOST_CHECK_EQUAL(ids.size(), 8);
+	BOOST_CHECK_EQUAL(server.projectCount(), 3);
+
+	stringstream malformed("Content-Length: 5\r\n\r\n{}");
+	BOOST_CHECK(!server.serve(malformed, output));
+}
+
+BOOST_AUTO_TEST_CASE(project_limit)
+{
+	CompilerServer server(ReadCallback::Callback(), 1, 2);
+	string const source = "contract C { function f() public pure {} }";
+	server.handle(request("p", "1", source, source));
+	server.handle(request("q", "2", source, source));
+	server.handle(request("p", "3", source, source));
+	// Drops "q", which was used least recently.
+	server.handle(request("r", "4", source, source));
+	BOOST_CHECK_EQUAL(server.projectCount(), 2);
+	BOOST_CHECK(compiledContracts(parse(server.handle(request("p", "5", source, source)))).empty());
+	BOOST_CHECK_EQUAL(compiledContracts(parse(server.handle(request("q", "6", source, source)))).size(), 2);
+	BOOST_CHECK_EQUAL(server.projectCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_projects)
+{
+	CompilerServer server(ReadCallback::Callback(), 4);
+	string const source = R"(
+		"sources": { "a.sol": { "content": "contract C { function f() public pure returns (uint x) { assembly { x := 7 } } }" } },
+		"settings": { "outputSelection": { "*": { "": [ "ast" ], "*": [ "evm.bytecode.object" ] } } }
+	)";
+	stringstream input;
+	for (size_t i = 0; i < 8; ++i)
+		CompilerServer::writeFrame(input, R"({ "id": )" + to_string(i) + R"(, "project": "p)" + to_string(i) + R"(",
+			"input": { "language": "Solidity", )" + source + R"( } })");
+	stringstream output;
+	BOOST_CHECK(server.serve(input, output));
+
+	// Compilations running at the same time assign the same AST node IDs.
+	set<string> outputs;
+	size_t responses = 0;
+	while (boost::optional<string> response = CompilerServer::readFrame(output))
+	{
+		Json::Value value = parse(*response);
+		BOOST_REQUIRE(value["output"]["sources"]["a.sol"]["ast"].isObject());
+		outputs.insert(jsonCompactPrint(value["output"]["sources"]) + jsonCompactPrint(value["output"]["contracts"]));
+		++responses;
+	}
+	BOOST_CHECK_EQUAL(responses, 8);
+	BOOST_CHECK_EQUAL(outputs.size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -0,0 +1,165 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the reuse of compilation results in incremental mode.
+ */
+
+#include <test/Options.h>
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <string>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+string const sourceA = R"(
+	pragma solidity >=0.0;
+	import "b";
+	contract A { function f() public returns (address) { return address(new B()); } }
+)";
+string const sourceB = R"(
+	pragma solidity >=0.0;
+	contract B { function g(uint x) public pure returns (uint) { return x * 7; } }
+)";
+string const sourceC = R"(
+	pragma solidity >=0.0;
+	contract C { uint x = 2; function h() internal view returns (uint) { return x; } function i() public view returns (uint) { return h(); } }
+)";
+
+void addSources(CompilerStack& _compiler, string const& _sourceB, string const& _sourceC)
+{
+	_compiler.addSource("a", sourceA);
+	_compiler.addSource("b", _sourceB);
+	_compiler.addSource("c", _sourceC);
+	_compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	_compiler.setOptimiserSettings(true);
+}
+
+/// Checks that all outputs of @a _compiler match those of a compilation from scratch.
+void checkOutputsMatchFreshCompilation(CompilerStack const& _compiler, string const& _sourceB, string const& _sourceC)
+{
+	CompilerStack fresh;
+	addSources(fresh, _sourceB, _sourceC);
+	BOOST_REQUIRE(fresh.compile());
+	for (string const& name: fresh.contractNames())
+	{
+		BOOST_CHECK(_compiler.object(name).bytecode == fresh.object(name).bytecode);
+		BOOST_CHECK(_compiler.runtimeObject(name).bytecode == fresh.runtimeObject(name).bytecode);
+		BOOST_CHECK_EQUAL(_compiler.metadata(name), fresh.metadata(name));
+		BOOST_CHECK_EQUAL(_compiler.assemblyString(name), fresh.assemblyString(name));
+		BOOST_CHECK_EQUAL(*_compiler.sourceMapping(name), *fresh.sourceMapping(name));
+		BOOST_CHECK_EQUAL(_compiler.gasEstimates(name), fresh.gasEstimates(name));
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(IncrementalCompilation)
+
+BOOST_AUTO_TEST_CASE(disabled_by_default)
+{
+	CompilerStack compiler;
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.reusedContracts().empty());
+}
+
+BOOST_AUTO_TEST_CASE(reuse_unchanged_contracts)
+{
+	CompilerStack compiler;
+	compiler.setIncrementalCompilation(true);
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.reusedContracts().empty());
+
+	// Unchanged sources.
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK((compiler.reusedContracts() == set<string>{"a:A", "b:B", "c:C"}));
+	checkOutputsMatchFreshCompilation(compiler, sourceB, sourceC);
+
+	// Only C is affected by a change of its source.
+	string const changedC = sourceC + "contract D {}";
+	addSources(compiler, sourceB, changedC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK((compiler.reusedContracts() == set<string>{"a:A", "b:B"}));
+	checkOutputsMatchFreshCompilation(compiler, sourceB, changedC);
+
+	// A imports B, so both are affected by a change of B's source.
+	string const changedB = sourceB + "contract E {}";
+	addSources(compiler, changedB, changedC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK((compiler.reusedContracts() == set<string>{"c:C", "c:D"}));
+	checkOutputsMatchFreshCompilation(compiler, changedB, changedC);
+}
+
+BOOST_AUTO_TEST_CASE(settings_invalidate_results)
+{
+	CompilerStack compiler;
+	compiler.setIncrementalCompilation(true);
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+
+	addSources(compiler, sourceB, sourceC);
+	compiler.setOptimiserSettings(false);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.reusedContracts().empty());
+
+	// Only the results of the last compilation are retained.
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.reusedContracts().empty());
+
+	compiler.setIncrementalCompilation(false);
+	compiler.setIncrementalCompilation(true);
+	addSources(compiler, sourceB, sourceC);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.reusedContracts().empty());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_compilation)
+{
+	CompilerStack compiler;
+	compiler.setIncrementalCompilation(true);
+	addSources(compiler, sourceB, sourceC);
+	compiler.setParallelism(4);
+	BOOST_REQUIRE(compiler.compile());
+
+	string const changedC = sourceC + "contract D {}";
+	addSources(compiler, sourceB, changedC);
+	compiler.setParallelism(4);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK((compiler.reusedContracts() == set<string>{"a:A", "b:B"}));
+	checkOutputsMatchFreshCompilation(compiler, sourceB, changedC);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -1990,12 +1990,32 @@ BOOST_AUTO_TEST_CASE(blockchain)
 			}
 		}
 	)";
-	BOOST_CHECK(m_rpc.rpcCall("miner_setEtherbase", {"\"0x1212121212121212121212121212121212121212\""}).asBool() == true);
-	m_rpc.test_mineBlocks(5);
+	setCoinbase(Address("0x1212121212121212121212121212121212121212"));
+	mineBlocks(5);
 	compileAndRun(sourceCode, 27);
 	ABI_CHECK(callContractFunctionWithValue("someInfo()", 28), encodeArgs(28, u256("0x1212121212121212121212121212121212121212"), 7));
 }
 
+BOOST_AUTO_TEST_CASE(block_ethash)
+{
+	// External nodes do not implement the ETHASH instruction.
+	if (!dev::test::Options::get().useEVMInterpreter)
+		return;
+	char const* sourceCode = R"(
+		contract test {
+			function verify(uint number, bytes32 header, bytes32 mix, uint nonce, uint difficulty) public view returns (bool) {
+				return block.ethash(number, header, mix, nonce, difficulty);
+			}
+		}
+	)";
+	compileAndRun(sourceCode);
+	h256 header = keccak256("header");
+	h256 mix = ethashVerifier().lightCache(0)->hashimoto(header, 7).mixHash;
+	ABI_CHECK(callContractFunction("verify(uint256,bytes32,bytes32,uint256,uint256)", 1, header, mix, 7, 1), encodeArgs(true));
+	ABI_CHECK(callContractFunction("verify(uint256,bytes32,bytes32,uint256,uint256)", 1, header, mix, 8, 1), encodeArgs(false));
+	ABI_CHECK(callContractFunction("verify(uint256,bytes32,bytes32,uint256,uint256)", 1, header, mix, 7, u256(-1)), encodeArgs(false));
+}
+
 BOOST_AUTO_TEST_CASE(msg_sig)
 {
 	char const* sourceCode = R"(
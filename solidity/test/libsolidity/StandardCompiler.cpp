@@ -860,6 +860,201 @@ BOOST_AUTO_TEST_CASE(evm_version)
 	BOOST_CHECK(result["errors"][0]["message"].asString() == "Invalid EVM version requested.");
 }
 
+BOOST_AUTO_TEST_CASE(parallelism)
+{
+	auto inputForParallelism = [](string const& _parallelism)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "import \"fileB\"; contract A { function f() public returns (address) { return address(new B()); } }" },
+					"fileB": { "content": "import \"fileC\"; contract B { C c = new C(); function g() public returns (uint) { return 7; } }" },
+					"fileC": { "content": "contract C { uint x = 2; } contract D { function h(uint a) public pure returns (uint) { return a * 3; } }" }
+				},
+				"settings": {
+					)" + _parallelism + R"(
+					"optimizer": { "enabled": true },
+					"outputSelection": {
+						"*": {
+							"*": [ "evm.bytecode", "evm.deployedBytecode", "evm.assembly" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	Json::Value sequential = compile(inputForParallelism(""));
+	BOOST_CHECK(containsAtMostWarnings(sequential));
+	for (unsigned parallelism: { 1, 2, 8 })
+	{
+		Json::Value parallel = compile(inputForParallelism("\"parallelism\": " + to_string(parallelism) + ","));
+		BOOST_CHECK(containsAtMostWarnings(parallel));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(parallel), jsonCompactPrint(sequential));
+	}
+	Json::Value result = compile(inputForParallelism("\"parallelism\": 0,"));
+	BOOST_CHECK(containsError(result, "JSONError", "The \"parallelism\" setting must be a positive unsigned number."));
+	result = compile(inputForParallelism("\"parallelism\": \"2\","));
+	BOOST_CHECK(containsError(result, "JSONError", "The \"parallelism\" setting must be a positive unsigned number."));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_analysis)
+{
+	auto inputForParallelism = [](string const& _parallelism, string const& _sourceC)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "contract A { function f() public pure { uint a; } }" },
+					"fileB": { "content": "pragma solidity >=0.0; contract B { function g() public pure { uint b; } }" },
+					"fileC": { "content": ")" + _sourceC + R"(" },
+					"fileD": { "content": "contract D { function i() public pure { uint d; } }" }
+				},
+				"settings": {
+					)" + _parallelism + R"(
+					"outputSelection": {
+						"*": {
+							"*": [ "evm.bytecode" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	string const validC = "pragma solidity >=0.0; contract C { function h() public pure returns (uint c) { uint x; c = 1; } }";
+	string const invalidC = "pragma solidity >=0.0; contract C { struct S { uint x; } S s; function h() internal view returns (S storage c) { if (s.x > 0) c = s; } }";
+
+	// Warnings of the syntax checker and the static analyzer.
+	Json::Value sequential = compile(inputForParallelism("", validC));
+	BOOST_CHECK(containsAtMostWarnings(sequential));
+	BOOST_CHECK_EQUAL(sequential["errors"].size(), 6);
+	for (unsigned parallelism: { 2, 8 })
+	{
+		Json::Value parallel = compile(inputForParallelism("\"parallelism\": " + to_string(parallelism) + ",", validC));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(parallel["errors"]), jsonCompactPrint(sequential["errors"]));
+	}
+
+	// Error of the control flow analyzer, which stops the analysis before the static analyzer.
+	sequential = compile(inputForParallelism("", invalidC));
+	BOOST_CHECK(containsError(sequential, "TypeError", "This variable is of storage pointer type and might be returned without assignment and could be used uninitialized. Assign the variable (potentially from itself) to fix this error."));
+	BOOST_CHECK_EQUAL(sequential["errors"].size(), 3);
+	for (unsigned parallelism: { 2, 8 })
+	{
+		Json::Value parallel = compile(inputForParallelism("\"parallelism\": " + to_string(parallelism) + ",", invalidC));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(parallel["errors"]), jsonCompactPrint(sequential["errors"]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(profiling)
+{
+	auto inputForProfiling = [](string const& _profiling)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "contract A { function f(uint a) public pure returns (uint) { return a * 2; } } contract B { function g() public returns (address) { return address(new A()); } }" }
+				},
+				"settings": {
+					)" + _profiling + R"(
+					"optimizer": { "enabled": true },
+					"parallelism": 2,
+					"outputSelection": {
+						"*": {
+							"*": [ "evm.bytecode" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	Json::Value result = compile(inputForProfiling("\"profiling\": true,"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_REQUIRE(result["profiling"].isObject());
+	Json::Value const& phases = result["profiling"]["phases"];
+	for (string const& phase: { "parsing", "analysis", "analysis/SyntaxChecker", "analysis/TypeChecker" })
+	{
+		BOOST_REQUIRE(phases[phase].isObject());
+		BOOST_CHECK_EQUAL(phases[phase]["calls"].asUInt(), 1);
+		BOOST_CHECK(phases[phase]["time"].asDouble() >= 0);
+	}
+	for (string const& contract: { "fileA:A", "fileA:B" })
+	{
+		Json::Value const& contractPhases = result["profiling"]["contracts"][contract];
+		for (string const& phase: { "codegen", "codegen/ContractCompiler", "optimiser", "optimiser/PeepholeOptimiser", "assembler" })
+			BOOST_CHECK_MESSAGE(contractPhases[phase].isObject(), contract + " " + phase);
+		// One call per returned expression.
+		BOOST_CHECK_EQUAL(contractPhases["codegen/ContractCompiler/ExpressionCompiler"]["calls"].asUInt(), 1);
+	}
+
+	result = compile(inputForProfiling(""));
+	BOOST_CHECK(!result.isMember("profiling"));
+	result = compile(inputForProfiling("\"profiling\": false,"));
+	BOOST_CHECK(!result.isMember("profiling"));
+	result = compile(inputForProfiling("\"profiling\": 1,"));
+	BOOST_CHECK(containsError(result, "JSONError", "The \"profiling\" setting must be a boolean."));
+}
+
+BOOST_AUTO_TEST_CASE(output_selection_driven_compilation)
+{
+	auto inputForSelection = [](string const& _selection)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "contract A { function f() public pure returns (uint) { return 1; } } contract B { function g() public returns (address) { return address(new A()); } } contract C { function h() public pure {} }" }
+				},
+				"settings": {
+					"profiling": true,
+					"outputSelection": {
+						"fileA": )" + _selection + R"(
+					}
+				}
+			}
+		)";
+	};
+	auto compiledContracts = [](Json::Value const& _result)
+	{
+		return _result["profiling"]["contracts"].getMemberNames();
+	};
+
+	Json::Value full = compile(inputForSelection(R"({ "*": [ "*" ] })"));
+	BOOST_CHECK(containsAtMostWarnings(full));
+	BOOST_CHECK_EQUAL(compiledContracts(full).size(), 3);
+
+	// Outputs of the analysis do not generate code.
+	Json::Value result = compile(inputForSelection(R"({ "*": [ "abi", "metadata", "devdoc", "userdoc", "evm.methodIdentifiers" ] })"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(compiledContracts(result).empty());
+	for (string const& name: { "A", "B", "C" })
+	{
+		Json::Value const& contract = result["contracts"]["fileA"][name];
+		Json::Value const& expectation = full["contracts"]["fileA"][name];
+		BOOST_CHECK_EQUAL(contract["metadata"].asString(), expectation["metadata"].asString());
+		BOOST_CHECK_EQUAL(jsonCompactPrint(contract["abi"]), jsonCompactPrint(expectation["abi"]));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(contract["evm"]["methodIdentifiers"]), jsonCompactPrint(expectation["evm"]["methodIdentifiers"]));
+		BOOST_CHECK(!contract["evm"].isMember("bytecode"));
+	}
+
+	// Only the requested contract and the contracts it creates are compiled, and only the requested parts are output.
+	result = compile(inputForSelection(R"({ "B": [ "evm.bytecode.object" ] })"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(compiledContracts(result) == vector<string>({ "fileA:A", "fileA:B" }));
+	Json::Value const& bytecode = result["contracts"]["fileA"]["B"]["evm"]["bytecode"];
+	BOOST_CHECK_EQUAL(bytecode.getMemberNames().size(), 1);
+	BOOST_CHECK_EQUAL(bytecode["object"].asString(), full["contracts"]["fileA"]["B"]["evm"]["bytecode"]["object"].asString());
+	BOOST_CHECK(!result["contracts"]["fileA"]["B"]["evm"].isMember("deployedBytecode"));
+
+	// Selecting an output selects all its parts.
+	result = compile(inputForSelection(R"({ "C": [ "evm" ] })"));
+	BOOST_CHECK(compiledContracts(result) == vector<string>({ "fileA:C" }));
+	BOOST_CHECK_EQUAL(
+		jsonCompactPrint(result["contracts"]["fileA"]["C"]["evm"]),
+		jsonCompactPrint(full["contracts"]["fileA"]["C"]["evm"])
+	);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
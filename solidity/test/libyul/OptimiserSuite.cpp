@@ -0,0 +1,106 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the selection of steps of the Yul optimiser suite.
+ */
+
+#include <test/libyul/Common.h>
+
+#include <libyul/optimiser/Suite.h>
+#include <libyul/AsmAnalysisInfo.h>
+#include <libyul/AsmPrinter.h>
+#include <libyul/Exceptions.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace yul;
+using namespace yul::test;
+
+namespace
+{
+
+string optimise(string const& _source, vector<string> const& _steps, bool _perFunction = false, size_t _jobs = 1)
+{
+	auto result = parse(_source, false);
+	OptimiserSuite::run(*result.first, *result.second, {}, _steps, _perFunction, _jobs);
+	return AsmPrinter{}(*result.first);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(YulOptimiserSuite)
+
+BOOST_AUTO_TEST_CASE(step_names)
+{
+	for (string const& step: OptimiserSuite::defaultSteps())
+		BOOST_CHECK(OptimiserSuite::isStep(step));
+	BOOST_CHECK(!OptimiserSuite::isStep("Disambiguator"));
+	BOOST_CHECK(!OptimiserSuite::isStep(""));
+	BOOST_CHECK_THROW(optimise("{ }", {"NoSuchStep"}), YulException);
+}
+
+BOOST_AUTO_TEST_CASE(custom_steps)
+{
+	string source = "{ let a := add(1, 2) sstore(0, a) }";
+	BOOST_CHECK_EQUAL(optimise(source, {}), "{\n    {\n        sstore(0, add(1, 2))\n    }\n}");
+	BOOST_CHECK_EQUAL(optimise(source, {"ExpressionSplitter", "ExpressionSimplifier"}), "{\n    {\n        sstore(0, 3)\n    }\n}");
+}
+
+BOOST_AUTO_TEST_CASE(default_steps)
+{
+	string source = "{ let a := calldataload(0) let b := mul(a, 1) sstore(b, sub(a, a)) }";
+	BOOST_CHECK_EQUAL(
+		optimise(source, OptimiserSuite::defaultSteps()),
+		"{\n    {\n        let _1 := 0\n        sstore(calldataload(_1), _1)\n    }\n}"
+	);
+}
+
+BOOST_AUTO_TEST_CASE(per_function)
+{
+	string source = R"({
+		function f(a) -> r { let x := mul(a, 1) r := add(x, sub(a, a)) }
+		function g(a, b) -> r { r := f(add(a, b)) if calldataload(a) { r := f(r) } }
+		function h(a) { sstore(a, mul(calldataload(a), 2)) sstore(add(a, 1), mul(calldataload(a), 2)) }
+		let x := g(calldataload(0), 7)
+		h(x)
+		sstore(f(x), x)
+	})";
+	string sequential = optimise(source, OptimiserSuite::defaultSteps(), true, 1);
+	BOOST_CHECK_EQUAL(optimise(source, OptimiserSuite::defaultSteps(), true, 4), sequential);
+	BOOST_CHECK_EQUAL(
+		sequential,
+		"{\n"
+		"    {\n"
+		"        let _10 := 7\n"
+		"        let _22 := calldataload(0)\n"
+		"        let g_r_1_3 := add(_22, _10)\n"
+		"        let g_r_1 := g_r_1_3\n"
+		"        if calldataload(_22)\n"
+		"        {\n"
+		"            g_r_1 := g_r_1_3\n"
+		"        }\n"
+		"        let h__12 := mul(calldataload(g_r_1), 2)\n"
+		"        sstore(g_r_1, h__12)\n"
+		"        sstore(add(g_r_1, 1), h__12)\n"
+		"        sstore(g_r_1, g_r_1)\n"
+		"    }\n"
+		"}"
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the Yul string repository.
+ */
+
+#include <libyul/YulString.h>
+
+#include <libdevcore/ThreadPool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace yul
+{
+namespace test
+{
+
+namespace
+{
+/// The repository is too large for the stack of some platforms.
+unique_ptr<YulStringRepository> newRepository()
+{
+	return unique_ptr<YulStringRepository>(new YulStringRepository());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(YulStringTest)
+
+BOOST_AUTO_TEST_CASE(empty_string)
+{
+	auto repositoryPtr = newRepository();
+	YulStringRepository& repository = *repositoryPtr;
+	YulStringRepository::Handle handle = repository.stringToHandle("");
+	BOOST_CHECK_EQUAL(handle.id, 0);
+	BOOST_CHECK_EQUAL(handle.hash, YulStringRepository::emptyHash());
+	BOOST_CHECK_EQUAL(repository.idToString(0), "");
+	BOOST_CHECK(YulString().empty());
+	BOOST_CHECK(YulString("") == YulString());
+}
+
+BOOST_AUTO_TEST_CASE(same_string_same_id)
+{
+	auto repositoryPtr = newRepository();
+	YulStringRepository& repository = *repositoryPtr;
+	YulStringRepository::Handle a = repository.stringToHandle("abc");
+	YulStringRepository::Handle b = repository.stringToHandle("abcd");
+	BOOST_CHECK(a.id != b.id);
+	BOOST_CHECK_EQUAL(repository.stringToHandle(string("ab") + "c").id, a.id);
+	BOOST_CHECK_EQUAL(repository.idToString(a.id), "abc");
+	BOOST_CHECK_EQUAL(repository.idToString(b.id), "abcd");
+}
+
+BOOST_AUTO_TEST_CASE(contains_does_not_intern)
+{
+	auto repositoryPtr = newRepository();
+	YulStringRepository& repository = *repositoryPtr;
+	BOOST_CHECK(repository.contains(""));
+	BOOST_CHECK(!repository.contains("abc"));
+	BOOST_CHECK(!repository.contains("abc"));
+	YulStringRepository::Handle a = repository.stringToHandle("abc");
+	BOOST_CHECK_EQUAL(a.id, 1);
+	BOOST_CHECK(repository.contains("abc"));
+	BOOST_CHECK(!repository.contains("abcd"));
+}
+
+BOOST_AUTO_TEST_CASE(hash_is_fixed)
+{
+	// The hash determines the order of YulStrings and thus has to be the same on all platforms.
+	BOOST_CHECK_EQUAL(YulStringRepository::hash(""), YulStringRepository::emptyHash());
+	// Only a tail, exactly one block, one block and a tail, two blocks, three blocks and a tail.
+	BOOST_CHECK_EQUAL(YulStringRepository::hash("abc"), 187767800118597052u);
+	BOOST_CHECK_EQUAL(YulStringRepository::hash("abcdefgh"), 1915112717930452985u);
+	BOOST_CHECK_EQUAL(YulStringRepository::hash("abcdefgh1"), 8685935165090640149u);
+	BOOST_CHECK_EQUAL(YulStringRepository::hash("calldataload_123"), 2314635141879226783u);
+	BOOST_CHECK_EQUAL(YulStringRepository::hash("abi_decode_tuple_t_uint256"), 11055533164651818574u);
+}
+
+BOOST_AUTO_TEST_CASE(strings_survive_growth)
+{
+	auto repositoryPtr = newRepository();
+	YulStringRepository& repository = *repositoryPtr;
+	YulStringRepository::Handle first = repository.stringToHandle("first");
+	string const& firstString = repository.idToString(first.id);
+	for (size_t i = 0; i < 20000; ++i)
+		repository.stringToHandle("x_" + to_string(i));
+	BOOST_CHECK_EQUAL(&repository.idToString(first.id), &firstString);
+	BOOST_CHECK_EQUAL(firstString, "first");
+	BOOST_CHECK_EQUAL(repository.idToString(repository.stringToHandle("x_12345").id), "x_12345");
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_interning)
+{
+	auto repositoryPtr = newRepository();
+	YulStringRepository& repository = *repositoryPtr;
+	size_t const threads = 8;
+	size_t const strings = 4096;
+	vector<vector<size_t>> ids(threads, vector<size_t>(strings));
+	parallelFor(threads, threads, [&](size_t _thread)
+	{
+		// Every thread interns the same strings in a different order.
+		for (size_t i = 0; i < strings; ++i)
+		{
+			size_t n = (i * (2 * _thread + 1)) % strings;
+			ids[_thread][n] = repository.stringToHandle("s" + to_string(n)).id;
+		}
+	});
+	for (size_t n = 0; n < strings; ++n)
+	{
+		for (size_t thread = 1; thread < threads; ++thread)
+			BOOST_REQUIRE_EQUAL(ids[thread][n], ids[0][n]);
+		BOOST_REQUIRE_EQUAL(repository.idToString(ids[0][n]), "s" + to_string(n));
+	}
+	BOOST_CHECK_EQUAL(repository.stringToHandle("s" + to_string(strings)).id, strings + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,443 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Micro-benchmarks of performance critical routines.
+ */
+
+#include <libdevcore/Ethash.h>
+#include <libdevcore/Keccak256.h>
+#include <libdevcore/ThreadPool.h>
+#include <libevmasm/CommonSubexpressionEliminator.h>
+#include <libevmasm/Exceptions.h>
+#include <libyul/AsmAnalysis.h>
+#include <libyul/AsmAnalysisInfo.h>
+#include <libyul/AsmData.h>
+#include <libyul/AsmParser.h>
+#include <libyul/optimiser/ASTCopier.h>
+#include <libyul/optimiser/Disambiguator.h>
+#include <liblangutil/ErrorReporter.h>
+#include <liblangutil/Scanner.h>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// Whether operator new counts allocations and serves them from the bump region. Only the yul-ast
+/// benchmark switches it on, so the threads of the other benchmarks do not share the hook's state.
+atomic<bool> g_allocationHook{false};
+/// Number of allocations made by operator new while the hook was on.
+atomic<size_t> g_allocations{0};
+
+/// Bump allocator, which serves allocations from a single region and frees them all at once
+/// when it is rewound. Used to estimate how much an arena for AST nodes could save.
+struct BumpRegion
+{
+	static size_t const c_size = size_t(1) << 29;
+	char* begin = nullptr;
+	char* next = nullptr;
+	bool active = false;
+
+	bool contains(void const* _pointer) const
+	{
+		return begin && _pointer >= begin && _pointer < begin + c_size;
+	}
+	void* allocate(size_t _size)
+	{
+		if (!begin)
+			next = begin = static_cast<char*>(malloc(c_size));
+		size_t const aligned = (_size + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+		if (!begin || size_t(begin + c_size - next) < aligned)
+			return nullptr;
+		void* result = next;
+		next += aligned;
+		return result;
+	}
+	void rewind() { next = begin; }
+} g_bumpRegion;
+
+}
+
+void* operator new(size_t _size)
+{
+	if (g_allocationHook)
+	{
+		++g_allocations;
+		if (g_bumpRegion.active)
+			if (void* result = g_bumpRegion.allocate(_size))
+				return result;
+	}
+	if (void* result = malloc(_size ? _size : 1))
+		return result;
+	throw bad_alloc();
+}
+
+void operator delete(void* _pointer) noexcept
+{
+	if (!g_bumpRegion.contains(_pointer))
+		free(_pointer);
+}
+
+void operator delete(void* _pointer, size_t) noexcept
+{
+	operator delete(_pointer);
+}
+
+namespace
+{
+
+/// @returns the seconds it takes to run @a _function.
+template <class Function>
+double measure(Function const& _function)
+{
+	auto start = chrono::steady_clock::now();
+	_function();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void report(string const& _name, size_t _count, string const& _unit, double _seconds)
+{
+	cout << left << setw(32) << _name << right << setw(14) << fixed << setprecision(1) << (_count / _seconds)
+		<< " " << _unit << "/s" << endl;
+}
+
+/// Verifies the proof of work of @a _headers headers of the first epoch, one at a time and in batches.
+bool benchmarkEthash(size_t _headers, size_t _threads, string const& _datasetPath)
+{
+	ethash::Verifier verifier;
+	if (!_datasetPath.empty())
+		verifier.useFullDatasets(_datasetPath, _threads);
+	cout << "Preparing the " << (_datasetPath.empty() ? "light cache" : "full dataset") << " of epoch 0..." << endl;
+	double preparation = measure([&]() {
+		if (_datasetPath.empty())
+			verifier.lightCache(0);
+		else
+			verifier.dataset(0);
+	});
+	cout << "Prepared in " << setprecision(2) << preparation << " s." << endl;
+
+	// All headers have a valid proof of work, which is computed by the single verifications.
+	vector<ethash::ProofOfWork> proofs(_headers);
+	for (size_t i = 0; i < _headers; ++i)
+	{
+		proofs[i].blockNumber = i % ethash::c_epochLength;
+		proofs[i].headerHash = keccak256(to_string(i));
+		proofs[i].nonce = i;
+		proofs[i].difficulty = 1;
+	}
+	double single = measure([&]() {
+		for (ethash::ProofOfWork& proof: proofs)
+		{
+			ethash::Result result = _datasetPath.empty() ?
+				verifier.lightCache(0)->hashimoto(proof.headerHash, uint64_t(proof.nonce)) :
+				verifier.dataset(0)->hashimoto(proof.headerHash, uint64_t(proof.nonce));
+			proof.mixHash = result.mixHash;
+		}
+	});
+	report("single", _headers, "headers", single);
+
+	vector<size_t> threadCounts{1};
+	if (_threads > 1)
+		threadCounts.push_back(_threads);
+	for (size_t threads: threadCounts)
+	{
+		vector<bool> valid;
+		double batched = measure([&]() { valid = verifier.verify(proofs, threads); });
+		report("batched (" + to_string(threads) + " threads)", _headers, "headers", batched);
+		if (find(valid.begin(), valid.end(), false) != valid.end())
+		{
+			cerr << "Batched verification rejected a valid proof of work." << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Hashes @a _count inputs of 32 bytes with Keccak-256 and of 64 bytes with Keccak-512, one at a time and in a batch.
+bool benchmarkKeccak(size_t _count)
+{
+	vector<bytes> data;
+	for (size_t i = 0; i < _count; ++i)
+		data.push_back(keccak256(to_string(i)).asBytes());
+	vector<bytesConstRef> inputs;
+	for (bytes const& input: data)
+		inputs.push_back(bytesConstRef(&input));
+
+	vector<h256> hashes(_count);
+	double single = measure([&]() {
+		for (size_t i = 0; i < _count; ++i)
+			hashes[i] = keccak256(inputs[i]);
+	});
+	report("single", _count, "hashes", single);
+
+	vector<h256> batchHashes;
+	double batched = measure([&]() { batchHashes = keccak256(inputs); });
+	report("batched", _count, "hashes", batched);
+	if (batchHashes != hashes)
+	{
+		cerr << "Batched hashes differ from single hashes." << endl;
+		return false;
+	}
+
+	// Keccak-512 of 64 byte inputs, as used by Ethash.
+	vector<h512> data512(_count);
+	vector<bytesConstRef> inputs512;
+	for (size_t i = 0; i < _count; ++i)
+	{
+		data512[i] = keccak512(inputs[i]);
+		inputs512.push_back(bytesConstRef(data512[i].data(), h512::size));
+	}
+	vector<h512> hashes512(_count);
+	single = measure([&]() {
+		for (size_t i = 0; i < _count; ++i)
+			hashes512[i] = keccak512(inputs512[i]);
+	});
+	report("single keccak512", _count, "hashes", single);
+	vector<h512> batchHashes512;
+	batched = measure([&]() { batchHashes512 = keccak512(inputs512); });
+	report("batched keccak512", _count, "hashes", batched);
+	if (batchHashes512 != hashes512)
+	{
+		cerr << "Batched Keccak-512 hashes differ from single hashes." << endl;
+		return false;
+	}
+	return true;
+}
+
+/// @returns a Yul source with @a _count functions, each of which contains arithmetic, memory and
+/// calldata accesses and conditionals, in the style of code generated from Solidity.
+string yulSource(size_t _count)
+{
+	string source = "{\n";
+	for (size_t i = 0; i < _count; ++i)
+	{
+		source += "  function f" + to_string(i) + "(a, b) -> r {\n    let x := a\n";
+		for (size_t j = 0; j < 12; ++j)
+		{
+			string const k = to_string(j);
+			source += "    x := add(mul(x, " + to_string(j + 1) + "), calldataload(add(b, " + k + ")))\n";
+			source += "    if lt(x, " + k + ") { x := sub(x, mload(add(a, " + k + "))) }\n";
+		}
+		source += "    r := x\n  }\n";
+	}
+	source += "  sstore(0, f0(calldataload(0), 1))\n}\n";
+	return source;
+}
+
+/// Copies, destroys and disambiguates a Yul AST of @a _count functions @a _repetitions times.
+/// With @a _bumpAllocation, the copies are allocated by a bump allocator instead of malloc.
+bool benchmarkYulAST(size_t _count, size_t _repetitions, bool _bumpAllocation)
+{
+	using namespace yul;
+	langutil::ErrorList errors;
+	langutil::ErrorReporter errorReporter(errors);
+	auto scanner = make_shared<langutil::Scanner>(langutil::CharStream(yulSource(_count), "benchmark"));
+	shared_ptr<Block> ast = Parser(errorReporter, AsmFlavour::Strict).parse(scanner, false);
+	AsmAnalysisInfo analysisInfo;
+	if (!ast || !AsmAnalyzer(analysisInfo, errorReporter, solidity::EVMVersion(), boost::none, AsmFlavour::Strict).analyze(*ast))
+	{
+		cerr << "Invalid Yul source." << endl;
+		return false;
+	}
+
+	g_allocationHook = true;
+	size_t allocations = g_allocations;
+	boost::get<Block>(ASTCopier{}(*ast));
+	cout << "One copy needs " << (g_allocations - allocations) << " allocations." << endl;
+
+	g_bumpRegion.active = _bumpAllocation;
+	double copy = 0;
+	double destroy = 0;
+	for (size_t repetition = 0; repetition < _repetitions; ++repetition)
+	{
+		unique_ptr<Block> copied;
+		copy += measure([&]() { copied.reset(new Block(std::move(boost::get<Block>(ASTCopier{}(*ast))))); });
+		destroy += measure([&]() { copied.reset(); });
+		g_bumpRegion.rewind();
+	}
+	g_bumpRegion.active = false;
+	g_allocationHook = false;
+	report(_bumpAllocation ? "copy (bump allocation)" : "copy", _repetitions, "ASTs", copy);
+	report(_bumpAllocation ? "destroy (bump allocation)" : "destroy", _repetitions, "ASTs", destroy);
+
+	double disambiguate = measure([&]() {
+		for (size_t repetition = 0; repetition < _repetitions; ++repetition)
+			boost::get<Block>(Disambiguator(analysisInfo)(*ast));
+	});
+	report("disambiguate", _repetitions, "ASTs", disambiguate);
+	return true;
+}
+
+/// @returns @a _count basic blocks in the style of the common subexpression eliminator tests:
+/// arithmetic on constants and stack elements interleaved with storage and memory accesses.
+vector<AssemblyItems> cseBlocks(size_t _count)
+{
+	vector<Instruction> const binary{
+		Instruction::ADD, Instruction::MUL, Instruction::SUB, Instruction::AND,
+		Instruction::OR, Instruction::LT, Instruction::EQ, Instruction::MSTORE, Instruction::SSTORE
+	};
+	vector<Instruction> const unary{
+		Instruction::ISZERO, Instruction::NOT, Instruction::SLOAD, Instruction::MLOAD, Instruction::CALLDATALOAD
+	};
+	// Linear congruential generator, so that all runs measure the same blocks.
+	uint64_t state = 1;
+	auto next = [&](size_t _bound) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return size_t(state >> 33) % _bound;
+	};
+	vector<AssemblyItems> blocks(_count);
+	for (AssemblyItems& block: blocks)
+	{
+		int height = 0;
+		for (size_t i = 0; i < 64; ++i)
+		{
+			size_t choice = next(10);
+			if (height < 2 || choice < 3)
+			{
+				block.emplace_back(u256(next(4) == 0 ? next(1 << 16) : next(8) * 32));
+				height++;
+			}
+			else if (height > 8 || choice < 6)
+			{
+				Instruction instruction = binary[next(binary.size())];
+				block.emplace_back(instruction);
+				height += instructionInfo(instruction).ret - 2;
+			}
+			else if (choice < 7)
+				block.emplace_back(unary[next(unary.size())]);
+			else if (choice < 8)
+				block.emplace_back(Instruction::KECCAK256), height--;
+			else if (choice < 9)
+				block.emplace_back(dupInstruction(1 + next(min(height, 4)))), height++;
+			else
+				block.emplace_back(swapInstruction(1 + next(min(height - 1, 4))));
+		}
+	}
+	return blocks;
+}
+
+/// Runs the common subexpression eliminator on @a _count basic blocks @a _repetitions times.
+bool benchmarkCSE(size_t _count, size_t _repetitions)
+{
+	vector<AssemblyItems> blocks = cseBlocks(_count);
+	size_t items = 0;
+	for (AssemblyItems const& block: blocks)
+		items += block.size();
+
+	vector<AssemblyItems> optimised(_count);
+	double seconds = measure([&]() {
+		for (size_t repetition = 0; repetition < _repetitions; ++repetition)
+			for (size_t i = 0; i < _count; ++i)
+			{
+				CommonSubexpressionEliminator eliminator{KnownState()};
+				auto end = eliminator.feedItems(blocks[i].begin(), blocks[i].end(), false);
+				if (end != blocks[i].end())
+				{
+					cerr << "Block " << i << " was split by the optimiser." << endl;
+					return;
+				}
+				try
+				{
+					optimised[i] = eliminator.getOptimizedItems();
+				}
+				catch (StackTooDeepException const&)
+				{
+					optimised[i] = blocks[i];
+				}
+			}
+	});
+	report("cse", items * _repetitions, "items", seconds);
+	size_t optimisedItems = 0;
+	for (AssemblyItems const& block: optimised)
+		optimisedItems += block.size();
+	cout << "Optimised " << items << " items to " << optimisedItems << " items." << endl;
+	return optimisedItems > 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	po::options_description options(
+		R"(solbench, micro-benchmarks of performance critical routines.
+Usage: solbench [Options] <benchmark>
+Available benchmarks: cse, ethash, keccak, yul-ast
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("benchmark", po::value<string>(), "benchmark to run")
+		("count", po::value<size_t>()->default_value(1000), "number of operations measured")
+		("repetitions", po::value<size_t>()->default_value(10), "number of repetitions of the cse and yul-ast benchmarks")
+		("bump-allocation", "allocate the ASTs of the yul-ast benchmark from a bump allocator")
+		("threads", po::value<size_t>()->default_value(ThreadPool::hardwareConcurrency()), "number of threads")
+		("ethash-dag-dir", po::value<string>()->default_value(""), "directory of the full Ethash datasets, light caches are used if empty")
+		("help", "Show this help screen.");
+
+	po::positional_options_description positions;
+	positions.add("benchmark", 1);
+
+	po::variables_map arguments;
+	try
+	{
+		po::command_line_parser cmdLineParser(argc, argv);
+		cmdLineParser.options(options).positional(positions);
+		po::store(cmdLineParser.run(), arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+
+	if (arguments.count("help") || !arguments.count("benchmark"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	string const benchmark = arguments["benchmark"].as<string>();
+	size_t const count = arguments["count"].as<size_t>();
+	size_t const threads = max<size_t>(arguments["threads"].as<size_t>(), 1);
+	if (benchmark == "ethash")
+		return benchmarkEthash(count, threads, arguments["ethash-dag-dir"].as<string>()) ? 0 : 1;
+	else if (benchmark == "cse")
+		return benchmarkCSE(count, arguments["repetitions"].as<size_t>()) ? 0 : 1;
+	else if (benchmark == "keccak")
+		return benchmarkKeccak(count) ? 0 : 1;
+	else if (benchmark == "yul-ast")
+		return benchmarkYulAST(count, arguments["repetitions"].as<size_t>(), arguments.count("bump-allocation")) ? 0 : 1;
+
+	cerr << "Unknown benchmark: " << benchmark << endl;
+	return 1;
+}